@@ -67,11 +67,12 @@ protected:
     TFButtonWidget btnAuto;
  //   bool    bAutoAc = false;        // do we pick the a/c to show automatically?
     
-    // data output fields
-    TFWidget valSquawk;
-    TFWidget valPos, valBearing, valDist, valPhase;
-    TFWidget valGear, valFlaps, valLights;
-    TFWidget valHeading, valPitch, valRoll, valAlt, valAGL, valSpeed, valVSI;
+    // data output fields, updated every second, only calling X-Plane on visible change
+    TFCachedWidget valSquawk, valDisplayedUsing, valSimTime, valLastData, valChannel;
+    TFCachedWidget valPos, valBearing, valDist, valPhase;
+    TFCachedWidget valGear, valFlaps, valLights;
+    TFCachedWidget valHeading, valPitch, valRoll, valAlt, valAGL, valSpeed, valVSI;
+    std::string lastTitle;              ///< window title currently displayed
     
     // check boxes for visibility
     TFButtonWidget btnCamera, btnVisible, btnAutoVisible;
@@ -69,6 +69,29 @@ constexpr double FT_per_HPA     = (100/PA_per_M)/M_per_FT;
 constexpr unsigned MAX_TRANSP_ICAO = 0xFFFFFF;  // max transponder ICAO code (24bit)
 constexpr double FLIGHT_LOOP_INTVL  = -5.0;     // call ourselves every 5 frames
 constexpr double AC_MAINT_INTVL     = 2.0;      // seconds (calling a/c maintenance periodically)
+constexpr double AC_MAINT_WHEEL_RES = 1.0;      // [s] resolution of the timing wheel scheduling a/c maintenance
+constexpr int AC_TASK_NUM           = 5;        ///< number of periodic per-aircraft tasks, see AcTaskTy
+constexpr int AC_TASK_PERIOD_MAX    = 1000;     ///< [cycles] max configurable period of a per-aircraft task
+constexpr size_t AI_SLOTS_MAX       = 19;       ///< number of multiplayer/TCAS slots X-Plane offers
+constexpr int AI_PRIO_SLOT          = 0;        ///< aiPrio of aircraft holding a multiplayer/TCAS slot
+constexpr int AI_PRIO_NO_SLOT       = 10;       ///< aiPrio of aircraft without slot
+constexpr double AI_SLOT_HYSTERESIS = 0.2;      ///< challenger's slot cost must be this much lower (relative) than the worst slot holder's
+constexpr double AI_SLOT_ALT_WEIGHT = 5.0;      ///< vertical separation counts this many times more than horizontal
+constexpr double AI_SLOT_CLOSURE_TIME = 60.0;   ///< [s] look-ahead for closure rate: approaching aircraft count as that much closer
+constexpr double AI_SLOT_BEHIND_FACTOR = 2.0;   ///< slot cost factor for aircraft right behind the user (ahead: 1.0)
+constexpr double AI_SLOT_GND_FACTOR = 4.0;      ///< slot cost factor for aircraft on the ground while user is flying
+constexpr double CH_TS_GAIN         = 0.1;      ///< gain of the network time offset filter once warmed up
+constexpr double CH_TS_DRIFT_BASELINE = 1800.0; ///< [s] min time span of a session's offset samples before drift is estimated from them
+constexpr int    CH_TS_DRIFT_MIN_CNT = 30;      ///< min number of offset samples before drift is estimated from them
+constexpr double CH_TS_DRIFT_MAX    = 1e-4;     ///< [s/s] max plausible drift between network and system clock
+constexpr double CH_TS_DEV_INIT     = 1.0;      ///< [s] initial expected deviation of network time offset samples
+constexpr double CH_TS_DEV_MIN      = 0.05;     ///< [s] lower bound for expected deviation of offset samples
+constexpr double CH_TS_CLIP         = 3.0;      ///< offset samples are clipped at this many times the expected deviation
+constexpr int    CH_TS_REACQUIRE    = 3;        ///< this many outliers in a row restart the offset estimate
+constexpr double CH_TS_SLEW_RATE    = 0.05;     ///< [s/s] max rate of changing the applied offset while aircraft are displayed
+constexpr double CH_TS_PERSIST_MAX_AGE = 7 * 86400.0;  ///< [s] persisted offset estimates older than this are dropped
+constexpr double MEM_CHECK_INTVL    = 10.0;     // seconds (checking memory usage against budget periodically)
+constexpr size_t MEM_MAP_NODE_OVERHEAD = 4 * sizeof(void*);  // [bytes] estimated overhead per node of a std::map or std::list
 constexpr double TIME_REQU_POS      = 0.5;      // seconds before reaching current 'to' position we request calculation of next position
 constexpr double SIMILAR_TS_INTVL = 3;          // seconds: Less than that difference and position-timestamps are considered "similar" -> positions are merged rather than added additionally
 constexpr double SIMILAR_POS_DIST = 3;          // [m] if distance between positions less than this then favor heading from flight data over vector between positions
@@ -79,6 +102,10 @@ constexpr double AC_HIDE_LAT        = -70.645077;       // Neumayer-Station III
 constexpr double AC_HIDE_LON        =  -8.264134;
 constexpr double AC_HIDE_ALT        = 50;
 constexpr double MAX_HOVER_AGL      = 2000;     // [ft] max hovering altitude for hover-along-the-runway detection
+constexpr int FD_MAX_TILE_GRID      = 5;        ///< max number of tiles per side when splitting the query area of online channels
+constexpr int FD_MAX_REGIONAL_DIST  = 300;      ///< [nm] max regional distance, in which aircraft are tracked lightweight
+constexpr double FD_REGIONAL_DEMOTE_MARGIN = 0.10; ///< fully tracked aircraft are demoted to regional only beyond standard distance plus this share of it
+constexpr int FD_TILE_WAIT_MS       = 1000;     ///< [ms] max time to wait for network activity while fetching tiles
 
 //MARK: Flight Model
 constexpr double MDL_ALT_MIN =         -1500;   // [ft] minimum allowed altitude
@@ -110,12 +137,17 @@ constexpr int COLOR_BLUE        = 0x00F0F0;     // light blue
 
 //MARK: Airports, Runways, Taxiways
 constexpr double ART_EDGE_ANGLE_TOLERANCE=30.0; ///< [] tolerance of searched heading to edge's angle to be considered a fit
+constexpr double ART_EDGE_SEED_DIST = 5.0;      ///< [m] an edge next to the previous position's edge this close is taken without searching all edges
 constexpr double ART_RWY_TD_POINT_F = 0.10;     ///< [-] Touch-down point is this much into actual runway (so we don't touch down at its actual beginning)
 constexpr double ART_RWY_MAX_HEAD_DIFF = 10.0;  ///< [] maximum heading difference between flight and runway
 constexpr double ART_RWY_MAX_VSI_F = 2.0;       ///< [-] descend rate: maximum allowed factor applied to VSI_FINAL
 constexpr double ART_RWY_ALIGN_DIST = 500.0;    ///< [m] distance before touch down to be fully aligned with rwy
 constexpr double ART_APPR_SPEED_F = 0.8;        ///< [-] ratio of FLAPS_DOWN_SPEED to use as max approach speed
 constexpr double ART_FINAL_SPEED_F = 0.7;       ///< [-] ratio of FLAPS_DOWN_SPEED to use as max final speed
+constexpr size_t ART_MATCH_MAX_CAND = 4;        ///< [-] map matching: max number of candidate edges kept per position
+constexpr double ART_MATCH_ADJ_COST = 0.5;      ///< [-] map matching: cost of moving on to an adjacent edge
+constexpr double ART_MATCH_JUMP_COST = 4.0;     ///< [-] map matching: cost of moving to an edge not connected to the previous one
+constexpr double ART_MATCH_MIN_TS_GAP = 1.0;    ///< [s] map matching: min time to neighbouring positions when inserting a position at a taxi node
 
 //MARK: Version Information
 extern char LT_VERSION[];               // like "1.0"
@@ -158,6 +190,14 @@ constexpr int LT_NEW_VER_CHECK_TIME = 48;   // [h] between two checks of a new
 #define INFO_AC_HIDDEN_AUTO     "A/c %s automatically hidden"
 #define INFO_AC_SHOWN           "A/c %s visible"
 #define INFO_AC_SHOWN_AUTO      "A/c %s automatically visible"
+#define INFO_LATENCY            "Latency %s: receipt to display %s; timestamp to display %s"
+#define INFO_LATENCY_SUMMARY    "n=%u avg=%.1fs p50=%.1fs p95=%.1fs max=%.1fs"
+#define INFO_LATENCY_ALL        "all channels"
+#define INFO_MEM_EVICTED        "Memory budget of %d MB exceeded: removed %d aircraft not displayed, usage down from %.1f MB to %.1f MB"
+#define INFO_CFG_CHG_REMOVED    "Settings changed: removed %d aircraft no longer matching"
+#define INFO_CLOCK_VIRTUAL      "Clock switched to virtual time, starting at %s"
+#define INFO_CLOCK_REAL         "Clock switched back to real time"
+#define WARN_MEM_OVER_BUDGET    "Memory budget of %d MB exceeded by displayed aircraft and other data: %.1f MB used"
 #define MSG_TOO_MANY_AC         "Reached limit of %d aircraft, will create new ones only after removing outdated ones."
 #define MSG_CSL_PACKAGE_LOADED  "Successfully loaded CSL package %s"
 #define MSG_MDL_FORCED          "Settings > Debug: Model matching forced to '%s'/'%s'/'%s'"
@@ -173,6 +213,12 @@ constexpr int LT_NEW_VER_CHECK_TIME = 48;   // [h] between two checks of a new
 #define CFG_DEFAULT_AC_TYP_INFO "Default a/c type is '%s'"
 #define CFG_DEFAULT_CAR_TYP_INFO "Default car type is '%s'"
 #define CFG_ADSBEX_API_KEY      "ADSBEX_API_KEY"
+#define CFG_SBS_HOST            "SBS_HOST"
+#define CFG_BEAST_HOST          "BEAST_HOST"
+#define SBS_DEFAULT_HOST        "localhost"
+#define CFG_MC_GROUP            "MC_GROUP"
+#define CFG_TS_SKEW             "TS_SKEW:"  ///< prefix of persisted network time offset per channel, followed by channel's dataRef
+#define MC_DEFAULT_GROUP        "239.255.76.84"     ///< administratively scoped multicast group, 'L' 'T'
 #define XPPRF_RENOPT_HDR        "renopt_HDR"					// XP10
 #define XPPRF_EFFECTS_04		"renopt_effects_04"				// XP11, if >= 3 then includes HDR
 #define XPPRF_RENOPT_HDR_ANTIAL "renopt_HDR_antial"
@@ -224,6 +270,8 @@ constexpr int LT_NEW_VER_CHECK_TIME = 48;   // [h] between two checks of a new
 #define PATH_RESOURCES_SCSL     "Resources/ShippedCSL"
 // these are under X-Plane's root dir
 #define PATH_DEBUG_RAW_FD       "LTRawFD.log"   // this is under X-Plane's system dir
+#define PATH_DEBUG_TRAJECTORY   "LTTrajectory.log"          // this is under X-Plane's system dir
+#define PATH_DEBUG_TRJ_GOLDEN   "LTTrajectory.golden.log"   // this is under X-Plane's system dir
 #define PATH_RES_PLUGINS        "Resources/plugins"
 #define PATH_CONFIG_FILE        "Output/preferences/LiveTraffic.prf"
 
@@ -249,6 +297,7 @@ constexpr int SERR_LEN = 100;                   // size of buffer for IO error t
 #define ERR_CURL_PERFORM        "%s: Could not get network data: %d - %s"
 #define ERR_CURL_NOVERCHECK     "Could not browse X-Plane.org for version info: %d - %s"
 #define ERR_CURL_HTTP_RESP      "%s: HTTP response is not OK but %ld for %s"
+#define ERR_CURL_MULTI_INIT     "%s: Could not initialize multi CURL for fetching tiles"
 #define ERR_CURL_REVOKE_MSG     {"revocation","80092012","80092013"}  // appear in error text if querying revocation list fails
 #define ERR_CURL_DISABLE_REV_QU "%s: Querying revocation list failed - have set CURLSSLOPT_NO_REVOKE and am trying again"
 #define ERR_HTTP_NOT_OK         "HTTP response was not HTTP_OK"
@@ -323,6 +372,9 @@ constexpr int ERR_CFG_FILE_MAXWARN = 5;     // maximum number of warnings while
 #define DBG_RAW_FD_START        "DEBUG Starting to log raw flight data to %s"
 #define DBG_RAW_FD_STOP         "DEBUG Stopped logging raw flight data to %s"
 #define DBG_RAW_FD_ERR_OPEN_OUT "DEBUG Could not open output file %s: %s"
+#define DBG_TRJ_START           "DEBUG Starting to log trajectories to %s, %lu golden positions of %lu aircraft read from %s"
+#define DBG_TRJ_STOP            "DEBUG Stopped logging trajectories: %lu positions of %lu aircraft over %.1fs sim time; wall-clock %.2fs, thereof %.3fs calculating positions"
+#define DBG_TRJ_GOLDEN          "DEBUG Golden comparison: %lu positions compared, %lu outside tolerance, %lu not covered; max deviation %.2fm horizontal, %.2fm vertical, %.2fdeg attitude"
 #define DBG_FILTER_AC           "DEBUG Filtering for a/c '%s'"
 #define DBG_FILTER_AC_REMOVED   "DEBUG Filtering for a/c REMOVED"
 #define DBG_MERGED_POS          "DEBUG MERGED POS %s into updated TS %.1f"
@@ -338,6 +390,10 @@ constexpr int ERR_CFG_FILE_MAXWARN = 5;     // maximum number of warnings while
 #define DBG_AC_SWITCH_POS       "DEBUG A/C SWITCH POS: %s"
 #define DBG_AC_FLIGHT_PHASE     "DEBUG A/C FLIGHT PHASE CHANGED from %i %s to %i %s"
 #define DBG_AC_CHANNEL_SWITCH   "DEBUG %s: SWITCHED CHANNEL from '%s' to '%s'"
+#define DBG_COMMIT_UPDATES      "DEBUG %s: Committed %lu updates, held mapFd lock for %.2fms"
+#define DBG_CPA_DISPLACED       "DEBUG %s: Removed a/c to make room for predicted threat %s"
+#define DBG_REGIONAL_PROMOTE    "DEBUG %s: Promoted from regional to full tracking"
+#define DBG_REGIONAL_DEMOTE     "DEBUG %s: Demoted from full tracking to regional"
 #ifdef DEBUG
 #define DBG_DEBUG_BUILD         "DEBUG BUILD with additional run-time checks and no optimizations"
 #endif
@@ -200,6 +200,13 @@ struct positionTy {
     // start of some special flight phase like rotate, take off, touch down?
     // (can't use LTAircraft::FlightPhase due to cyclic header inclusion)
     int flightPhase = 0;
+    
+    /// when received from the network (same time base as ts), `NAN` if not received, e.g. historic data
+    double rcvTs = NAN;
+    /// channel which received the position (a `dataRefsLT` value, but can't use that due to cyclic header inclusion)
+    int rcvCh = 0;
+    /// [m] terrain altitude below the position as probed by ground status classification, `NAN` if not yet known
+    double terrainAlt = NAN;
 public:
     positionTy () : v{NAN,NAN,NAN,NAN,NAN,NAN,NAN}, mergeCount(1),
                     onGrnd(GND_UNKNOWN), unitCoord(UNIT_WORLD), unitAngle(UNIT_DEG) {}
@@ -228,10 +228,40 @@ enum dataRefsLT {
     
     DR_AC_BULK_QUICK,               // bulk a/c primarily for communication with LTAPI
     DR_AC_BULK_EXPENSIVE,           // similar, but for expensive data, should be called less often
+    DR_AC_BULK_REGIONAL,            ///< bulk data of aircraft only tracked in the outer regional ring
+    DR_AC_REGIONAL_NUM,             ///< number of aircraft only tracked in the outer regional ring
     
     DR_SIM_DATE,
     DR_SIM_TIME,
     
+    DR_STATS_LAT_RCV_DISP_AVG,      ///< latency from network receipt to display, average
+    DR_STATS_LAT_RCV_DISP_P95,      ///< latency from network receipt to display, 95th percentile
+    DR_STATS_LAT_DISP_DELAY_AVG,    ///< delay from position's timestamp to display, average
+    DR_STATS_LAT_DISP_DELAY_P95,    ///< delay from position's timestamp to display, 95th percentile
+    DR_STATS_COMMIT_CNT,            ///< number of updates in all channels' last commit
+    DR_STATS_COMMIT_LOCK_MS,        ///< [ms] longest time `mapFdMutex` was held during a channel's last commit
+    DR_STATS_MEM_FLIGHT_DATA,       ///< [KB] memory used by flight data
+    DR_STATS_MEM_POS_BUF,           ///< [KB] memory used by position buffers
+    DR_STATS_MEM_AIRPORTS,          ///< [KB] memory used by airport data
+    DR_STATS_MEM_MASTER_DATA,       ///< [KB] memory used by master data requests
+    DR_STATS_MEM_RAW_BUF,           ///< [KB] memory used by raw network/file buffers
+    DR_STATS_MEM_TOTAL,             ///< [KB] total of the above
+    
+    // closest point of approach: top threats to user's plane
+    DR_CPA_NUM_THREATS,             ///< number of aircraft predicted to come close to the user's plane
+    DR_CPA_THREAT1_KEY,            ///< threat 1: numeric aircraft key
+    DR_CPA_THREAT1_TIME,           ///< threat 1: [s] time until closest approach
+    DR_CPA_THREAT1_DIST,           ///< threat 1: [m] horizontal distance at closest approach
+    DR_CPA_THREAT1_VSEP,           ///< threat 1: [m] vertical separation at closest approach
+    DR_CPA_THREAT2_KEY,            ///< threat 2: numeric aircraft key
+    DR_CPA_THREAT2_TIME,           ///< threat 2: [s] time until closest approach
+    DR_CPA_THREAT2_DIST,           ///< threat 2: [m] horizontal distance at closest approach
+    DR_CPA_THREAT2_VSEP,           ///< threat 2: [m] vertical separation at closest approach
+    DR_CPA_THREAT3_KEY,            ///< threat 3: numeric aircraft key
+    DR_CPA_THREAT3_TIME,           ///< threat 3: [s] time until closest approach
+    DR_CPA_THREAT3_DIST,           ///< threat 3: [m] horizontal distance at closest approach
+    DR_CPA_THREAT3_VSEP,           ///< threat 3: [m] vertical separation at closest approach
+    
     // configuration options
     DR_CFG_AIRCRAFT_DISPLAYED,
     DR_CFG_AUTO_START,
@@ -248,7 +278,10 @@ enum dataRefsLT {
     DR_CFG_MAX_FULL_NUM_AC,
     DR_CFG_FULL_DISTANCE,
     DR_CFG_FD_STD_DISTANCE,
+    DR_CFG_FD_REGIONAL_DISTANCE,    ///< [nm] outer ring of lightweight tracking, not beyond DR_CFG_FD_STD_DISTANCE means off
     DR_CFG_FD_SNAP_TAXI_DIST,
+    DR_CFG_FD_TILE_GRID,
+    DR_CFG_FD_MEM_BUDGET,
     DR_CFG_FD_REFRESH_INTVL,
     DR_CFG_FD_BUF_PERIOD,
     DR_CFG_AC_OUTDATED_INTVL,
@@ -256,6 +289,11 @@ enum dataRefsLT {
     DR_CFG_LND_LIGHTS_TAXI,
     DR_CFG_HIDE_BELOW_AGL,
     DR_CFG_HIDE_TAXIING,
+    DR_CFG_AC_TASK_RADAR,           ///< [cycles] period of refreshing radar data per aircraft
+    DR_CFG_AC_TASK_SURFACES,        ///< [cycles] period of refreshing engine/tire rpm per aircraft
+    DR_CFG_AC_TASK_INFO_TEXTS,      ///< [cycles] period of checking for new info texts per aircraft
+    DR_CFG_AC_TASK_AI_PRIO,         ///< [cycles] period of recalculating AI priority per aircraft
+    DR_CFG_AC_TASK_LABEL,           ///< [cycles] period of recomposing the label per aircraft
     DR_CFG_DR_LIBXPLANEMP,
     DR_CFG_LAST_CHECK_NEW_VER,
     
@@ -264,6 +302,9 @@ enum dataRefsLT {
     DR_DBG_AC_POS,
     DR_DBG_LOG_RAW_FD,
     DR_DBG_MODEL_MATCHING,
+    DR_DBG_LOG_TRAJECTORY,          ///< record rendered trajectories (see LTTrajectory)
+    DR_DBG_VCLOCK,                  ///< run on virtual time (see LTClock)?
+    DR_DBG_VCLOCK_ADVANCE,          ///< [ms] writing advances virtual time
     
     // channel configuration options
     DR_CFG_RT_LISTEN_PORT,
@@ -273,16 +314,23 @@ enum dataRefsLT {
     DR_CFG_FF_SEND_USER_PLANE,
     DR_CFG_FF_SEND_TRAFFIC,
     DR_CFG_FF_SEND_TRAFFIC_INTVL,
+    DR_CFG_SBS_PORT,
+    DR_CFG_BEAST_PORT,
+    DR_CFG_MC_PORT,
 
     // channels, in ascending order of priority
     DR_CHANNEL_FUTUREDATACHN_ONLINE,    // placeholder, first channel
     DR_CHANNEL_FORE_FLIGHT_SENDER,
+    DR_CHANNEL_MC_SENDER,
     DR_CHANNEL_OPEN_GLIDER_NET,
     DR_CHANNEL_ADSB_EXCHANGE_ONLINE,
     DR_CHANNEL_ADSB_EXCHANGE_HISTORIC,
     DR_CHANNEL_OPEN_SKY_ONLINE,
     DR_CHANNEL_OPEN_SKY_AC_MASTERDATA,
-    DR_CHANNEL_REAL_TRAFFIC_ONLINE,     // currently highest-prio channel
+    DR_CHANNEL_REAL_TRAFFIC_ONLINE,
+    DR_CHANNEL_SBS_ONLINE,
+    DR_CHANNEL_BEAST_ONLINE,
+    DR_CHANNEL_MC_RECEIVER,             // currently highest-prio channel
     // always last, number of elements:
     CNT_DATAREFS_LT
 };
@@ -303,6 +351,13 @@ constexpr int DR_CHANNEL_FIRST  = DR_CHANNEL_FUTUREDATACHN_ONLINE;
 constexpr int DR_CHANNEL_LAST   = CNT_DATAREFS_LT-1;
 constexpr int CNT_DR_CHANNELS   = DR_CHANNEL_LAST+1 - DR_CHANNEL_FIRST;
 
+/// Settings changes, which are applied incrementally by LTFlightDataApplyCfgChanges()
+enum CfgChangeTy : unsigned {
+    CFG_CHG_CHANNELS    = 0x01,     ///< a channel got enabled or disabled
+    CFG_CHG_RADIUS      = 0x02,     ///< search radius changed
+    CFG_CHG_AC_FILTER   = 0x04,     ///< debug a/c filter changed
+};
+
 class DataRefs
 {
 public:
@@ -434,6 +489,36 @@ public:
     };
     typedef std::vector<CSLPathCfgTy> vecCSLPaths;
     
+    /// @brief Robust, drift-aware estimate of one channel's network time offset vs. system clock
+    /// @details Samples are clipped at CH_TS_CLIP times the expected deviation
+    ///          so that single late responses don't pull the estimate. The drift
+    ///          of the network clock is estimated by linear regression over the
+    ///          session's samples once they span CH_TS_DRIFT_BASELINE, so that
+    ///          the prediction stays correct over long sessions. Only the offset
+    ///          is persisted, drift is not extrapolated across sessions.
+    struct ChTsSkewTy {
+        double offset   = NAN;              ///< [s] network time minus system time at `tsEst`
+        double drift    = 0.0;              ///< [s/s] change of offset over time
+        double tsEst    = NAN;              ///< [s] system time of last estimate
+        double dev      = CH_TS_DEV_INIT;   ///< [s] expected deviation of samples, a smoothed absolute residual
+        int    cnt      = 0;                ///< number of samples received this session
+        int    nOutliers = 0;               ///< number of consecutive samples, which needed clipping
+        // regression of this session's (clipped) samples over time, relative to `tsFirst`
+        double tsFirst  = NAN;              ///< [s] system time of first sample in regression
+        double sumT = 0.0, sumY = 0.0, sumTT = 0.0, sumTY = 0.0;
+        int    nReg     = 0;                ///< number of samples in regression
+        
+        inline bool IsValid () const { return !std::isnan(offset); }
+        /// predicted offset at system time `sysTs`
+        inline double Predict (double sysTs) const { return offset + drift * (sysTs - tsEst); }
+        /// processes a new sample of an offset, taken at system time `sysTs`
+        void Add (double sample, double sysTs);
+        /// config file representation: `offset;tsEst`
+        std::string GetConfigString () const;
+        /// reads config file representation, returns if successful
+        bool SetConfigString (const std::string& s);
+    };
+    
 public:
     pluginStateTy pluginState = STATE_STOPPED;
 #ifdef DEBUG
@@ -458,13 +543,15 @@ protected:
     int bDebugAcPos             = false;// output debug info on position calc into log file?
     int bDebugLogRawFd          = false;// log raw flight data to LTRawFD.log
     int bDebugModelMatching     = false;// output debug info on model matching in xplanemp?
+    int bDebugLogTrajectory     = false;// record rendered trajectories to LTTrajectory.log
     std::string XPSystemPath;
     std::string LTPluginPath;           // path to plugin directory
     std::string DirSeparator;
     int bUseHistoricData        = false;
     int bChannel[CNT_DR_CHANNELS];      // is channel enabled?
-    double chTsOffset           = 0.0f; // offset of network time compared to system clock
-    int chTsOffsetCnt           = 0;    // how many offset reports contributed to the calculated average offset?
+    double chTsOffset           = 0.0f; // offset of network time compared to system clock, as applied
+    double chTsOffsetTs         = NAN;  // system time when chTsOffset was last updated
+    ChTsSkewTy chTsSkew[CNT_DR_CHANNELS];   // offset estimate per channel
     int iTodaysDayOfYear        = 0;
     time_t tStartThisYear = 0, tStartPrevYear = 0;
     int lastCheckNewVer         = 0;    // when did we last check for updates? (hours since the epoch)
@@ -484,7 +571,10 @@ protected:
     int maxFullNumAc    = 50;           // how many of these to draw in full (as opposed to 'lights only')?
     int fullDistance    = 3;            // nm: Farther away a/c is drawn 'lights only'
     int fdStdDistance   = 15;           // nm: miles to look for a/c around myself
+    int fdRegionalDistance = 0;         ///< [nm] outer ring, in which a/c are tracked lightweight only, off if not beyond fdStdDistance
     int fdSnapTaxiDist  = 25;           ///< [m]: Snapping to taxi routes in a max distance of this many meter (0 -> off)
+    int fdTileGrid      = 1;            ///< split query area of online channels into this many tiles per side (1 -> no tiling)
+    int fdMemBudget     = 256;          ///< [MB] memory budget for flight data and buffers, farthest hidden aircraft are removed beyond (0 -> no limit)
     int fdRefreshIntvl  = 20;           // how often to fetch new flight data
     int fdBufPeriod     = 90;           // seconds to buffer before simulating aircraft
     int acOutdatedIntvl = 50;           // a/c considered outdated if latest flight data more older than this compare to 'now'
@@ -492,6 +582,8 @@ protected:
     int bLndLightsTaxi = false;         // keep landing lights on while taxiing? (to be able to see the a/c as there is no taxi light functionality)
     int hideBelowAGL    = 0;            // if positive: a/c visible only above this height AGL
     int hideTaxiing     = 0;            // hide a/c while taxiing?
+    /// [cycles] periods of per-aircraft tasks, indexed by AcTaskTy: radar, surfaces, info texts, AI prio, label
+    int acTaskPeriod[AC_TASK_NUM] = { 100, 10, 10, 60, 30 };
     int drLibXplaneMP   = 1;            // CSL models: register original 'libxplanemp' dataRefs?
 
     // channel config options
@@ -502,15 +594,22 @@ protected:
     int bffUserPlane    = 1;            // bool Send User plane data?
     int bffTraffic      = 1;            // bool Send traffic data?
     int ffSendTrfcIntvl = 3;            // [s] interval to broadcast traffic info
+    int sbsPort         = 30003;        // TCP port of local receiver providing SBS-1 format
+    int beastPort       = 30005;        // TCP port of local receiver providing Beast binary format
+    int mcPort          = 49010;        // UDP port of the multicast position stream between LiveTraffic instances
 
     vecCSLPaths vCSLPaths;              // list of paths to search for CSL packages
     
     std::string sDefaultAcIcaoType  = CSL_DEFAULT_ICAO_TYPE;
     std::string sDefaultCarIcaoType = CSL_CAR_ICAO_TYPE;
     std::string sADSBExAPIKey;
+    std::string sSBSHost = SBS_DEFAULT_HOST;
+    std::string sBeastHost = SBS_DEFAULT_HOST;
+    std::string sMCGroup = MC_DEFAULT_GROUP;
     
     // live values
     bool bReInitAll     = false;        // shall all a/c be re-initiaized (e.g. time jumped)?
+    unsigned cfgChanges = 0;            // settings changed since last applied (CfgChangeTy)
     
     int cntAc           = 0;            // number of a/c being displayed
     std::string keyAc;                  // key (transpIcao) for a/c whose data is returned
@@ -592,6 +691,17 @@ public:
     // livetraffic/sim/date and .../time
     static void LTSetSimDateTime(void* p, int i);
     static int LTGetSimDateTime(void* p);
+    
+    /// livetraffic/stats/latency/...: latency statistics of all channels
+    static float LTGetLatency(void* p);
+    /// livetraffic/stats/commit/...: statistics of all channels' last commit of updates
+    static float LTGetCommitStat(void* p);
+    /// livetraffic/stats/mem/...: estimated memory usage [KB]
+    static int LTGetMemUsage(void* p);
+    /// livetraffic/cpa/...: number of threats and their keys
+    static int LTGetCpaInt(void* p);
+    /// livetraffic/cpa/...: time, distance, vertical separation of threats
+    static float LTGetCpa(void* p);
 
     // livetraffic/cfg/aircrafts_displayed: Aircraft Displayed
     static void LTSetAircraftDisplayed(void* p, int i);
@@ -637,7 +747,15 @@ public:
     inline int GetFdStdDistance_nm() const { return fdStdDistance; }
     inline int GetFdStdDistance_m() const { return fdStdDistance * M_per_NM; }
     inline int GetFdStdDistance_km() const { return fdStdDistance * M_per_NM / M_per_KM; }
+    inline int GetFdRegionalDistance_nm() const { return fdRegionalDistance; }
+    inline int GetFdRegionalDistance_m() const { return fdRegionalDistance * M_per_NM; }
+    /// [nm] Radius to query data for: the regional distance if beyond the standard distance
+    inline int GetFdQueryDistance_nm() const { return std::max(fdStdDistance, fdRegionalDistance); }
+    /// [m] Radius to query data for: the regional distance if beyond the standard distance
+    inline int GetFdQueryDistance_m() const { return GetFdQueryDistance_nm() * M_per_NM; }
     inline int GetFdSnapTaxiDist_m() const { return fdSnapTaxiDist; }
+    inline int GetFdTileGrid() const { return fdTileGrid; }
+    inline int GetFdMemBudget_MB() const { return fdMemBudget; }
     inline int GetFdRefreshIntvl() const { return fdRefreshIntvl; }
     inline int GetFdBufPeriod() const { return fdBufPeriod; }
     inline int GetAcOutdatedIntvl() const { return acOutdatedIntvl; }
@@ -646,6 +764,8 @@ public:
     inline int GetHideBelowAGL() const { return hideBelowAGL; }
     inline bool GetHideTaxiing() const { return hideTaxiing != 0; }
     inline bool IsAutoHidingActive() const { return hideBelowAGL > 0 || hideTaxiing != 0; }
+    /// Period of a per-aircraft task in drawing cycles, `task` is an AcTaskTy
+    inline int GetAcTaskPeriod(int task) const { return acTaskPeriod[task]; }
 
     inline bool GetDrLibXplaneMP() const { return drLibXplaneMP != 0; }
     inline void SetDrLibXplaneMP(int i) { drLibXplaneMP = i; }
@@ -669,11 +789,21 @@ public:
     
     std::string GetADSBExAPIKey () const { return sADSBExAPIKey; }
     void SetADSBExAPIKey (std::string apiKey) { sADSBExAPIKey = apiKey; }
+    std::string GetSBSHost () const { return sSBSHost; }
+    void SetSBSHost (std::string host) { sSBSHost = host; }
+    std::string GetBeastHost () const { return sBeastHost; }
+    void SetBeastHost (std::string host) { sBeastHost = host; }
+    std::string GetMCGroup () const { return sMCGroup; }
+    void SetMCGroup (std::string group) { sMCGroup = group; }
     
     // timestamp offset network vs. system clock
-    inline void ChTsOffsetReset() { chTsOffset = 0.0f; chTsOffsetCnt = 0; }
+    void ChTsOffsetReset();
     inline double GetChTsOffset () const { return chTsOffset; }
-    void ChTsOffsetAdd (double aNetTS);
+    void ChTsOffsetAdd (dataRefsLT ch, double aNetTS);
+protected:
+    double ChTsOffsetEstimate (double sysTs) const;
+    bool ChTsSkewFromConfig (const std::string& sKey, const std::string& sVal);
+public:
 
     // livetraffic/dbg/ac_filter: Debug a/c filter (the integer is converted to hex as an transpIcao key)
     std::string GetDebugAcFilter() const;
@@ -693,6 +823,15 @@ public:
     // livetraffic/dbg/model_matching: Debug Model Matching (by XPMP API)
     inline bool GetDebugModelMatching() const   { return bDebugModelMatching; }
     
+    // livetraffic/dbg/log_trajectory: Record rendered trajectories
+    inline bool GetDebugLogTrajectory() const   { return bDebugLogTrajectory; }
+    void SetDebugLogTrajectory (bool bLog)      { bDebugLogTrajectory = bLog; }
+    static void LTSetDebugLogTrajectory (void* p, int i);
+    
+    // livetraffic/dbg/vclock/...: Virtual time for reproducible test runs
+    static int LTGetVClock (void* p);
+    static void LTSetVClock (void* p, int i);
+    
     // Number of aircraft
     inline int GetNumAc() const                 { return cntAc; }
     int IncNumAc();
@@ -711,6 +850,10 @@ public:
     inline bool IsReInitAll() const { return bReInitAll; }
     inline void SetReInitAll (bool b) { bReInitAll = b; }
     
+    // Incremental application of settings changes
+    inline void AddCfgChange (CfgChangeTy chg) { cfgChanges |= chg; }
+    inline unsigned FetchCfgChanges () { const unsigned chg = cfgChanges; cfgChanges = 0; return chg; }
+    
 //MARK: Processed values
 public:
     static positionTy GetViewPos();            // view position in World coordinates
@@ -121,6 +121,10 @@ public:
     LTOnlineChannel(),
     LTFlightDataChannel()  {}
     virtual std::string GetURL (const positionTy& pos);
+    // tiling only with the original server, RapidAPI has a fixed radius
+    virtual bool CanTile () const { return keyTy == ADSBEX_KEY_EXCHANGE; }
+    virtual boundingBoxTy GetQueryArea (const positionTy& pos) const;
+    virtual std::string GetTileURL (const boundingBoxTy& tile);
     virtual bool ProcessFetchedData (mapLTFlightDataTy& fdMap);
     virtual bool IsLiveFeed() const { return true; }
     virtual LTChannelType GetChType() const { return CHT_TRACKING_DATA; }
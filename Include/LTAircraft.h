@@ -136,6 +136,87 @@ public:
     inline double getTargetDeltaDist() const    { return targetDeltaDist; }
 };
 
+//
+//MARK: AcTaskSchedTy
+//
+
+/// Periodic per-aircraft tasks, which don't need to run every frame
+enum AcTaskTy {
+    ACT_RADAR = 0,          ///< refresh radar data from flight data
+    ACT_SURFACES,           ///< refresh engine and tire rpm
+    ACT_INFO_TEXTS,         ///< check for and send new info texts
+    ACT_AI_PRIO,            ///< recalculate AI slotting priority
+    ACT_LABEL,              ///< recompose the label
+    ACT_NUM_TASKS           ///< always last: number of tasks
+};
+
+/// @brief Schedules periodic per-aircraft tasks with a phase offset per aircraft
+/// @details If all aircraft refreshed in the same frame (like `cycle % period == 0`)
+///          then all their lock and copy work would add up in that one frame,
+///          causing periodic stutter. Instead, each aircraft starts its tasks
+///          with a phase derived from a hash of its key, which spreads the work
+///          evenly across the frames of a period.
+///          Periods are configured in drawing cycles, see DataRefs::GetAcTaskPeriod().
+class AcTaskSchedTy
+{
+protected:
+    unsigned phase = 0;                     ///< hashed phase offset of this aircraft
+    int nextCycle[ACT_NUM_TASKS];           ///< cycle when a task is due next, -1 if not yet initialized
+public:
+    /// Constructor derives the phase from the aircraft's key
+    AcTaskSchedTy (const std::string& key);
+    /// @brief Is the task due in the given cycle? If so, the next run is scheduled
+    /// @details Skipped cycles don't shift the phase: the next run is aligned
+    ///          to the original phase again.
+    bool IsDue (AcTaskTy task, int cycle);
+};
+
+//
+//MARK: AISlotMgrTy
+//
+
+class LTAircraft;
+
+/// @brief Assigns the limited multiplayer/TCAS slots to the most relevant aircraft
+/// @details Each aircraft reports a continuous slot cost (lower is more relevant,
+///          see LTAircraft::CalcAISlotCost()). The manager keeps the aircraft in two
+///          ordered sets, slot holders and others, so that one update costs O(log n)
+///          instead of a full re-sort. A challenger takes over a slot only if its cost
+///          is lower than the worst holder's by AI_SLOT_HYSTERESIS, which prevents
+///          slot thrashing between aircraft of similar relevance.\n
+///          The result is passed on to libxplanemp as LTAircraft::aiPrio:
+///          AI_PRIO_SLOT for holders, AI_PRIO_NO_SLOT for all others.\n
+///          Only accessed from the main thread (drawing callbacks and aircraft maintenance).
+class AISlotMgrTy
+{
+protected:
+    typedef std::pair<double,LTAircraft*> entryTy;   ///< cost and aircraft
+    std::set<entryTy> setSlot;                      ///< aircraft holding a slot
+    std::set<entryTy> setOther;                     ///< all other aircraft
+    std::unordered_map<LTAircraft*,double> mapCost; ///< current cost per aircraft, to find it in the sets
+    size_t numSlots = AI_SLOTS_MAX;                 ///< number of available slots
+
+public:
+    /// Sets (new) cost of an aircraft and reassigns slots if needed
+    void Update (LTAircraft* pAc, double cost);
+    /// Removes an aircraft, a freed slot is passed on
+    void Remove (LTAircraft* pAc);
+    /// Does the aircraft hold a slot?
+    bool HasSlot (LTAircraft* pAc) const;
+    /// Number of aircraft managed
+    size_t size () const { return mapCost.size(); }
+
+protected:
+    /// Fills free slots and swaps holders with better challengers
+    void Rebalance ();
+    /// Moves an entry between the sets and updates the aircraft's aiPrio
+    void Move (std::set<entryTy>& from, std::set<entryTy>::iterator it,
+               std::set<entryTy>& to, int aiPrio);
+};
+
+/// The one and only slot manager
+extern AISlotMgrTy aiSlots;
+
 //
 //MARK: LTAircraft
 //      Represents an aircraft as displayed in XP by use of the
@@ -143,6 +224,7 @@ public:
 //
 class LTAircraft : XPCAircraft
 {
+    friend AISlotMgrTy;             // sets aiPrio
 public:
     class FlightModel {
     public:
@@ -244,6 +326,8 @@ protected:
     
     // timestamp we last requested new positions from flight data
     double              tsLastCalcRequested;
+    /// receive time of the last position recorded in the latency statistics, avoids counting copies of the same position
+    double              lastLatencyRcvTs = 0.0;
     
     // dynamic parameters of the plane
     FlightPhase         phase;          // current flight phase
@@ -281,8 +365,9 @@ protected:
     bool                bVisible = true;        // is a/c visible?
     bool                bSetVisible = true;     // manually set visible?
     bool                bAutoVisible = true;    // visibility handled automatically?
-    int                 aiPrio = 0;     ///< prio for AI slotting (libxplanemp)
+    int                 aiPrio = AI_PRIO_NO_SLOT;   ///< prio for AI slotting (libxplanemp), set by AISlotMgrTy
     int                 multiIdx = 0;   ///< plane's multiplayer index if reported via sim/multiplayer/position dataRefs, 0 otherwise
+    AcTaskSchedTy       tasks;          ///< schedule of periodic tasks like refreshing radar or label
 public:
     LTAircraft(LTFlightData& fd);
     virtual ~LTAircraft();
@@ -356,8 +441,10 @@ protected:
     bool YProbe ();
     // determines if now visible
     bool CalcVisible ();
-    /// Determines AI priority based on bearing to user's plane and ground status
+    /// Updates the AI slot manager with the current slot cost
     void CalcAIPrio ();
+    /// Continuous slot cost based on distance, closure rate, and relevance to the user's flight, lower is more relevant
+    double CalcAISlotCost () const;
     
 protected:
     // *** Camera view ***
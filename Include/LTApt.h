@@ -46,6 +46,23 @@ positionTy LTAptFindRwy (const LTAircraft& _ac);
 /// @return Changed the position?
 bool LTAptSnap (positionTy& pos, bool bLogging);
 
+/// @brief Map-matches all ground positions of a track onto the rwy and taxiway network
+/// @details Only positions on the ground, which have not yet been artificially moved
+///          (`flightPhase == 0`) are considered. Consecutive such positions within
+///          one airport form a window, which is matched as a whole (HMM/Viterbi),
+///          so that the track doesn't zig-zag between parallel taxiways.
+///          A window directly following an already matched position continues
+///          from that position's edge, without moving it again.
+///          Where the track turns from one taxiway edge into the next,
+///          a position is inserted at the connecting taxi node.
+/// @param posDeque The track, individual positions might get changed, positions might get inserted.
+/// @param bLogging Do logging via LOG_MSG?
+/// @return Number of positions changed or inserted
+int LTAptSnapTrack (dequePositionTy& posDeque, bool bLogging);
+
+/// Estimated memory usage [bytes] of all loaded airports
+size_t LTAptMemUsage ();
+
 /// Cleanup
 void LTAptDisable ();
 
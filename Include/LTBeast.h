@@ -0,0 +1,133 @@
+/// @file       LTBeast.h
+/// @brief      Beast: Receives raw Mode-S frames in Beast binary format from a local ADS-B receiver
+/// @see        https://github.com/firestuff/adsb-tools/blob/master/protocols/beast.md
+/// @see        The 1090MHz Riddle, https://mode-s.org/decode/
+/// @details    Defines BeastConnection:\n
+///             - Keeps a TCP connection to a receiver like dump1090 (default port 30005)\n
+///             - Unescapes Beast frames, verifies CRC-24 of DF17/18 extended squitter\n
+///             - Decodes identification, airborne/surface position (CPR), and velocity\n
+///             - Passes complete updates on to LTFlightData.\n
+///             For testing, replay recorded Beast data on the configured port,
+///             e.g. `nc -lk 30005 < recording.beast`. CRC-24 and CPR decoding
+///             are checked against a corpus of frames with published decodes
+///             by Test/LTBeastTest (Test/BeastCorpus.txt).
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#ifndef LTBeast_h
+#define LTBeast_h
+
+#include "LTSBS.h"
+
+//
+// MARK: Beast Constants
+//
+
+#define BEAST_NAME              "Beast Receiver"
+
+constexpr uint8_t BEAST_ESC             = 0x1a;     ///< escape character, starts a frame, doubled if part of data
+constexpr uint8_t BEAST_TYPE_MODE_AC    = '1';      ///< Mode A/C frame
+constexpr uint8_t BEAST_TYPE_MODE_S_SHORT = '2';    ///< Mode-S short frame (56 bits)
+constexpr uint8_t BEAST_TYPE_MODE_S_LONG = '3';     ///< Mode-S long frame (112 bits)
+constexpr size_t BEAST_HEADER_LEN       = 7;        ///< 6 bytes MLAT timestamp, 1 byte signal level
+constexpr size_t MODES_LONG_LEN         = 14;       ///< bytes of a Mode-S long frame
+
+constexpr uint32_t MODES_CRC_POLY       = 0xFFF409; ///< Mode-S CRC-24 generator polynomial
+
+constexpr int CPR_NZ                    = 15;       ///< number of latitude zones between equator and pole
+constexpr double CPR_MAX               = 131072.0;  ///< 2^17, range of the 17 bit CPR values
+constexpr double CPR_MAX_PAIR_INTVL     = 10.0;     ///< [s] max time between even and odd frame for global decoding
+constexpr double CPR_MAX_LOCAL_AGE      = 60.0;     ///< [s] max age of last position to serve as reference for local decoding
+constexpr double CPR_MAX_LOCAL_DIST_AIRB = 180.0 * M_per_NM;    ///< [m] max distance of reference for local airborne decoding
+constexpr double CPR_MAX_LOCAL_DIST_SURF = 45.0 * M_per_NM;     ///< [m] max distance of reference for local surface decoding
+
+//
+// MARK: Beast Connection
+//
+class BeastConnection : public RcvrConnection
+{
+public:
+    /// One CPR encoded position as received
+    struct CprTy {
+        uint32_t    lat = 0;            ///< 17 bit encoded latitude
+        uint32_t    lon = 0;            ///< 17 bit encoded longitude
+        double      ts  = 0.0;          ///< when received, 0 if never
+        bool        bSurface = false;   ///< surface position?
+    };
+
+protected:
+
+    /// CPR decoding state of one aircraft
+    struct CprStateTy {
+        CprTy       cpr[2];             ///< last even [0] and odd [1] encoded position
+        double      lat = NAN;          ///< last decoded latitude
+        double      lon = NAN;          ///< last decoded longitude
+        double      ts  = 0.0;          ///< when last decoded
+    };
+
+    /// Map of CPR states, key is the numeric ICAO transponder code
+    typedef std::unordered_map<unsigned long, CprStateTy> mapCprStateTy;
+
+    mapCprStateTy mapCpr;               ///< CPR states per aircraft, only accessed by handlers
+    size_t cntCrcErr = 0;               ///< number of frames with CRC errors
+
+public:
+    BeastConnection (mapLTFlightDataTy& _fdMap);
+    virtual ~BeastConnection ();
+
+    virtual const char* ChName() const { return BEAST_NAME; }
+
+    /// Number of frames discarded due to CRC errors
+    size_t GetCrcErrCnt () const { return cntCrcErr; }
+
+protected:
+    virtual std::string GetHost () const;
+    virtual int GetPort () const;
+
+    /// Unescapes all complete frames in the receive buffer, keeps an incomplete rest
+    virtual void ProcessRcvBuf (double now);
+    /// Decodes one Mode-S long frame, adds an update to `vecUpd` when a position could be decoded
+    void ProcessModeS (const uint8_t* msg, double now);
+    /// Decodes a CPR position, either globally from an even/odd pair or locally from a reference
+    bool DecodeCpr (CprStateTy& st, int odd, double now, double& lat, double& lon);
+    /// Also removes outdated CPR states
+    virtual void CommitAndCleanup (double now);
+
+public:
+    // The static decoding functions are implemented in LTBeastDecode.cpp
+
+    /// Calculates the Mode-S CRC-24 over the first `len` bytes
+    static uint32_t ModeSCrc (const uint8_t* msg, size_t len);
+    /// @brief Extracts the CPR encoded position from the ME field of a position message (type codes 5-18, 20-22)
+    /// @param me The ME field, ie. the frame starting at its 5th byte
+    /// @param[out] cpr Receives encoded latitude/longitude and surface flag, `ts` is not touched
+    /// @return The CPR format: 0 = even, 1 = odd
+    static int CprFromME (const uint8_t* me, CprTy& cpr);
+    /// Number of longitude zones at given latitude
+    static int CprNL (double lat);
+    /// Global CPR decoding from an even/odd pair, `odd` tells which is the newer one
+    static bool CprGlobal (const CprTy& even, const CprTy& odd, int newer,
+                           double refLat, double refLon,
+                           double& lat, double& lon);
+    /// Local CPR decoding from one frame relative to a reference position
+    static void CprLocal (const CprTy& cpr, int odd,
+                          double refLat, double refLon,
+                          double& lat, double& lon);
+};
+
+#endif /* LTBeast_h */
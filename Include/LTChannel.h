@@ -57,6 +57,8 @@ public:
 protected:
     dataRefsLT channel;             // id of channel (see dataRef)
 
+    double netRcvTs = NAN;          ///< when the data being processed was received from the network (time base of positions' timestamps)
+
 private:
     bool bValid;                    // valid connection?
     int errCnt;                     // number of errors tolerated
@@ -87,12 +89,117 @@ public:
 public:
     virtual bool FetchAllData (const positionTy& pos) = 0;
     virtual bool ProcessFetchedData (mapLTFlightDataTy& fd) = 0;
+    /// Prepares more fetched data (like from further tiles) for another call to ProcessFetchedData, returns if there is any
+    virtual bool NextFetchedData () { return false; }
     // do something while disabled?
     virtual void DoDisabledProcessing () {}
     // (temporarily) close a connection, (re)open is with first call to FetchAll/ProcessFetchedData
     virtual void Close () {}
+    
+    /// Estimated memory [bytes] of raw network/file buffers, called from the flight data thread
+    virtual size_t GetRawBufSize () const { return 0; }
+    /// Estimated memory [bytes] of master data held by the channel, called from the flight data thread
+    virtual size_t GetMasterDataSize () const { return 0; }
+    /// Releases raw buffers beyond their initial size, called from the flight data thread
+    virtual void TrimRawBuf () {}
+    
+    /// Current system time in seconds, corrected by network time offset, i.e. in the time base of positions' timestamps
+    static double NetNow ();
+protected:
+    /// Tags a position with the receive time `netRcvTs` and this channel for latency measurement
+    void SetRcvTs (positionTy& pos) const { pos.rcvTs = netRcvTs; pos.rcvCh = channel; }
+};
+
+//
+//MARK: Latency Statistics
+//
+
+constexpr double LAT_HIST_BUCKET    = 0.5;      ///< [s] width of a latency histogram bucket
+constexpr size_t LAT_HIST_BUCKETS   = 600;      ///< number of buckets, the last one collects all higher latencies
+constexpr int    LAT_LOG_INTVL      = 300;      ///< [s] interval for logging latency statistics
+
+/// @brief Histogram of latencies
+/// @details Filled from the main thread while drawing,
+///          read by dataRefs and the flight data thread for logging
+class LatencyHistTy {
+protected:
+    mutable std::mutex mtx;                     ///< guards all of the below
+    std::array<unsigned,LAT_HIST_BUCKETS> hist; ///< number of values per bucket
+    unsigned cnt = 0;                           ///< total number of values
+    double sum = 0.0;                           ///< sum of all values
+    double maxVal = 0.0;                        ///< maximum value
+public:
+    LatencyHistTy () { hist.fill(0); }
+    /// Adds a latency value [s], negative values are taken as 0
+    void Add (double lat);
+    /// Removes all values
+    void clear ();
+    /// Number of values
+    unsigned Count () const;
+    /// Average latency [s], `NAN` if no values
+    double Avg () const;
+    /// Maximum latency [s], `NAN` if no values
+    double Max () const;
+    /// Latency [s] below which the given share `p` (0..1) of values lie, `NAN` if no values
+    double Percentile (double p) const;
+    /// Summary for log output: count, avg, p50, p95, max
+    std::string Summary () const;
+};
+
+/// Latency statistics of one channel
+struct LatencyStatTy {
+    LatencyHistTy rcvDisp;          ///< from network receipt to display
+    LatencyHistTy dispDelay;        ///< from position's timestamp to display
+};
+
+/// @brief Records latencies of a position, which is just being reached on screen
+/// @param pos The position reached, must have `rcvTs` set
+/// @param now Current time in the time base of positions' timestamps, see LTChannel::NetNow()
+void LTLatencyAdd (const positionTy& pos, double now);
+/// Latency statistics of given channel, or of all channels combined if `ch` is not a channel
+const LatencyStatTy& LTLatencyGet (int ch = 0);
+/// Logs latency statistics of all channels with values
+void LTLatencyLog ();
+/// Resets all latency statistics
+void LTLatencyReset ();
+
+/// @brief Statistics of all channels' last commit of updates
+/// @param[out] cnt Sum of updates in the last commit of all channels
+/// @param[out] lock_ms [ms] Longest time `mapFdMutex` was held during the last commit of any channel
+void LTCommitStatGet (size_t& cnt, double& lock_ms);
+
+//
+//MARK: Memory Accounting
+//
+
+/// Subsystems, for which memory usage is estimated
+enum LTMemSubsysTy {
+    MEM_FLIGHT_DATA = 0,            ///< flight data objects: keys, static data, labels
+    MEM_POS_BUF,                    ///< buffered positions and dynamic data, also of aircraft
+    MEM_AIRPORTS,                   ///< airport data read from apt.dat
+    MEM_MASTER_DATA,                ///< master data requests and read buffers
+    MEM_RAW_BUF,                    ///< raw network and file buffers
+    MEM_TOTAL                       ///< all of the above
 };
 
+/// Estimated memory usage [bytes] of a subsystem as of the last check
+size_t LTMemUsage (LTMemSubsysTy sub);
+
+/// @brief Updates memory usage and enforces the memory budget
+/// @details Removes flight data of aircraft not displayed, farthest first,
+///          and trims buffers while the budget is exceeded.
+///          Called from flight loop callback, runs every MEM_CHECK_INTVL seconds only.
+void LTFlightDataMemCheck ();
+
+/// @brief Applies settings changes incrementally instead of re-initializing everything
+/// @details Only flight data affected by the change is removed: data of
+///          disabled channels, out of a reduced search radius, or not matching
+///          a new a/c filter. The flight data thread is woken up so that channels
+///          start, stop, or query the changed area right away.
+///          Called from flight loop callback.
+/// @param chg Bitmask of CfgChangeTy values
+void LTFlightDataApplyCfgChanges (unsigned chg);
+
 // Collection of smart pointers requires C++ 17 to compile correctly!
 #if __cplusplus < 201703L
 #error Collection of smart pointers requires C++ 17 to compile correctly
@@ -108,8 +215,57 @@ typedef std::list<ptrLTChannelTy> listPtrLTChannelTy;
 //MARK: LTFlightDataChannel
 //
 class LTFlightDataChannel : virtual public LTChannel {
+public:
+    /// One decoded tracking data record, ready to be committed to the flight data map
+    struct FDUpdateTy {
+        LTFlightData::FDKeyTy       key;            ///< aircraft's key
+        LTFlightData::FDStaticData  stat;           ///< static data
+        LTFlightData::FDDynamicData dyn;            ///< dynamic data
+        positionTy                  pos;            ///< position
+        bool                        bPos = false;   ///< is `pos` valid and shall dynamic data be added?
+    };
+    /// Vector of decoded tracking data records
+    typedef std::vector<FDUpdateTy> vecFDUpdateTy;
+    
+protected:
+    std::atomic<size_t> lastCommitCnt {0};          ///< number of updates in last call to CommitUpdates()
+    std::atomic<double> lastCommitLock_ms {0.0};    ///< [ms] time `mapFdMutex` was held during last call to CommitUpdates()
+    
 public:
     LTFlightDataChannel () {}
+    
+    /// Number of updates in the last commit
+    size_t GetLastCommitCnt () const { return lastCommitCnt; }
+    /// [ms] time `mapFdMutex` was held during the last commit
+    double GetLastCommitLock_ms () const { return lastCommitLock_ms; }
+    
+protected:
+    /// @brief Commits decoded updates to the flight data map
+    /// @details Updates are grouped by aircraft, so that `mapFdMutex` is taken
+    ///          only once and each aircraft's `dataAccessMutex` only once per aircraft.
+    ///          All decoding is expected to have happened before, without any lock.
+    ///          Aircraft outside the standard distance are only kept in the
+    ///          regional ring (see LTRegional.h), aircraft moving inside are promoted.
+    /// @param fdMap The map of flight data to update
+    /// @param vecUpd The updates, will be sorted and their static data moved from
+    /// @param viewPos Camera position, which decides between regional and full tracking
+    void CommitUpdates (mapLTFlightDataTy& fdMap, vecFDUpdateTy& vecUpd,
+                        const positionTy& viewPos);
+    
+
+    /// @brief Early reject of a tracking data record, based on key and position only
+    /// @details Called before any static/dynamic data is decoded and before `mapFdMutex` is taken
+    /// @param key Aircraft's key, its normalized key string is tested against `acFilter`
+    /// @param acFilter Debug aircraft filter, empty if not set
+    /// @param viewPos Current camera position
+    /// @param lat Latitude of the record, can be `NAN` if the record has no position
+    /// @param lon Longitude of the record, can be `NAN` if the record has no position
+    /// @param alt_m Altitude in meter, can be `NAN`
+    /// @return Shall the record be processed any further?
+    static bool IsRecordOfInterest (const LTFlightData::FDKeyTy& key,
+                                    const std::string& acFilter,
+                                    const positionTy& viewPos,
+                                    double lat, double lon, double alt_m);
 };
 
 //
@@ -161,6 +317,10 @@ public:
                                    const std::string callSign);
     static void ClearMasterDataRequests ();
     
+    /// Estimated memory [bytes] of the global list of master data requests
+    static size_t GetRequestListSize ();
+    virtual size_t GetMasterDataSize () const;
+    
 protected:
     // uniquely copies entries from listAcStatUpdate to listAc
     void CopyGlobalRequestList ();
@@ -180,6 +340,22 @@ protected:
     char curl_errtxt[CURL_ERROR_SIZE];    // where error text goes
     long httpResponse;              // last HTTP response code
     
+    /// One tile of a query area, see FetchAllTiles()
+    struct TileTy {
+        int ring = 0;               ///< distance from the center tile (0 = the tile(s) around the camera)
+        std::string url;            ///< request URL
+        CURL* pCurl = nullptr;      ///< CURL handle during transfer
+        CURLcode cc = CURLE_OK;     ///< result of transfer
+        long httpResponse = 0;      ///< HTTP response code
+        std::string data;           ///< the response
+        double rcvTs = NAN;         ///< when the response was (last) received
+        char curl_errtxt[CURL_ERROR_SIZE] = {0};    ///< where error text goes
+    };
+    /// List of tiles
+    typedef std::list<TileTy> listTileTy;
+    listTileTy listTiles;           ///< tiles fetched in the last cycle, yet to be processed
+    unsigned tileCycle = 0;         ///< counts fetch cycles, so outer tiles can be fetched less often
+    
     static std::ofstream outRaw;    // output file for raw logging
     
 public:
@@ -191,13 +367,35 @@ protected:
     virtual void CleanupCurl ();
     // CURL callback
     static size_t ReceiveData ( const char *ptr, size_t size, size_t nmemb, void *userdata );
+    /// CURL callback when fetching tiles, appends to TileTy::data
+    static size_t ReceiveTileData ( const char *ptr, size_t size, size_t nmemb, void *userdata );
+    /// Fetches the query area split into tiles, concurrently
+    bool FetchAllTiles (const positionTy& pos);
+    /// @brief Retries a failed transfer once without querying the revocation list if that was the problem
+    /// @details Also switches off revocation list queries for all future requests via `pCurl`
+    /// @param pHandle The CURL handle, which failed, must not be part of a multi handle
+    /// @param cc Result of the failed transfer
+    /// @param errTxt CURL's error text of the failed transfer
+    /// @return Result of the retry, or `cc` if not retried
+    CURLcode RetryOnRevocationError (CURL* pHandle, CURLcode cc, const char* errTxt);
+    /// Logs unexpected HTTP response codes
+    void LogHttpResponse (long resp, const std::string& url) const;
     // logs raw data to a text file
     void DebugLogRaw (const char* data);
     
 public:
     virtual bool FetchAllData (const positionTy& pos);
+    virtual bool NextFetchedData ();
     virtual std::string GetURL (const positionTy& pos) = 0;
+    /// Can the query area be split into tiles? (requires GetQueryArea and GetTileURL)
+    virtual bool CanTile () const { return false; }
+    /// Total area to query around `pos`, split into tiles if `CanTile()`
+    virtual boundingBoxTy GetQueryArea (const positionTy& pos) const;
+    /// URL to query one tile of the query area
+    virtual std::string GetTileURL (const boundingBoxTy& /*tile*/) { return std::string(); }
     virtual bool IsLiveFeed () const    { return true; }
+    virtual size_t GetRawBufSize () const;
+    virtual void TrimRawBuf ();
     
     /// Is the given network error text possibly caused by problems querying the revocation list?
     static bool IsRevocationError (const std::string& err);
@@ -216,6 +414,7 @@ protected:
 public:
     LTFileChannel ();
     virtual bool IsLiveFeed () const    {return false;}
+    virtual size_t GetRawBufSize () const;
 };
 
 //
@@ -0,0 +1,111 @@
+/// @file       LTClock.h
+/// @brief      LiveTraffic's clock, running on real or on virtual time
+/// @details    All of LiveTraffic's time keeping (simulated time in live mode,
+///             network receive time, channel timers, thread wake-ups, and
+///             drawing cycles) is based on LTClock instead of directly on
+///             `std::chrono::steady_clock`, `std::chrono::system_clock`, or
+///             X-Plane's elapsed time.\n
+///             In real mode, LTClock just passes on real time.\n
+///             In virtual mode, time only moves forward when advanced by
+///             LTClock::Advance(). A test driver can so replay the exact same
+///             event sequence, also faster than real time, for reproducible
+///             performance comparisons.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#ifndef LTClock_h
+#define LTClock_h
+
+#include <cmath>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+/// In virtual mode, waiting threads check this often if virtual time has reached their deadline
+constexpr std::chrono::milliseconds LTCLOCK_VIRT_POLL = std::chrono::milliseconds(1);
+
+/// @brief LiveTraffic's clock, running on real or on virtual time
+/// @details Meets the requirements of a C++ steady clock, so that it can be used
+///          for time points, timers, and deadlines just like `std::chrono::steady_clock`.
+class LTClock
+{
+public:
+    typedef std::chrono::steady_clock::duration duration;
+    typedef duration::rep                       rep;
+    typedef duration::period                    period;
+    typedef std::chrono::time_point<LTClock>    time_point;
+    static constexpr bool is_steady = true;
+
+protected:
+    static std::atomic<bool> bVirtual;          ///< running on virtual time?
+    static std::atomic<rep>  vNow;              ///< virtual mode: current time point, in `duration` ticks
+    static rep    vStart;                       ///< virtual mode: time point when virtual mode started
+    static double vSysStart;                    ///< virtual mode: system time [s since epoch] when virtual mode started
+    static float  vElapsedStart;                ///< virtual mode: X-Plane's elapsed time when virtual mode started
+
+public:
+    /// Current time point, replaces `std::chrono::steady_clock::now()`
+    static time_point now () noexcept;
+    /// Current system time in seconds since the epoch, replaces `std::chrono::system_clock::now()`
+    static double SysNow ();
+    /// Seconds since X-Plane started, replaces `XPLMGetElapsedTime()`
+    static float Elapsed ();
+
+    /// @brief Switches between real and virtual time
+    /// @details Virtual time starts where real time is at the moment of switching.
+    ///          Switching back to real time makes time jump back if virtual time
+    ///          was advanced faster than real time, so better switch only while
+    ///          no aircraft are shown.
+    /// @param _bVirtual Switch to virtual time?
+    /// @param startSysTime Virtual mode: system time [s since epoch] to start with, `NAN` for current system time
+    static void SetVirtual (bool _bVirtual, double startSysTime = NAN);
+    /// Running on virtual time?
+    static bool IsVirtual () { return bVirtual; }
+    /// Virtual mode only: moves time forward
+    static void Advance (duration d);
+
+    /// @brief Waits on a condition variable until `pred` is true or `deadline` is reached
+    /// @details Replaces `cv.wait_until(lk, deadline, pred)`. In virtual mode
+    ///          the deadline is checked against virtual time every LTCLOCK_VIRT_POLL.
+    /// @return `pred()` when returning
+    template<class Predicate>
+    static bool WaitUntil (std::condition_variable& cv,
+                           std::unique_lock<std::mutex>& lk,
+                           time_point deadline,
+                           Predicate pred)
+    {
+        if (!bVirtual)
+            return cv.wait_until(lk, std::chrono::steady_clock::time_point(deadline.time_since_epoch()), pred);
+        while (!pred()) {
+            if (now() >= deadline)
+                return pred();
+            cv.wait_for(lk, LTCLOCK_VIRT_POLL);
+        }
+        return true;
+    }
+
+    /// Sleeps for the given duration of real or virtual time, replaces `std::this_thread::sleep_for()`
+    static void SleepFor (duration d);
+
+    /// @brief Caps a socket wait timeout so that virtual deadlines are checked often enough
+    /// @param timeout_ms Intended timeout in milliseconds, negative for "infinite", which is passed on unchanged
+    static int CapWaitMs (int timeout_ms);
+};
+
+#endif /* LTClock_h */
@@ -0,0 +1,78 @@
+/// @file       LTCpa.h
+/// @brief      Closest point of approach (CPA): Predicts which aircraft come close to the user's plane
+/// @details    Regularly computes, in a separate thread, time and distance of the
+///             closest approach between the user's plane and every tracked aircraft.
+///             The user's plane is extrapolated along its current track and speed,
+///             the aircraft follow their future positions as buffered in `posDeque`.\n
+///             The calculation collects all path segments of the fleet into flat arrays
+///             first and then processes them in one tight, branch-free loop.\n
+///             The result ranks the most threatening aircraft. They are exposed via
+///             `livetraffic/cpa/...` dataRefs and feed into AI slot priority
+///             and aircraft creation.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#ifndef LTCpa_h
+#define LTCpa_h
+
+//
+// MARK: CPA Constants
+//
+
+constexpr double CPA_HORIZON        = 120.0;            ///< [s] look-ahead time
+constexpr double CPA_THREAT_DIST_H  = 2.0 * M_per_NM;   ///< [m] horizontal distance at CPA below which an aircraft is a threat
+constexpr double CPA_THREAT_DIST_V  = 1000.0 * M_per_FT;///< [m] vertical separation at CPA below which an aircraft is a threat
+constexpr double CPA_TIME_WEIGHT    = 50.0;             ///< [m/s] ranking: each second until CPA counts like this many meters of distance
+constexpr size_t CPA_NUM_THREATS    = 3;                ///< number of top threats exposed via dataRefs
+
+//
+// MARK: CPA Results
+//
+
+/// Closest approach of one aircraft to the user's plane
+struct CpaTy {
+    LTFlightData::FDKeyTy key;  ///< aircraft's key
+    double tCpa     = NAN;      ///< [s] time from now until CPA
+    double distH    = NAN;      ///< [m] horizontal distance at CPA
+    double distV    = NAN;      ///< [m] vertical separation at CPA
+    double cost     = NAN;      ///< ranking value: effective distance at CPA plus time weight, lower is more threatening
+
+    /// Is this closest approach a threat, ie. close enough horizontally and vertically?
+    bool IsThreat () const { return distH < CPA_THREAT_DIST_H && distV < CPA_THREAT_DIST_V; }
+};
+
+/// Vector of CPA results
+typedef std::vector<CpaTy> vecCpaTy;
+
+/// @brief Starts a new CPA calculation in a separate thread, unless one is still running
+/// @note Call from X-Plane's main thread, reads the user's plane's position
+void LTCpaUpdate ();
+
+/// Waits for a running calculation and removes all results
+void LTCpaClear ();
+
+/// Returns the latest CPA result of an aircraft, `false` if none available
+bool LTCpaGet (const LTFlightData::FDKeyTy& key, CpaTy& cpa);
+
+/// Is the aircraft one of the top threats?
+bool LTCpaIsThreat (const LTFlightData::FDKeyTy& key);
+
+/// Returns a copy of the top threats, most threatening first, at most CPA_NUM_THREATS
+vecCpaTy LTCpaGetThreats ();
+
+#endif /* LTCpa_h */
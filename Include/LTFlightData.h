@@ -42,6 +42,167 @@ enum transpTy {
     trt_ADS_B_2=5
 };
 
+//
+//MARK: Timing Wheel
+//
+
+constexpr size_t TW_SLOTS = 64;         ///< number of slots per level of a TimingWheelTy
+
+/// @brief Hierarchical timing wheel, tells which keys are due at a given time
+/// @details Two levels: The inner wheel has TW_SLOTS slots `res` seconds wide,
+///          the outer wheel has TW_SLOTS slots TW_SLOTS * `res` seconds wide,
+///          which are cascaded into the inner wheel when reached.
+///          Keys due even later wait in the outer wheel's farthest slot
+///          and get cascaded repeatedly.\n
+///          The due time per key is kept separately. Slot entries are
+///          only hints: When a slot is reached, keys are reported only
+///          if their (current) due time has come. This way, rescheduling
+///          and removing keys doesn't need to search slots.\n
+///          Keys are reported never early, and at most `res` seconds late,
+///          keys scheduled for a time already passed with the next tick.\n
+///          Not thread-safe, guard it with the lock of the data it schedules.
+template <class KeyT>
+class TimingWheelTy {
+protected:
+    typedef std::vector<KeyT> vecKeyTy;
+    const double res;                   ///< [s] width of an inner slot
+    bool bStarted = false;              ///< has PopDue() been called at least once?
+    long long curTick = 0;              ///< next tick to process
+    vecKeyTy inner[TW_SLOTS];           ///< inner wheel, slot per tick
+    vecKeyTy outer[TW_SLOTS];           ///< outer wheel, slot per TW_SLOTS ticks
+    std::map<KeyT,double> mapDue;       ///< due time per scheduled key
+
+public:
+    /// Constructor sets the resolution [s]
+    TimingWheelTy (double _res = 1.0) : res(_res) {}
+    
+    /// Number of scheduled keys
+    size_t size () const { return mapDue.size(); }
+    /// Is the key scheduled?
+    bool contains (const KeyT& key) const { return mapDue.count(key) > 0; }
+    /// Remove all keys
+    void clear ()
+    {
+        mapDue.clear();
+        for (vecKeyTy& v: inner) v.clear();
+        for (vecKeyTy& v: outer) v.clear();
+        bStarted = false;
+    }
+    
+    /// (Re)schedules the key for the given time
+    void Schedule (const KeyT& key, double due)
+    {
+        mapDue[key] = due;
+        Place(key, due);
+    }
+    
+    /// Schedules the key no later than the given time, i.e. keeps an earlier due time
+    void ScheduleBefore (const KeyT& key, double due)
+    {
+        typename std::map<KeyT,double>::const_iterator it = mapDue.find(key);
+        if (it == mapDue.end() || due < it->second)
+            Schedule(key, due);
+    }
+    
+    /// Removes the key from the schedule
+    void Remove (const KeyT& key) { mapDue.erase(key); }
+    
+    /// @brief Moves the wheel forward to `now`, returns the keys that are due
+    /// @details Reported keys are removed from the schedule,
+    ///          the caller is expected to reschedule them if still needed.
+    /// @param now Current time
+    /// @param[out] vecDue Keys that are due, appended
+    void PopDue (double now, vecKeyTy& vecDue)
+    {
+        const long long nowTick = Tick(now);
+        
+        // first use, large time jump, or time moving backwards:
+        // check all keys, then start over with the remaining ones
+        if (!bStarted ||
+            nowTick - curTick >= (long long)TW_SLOTS ||
+            nowTick < curTick - 1)
+        {
+            for (vecKeyTy& v: inner) v.clear();
+            for (vecKeyTy& v: outer) v.clear();
+            bStarted = true;
+            curTick = nowTick + 1;
+            for (typename std::map<KeyT,double>::iterator it = mapDue.begin(); it != mapDue.end(); ) {
+                if (it->second <= now) {
+                    vecDue.push_back(it->first);
+                    it = mapDue.erase(it);
+                } else {
+                    Place(it->first, it->second);
+                    ++it;
+                }
+            }
+            return;
+        }
+        
+        // process all ticks up to now
+        for (; curTick <= nowTick; ++curTick)
+        {
+            // reached a new round of the inner wheel? Cascade the matching outer slot
+            if (Mod(curTick) == 0) {
+                vecKeyTy v;
+                v.swap(outer[Mod(curTick / (long long)TW_SLOTS)]);
+                for (const KeyT& key: v)
+                    PlaceIfScheduled(key);
+            }
+            
+            // all keys of this tick
+            vecKeyTy v;
+            v.swap(inner[Mod(curTick)]);
+            for (const KeyT& key: v) {
+                typename std::map<KeyT,double>::iterator it = mapDue.find(key);
+                if (it == mapDue.end())             // removed or already reported
+                    continue;
+                if (it->second <= now) {
+                    vecDue.push_back(key);
+                    mapDue.erase(it);
+                }
+                else if (Tick(it->second) <= curTick) {
+                    // due later within the current tick, look again next time
+                    inner[Mod(curTick+1)].push_back(key);
+                }
+                // otherwise the key got rescheduled to later and is found in another slot
+            }
+        }
+    }
+
+protected:
+    /// Tick of a given time
+    long long Tick (double t) const { return (long long)std::floor(t / res); }
+    /// Slot index of a tick
+    static size_t Mod (long long tick)
+    { return size_t(((tick % (long long)TW_SLOTS) + (long long)TW_SLOTS) % (long long)TW_SLOTS); }
+    
+    /// Puts the key into the slot matching the due time
+    void Place (const KeyT& key, double due)
+    {
+        if (!bStarted)                      // PopDue will check all keys first
+            return;
+        const long long tick = std::max(Tick(due), curTick);
+        const long long delta = tick - curTick;
+        if (delta < (long long)TW_SLOTS)
+            inner[Mod(tick)].push_back(key);
+        else {
+            // outer wheel, but not beyond its farthest slot
+            const long long curRound = curTick / (long long)TW_SLOTS;
+            const long long round = std::min(tick / (long long)TW_SLOTS,
+                                             curRound + (long long)TW_SLOTS - 1);
+            outer[Mod(round)].push_back(key);
+        }
+    }
+    
+    /// Places the key according to its due time, if still scheduled
+    void PlaceIfScheduled (const KeyT& key)
+    {
+        typename std::map<KeyT,double>::const_iterator it = mapDue.find(key);
+        if (it != mapDue.end())
+            Place(key, it->second);
+    }
+};
+
 //
 //MARK: Flight Data
 //      Represents an Aircraft's flight data, as read from the source(s)
@@ -50,6 +211,9 @@ enum transpTy {
 class LTAircraft;
 struct LTFlightDataList;
 
+/// [bytes] estimated memory of one buffered position, including its valarray
+constexpr size_t MEM_POS_SIZE = sizeof(positionTy) + (positionTy::ROLL+1) * sizeof(double);
+
 class LTFlightData
 {
     // sub classes for sets of data
@@ -270,6 +434,7 @@ public:
     void SetInvalid();
     
     // KEY into the map
+    /// Sets the key of a new flight data object and schedules its maintenance, caller must hold `mapFdMutex`
     void SetKey    (const FDKeyTy& _key);
     void SetKey    (FDKeyType eType, unsigned long _num)                    { acKey.SetKey(eType, _num); }
     void SetKey    (FDKeyType eType, const std::string _key, int base=16)   { acKey.SetKey(eType, _key, base); }
@@ -289,6 +454,12 @@ public:
     inline bool hasAc() const       { return pAc != nullptr; }
     // is the data outdated (considered too old to be useful)?
     bool outdated ( double simTime = NAN ) const;
+    /// @brief Estimated memory usage, caller must hold `dataAccessMutex`
+    /// @param[out] fdBytes Flight data: key, static data, label
+    /// @param[out] posBytes Position buffers and dynamic data, including the aircraft's
+    void MemUsage (size_t& fdBytes, size_t& posBytes) const;
+    /// Releases unused capacity of the buffers, caller must hold `dataAccessMutex`
+    void TrimBuffers ();
 
     // produce a/c label
     void UpdateStaticLabel();
@@ -331,6 +502,18 @@ public:
     
     // determine Ground-status based on dynDataDeque, requires lock for access, so may fail if locked
     bool TryDeriveGrndStatus (positionTy& pos);
+    /// @brief Batch stage: determines ground status of positions, caller must own `dataAccessMutex`
+    /// @details Terrain altitude is probed first for all positions in question,
+    ///          then all of them are classified in one sweep.
+    ///          The terrain altitude is cached in positionTy::terrainAlt.
+    /// @param dq Positions to process
+    /// @param bAll Process (and probe) all positions? Otherwise only those with unknown status
+    /// @note Call from X-Plane's main thread only, as it probes terrain
+    void DeriveGrndStatus (dequePositionTy& dq, bool bAll);
+protected:
+    /// Classifies ground status based on the known terrain altitude, sets altitude to terrain if on ground
+    static void ClassifyGrndStatus (positionTy& pos);
+public:
     // determine terrain alt at pos
     double YProbe_at_m (const positionTy& pos);
     // returns vector at timestamp (which has speed, direction and the like)
@@ -362,7 +545,11 @@ public:
     //
     
     // access/create/destroy aircraft
-    bool AircraftMaintenance ( double simTime );    // returns: delete me?
+    /// @brief Regular maintenance: creates/removes aircraft, updates labels
+    /// @param simTime Current simulated time
+    /// @param[out] nextMaint When maintenance is due next
+    /// @return Is the flight data outdated, shall it be deleted?
+    bool AircraftMaintenance ( double simTime, double& nextMaint );
     bool CreateAircraft ( double simTime );
     void DestroyAircraft ();
     LTAircraft* GetAircraft () const { return pAc; }
@@ -383,6 +570,10 @@ extern mapLTFlightDataTy mapFd;
 // (note that mapFdMutex must be locked before dataAccessMutex
 //  to avoid deadlocks, mapFdMutex is considered a higher-level lock)
 extern std::mutex      mapFdMutex;
+/// @brief Schedule of flight data maintenance, guarded by `mapFdMutex`
+/// @details Every flight data object in `mapFd` is scheduled, so that
+///          LTFlightDataAcMaintenance() only needs to look at the ones that are due.
+extern TimingWheelTy<LTFlightData::FDKeyTy> wheelFdMaint;
 
 /// @brief Returns the next flight data, which has a defined aircraft (pAc)
 /// @param iter Starting point
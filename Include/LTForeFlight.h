@@ -51,20 +51,18 @@ class ForeFlightSender : public LTOnlineChannel, LTFlightDataChannel
 protected:
     // the map of flight data, data that we send out to ForeFlight
     mapLTFlightDataTy& fdMap;
-    // thread
-    std::thread thrUdpSender;
-    volatile bool bStopUdpSender  = true;   // tells thread to stop
-    std::mutex  ffStopMutex;                // supports wake-up and stop synchronization
-    std::condition_variable ffStopCV;
+    // NetEventLoop timer, which sends the data
+    unsigned timerId = 0;
     // UDP sender
     UDPReceiver udpSender;
     bool    bSendUsersPlane = true;
     bool    bSendAITraffic  = true;
     // time points last sent something
-    std::chrono::steady_clock::time_point nextGPS;
-    std::chrono::steady_clock::time_point nextAtt;
-    std::chrono::steady_clock::time_point nextTraffic;
-    std::chrono::steady_clock::time_point lastStartOfTraffic;
+    LTClock::time_point nextGPS;
+    LTClock::time_point nextAtt;
+    LTClock::time_point nextTraffic;
+    LTClock::time_point lastStartOfTraffic;
+    LTFlightData::FDKeyTy lastKey;          // last traffic sent out
 
 public:
     ForeFlightSender (mapLTFlightDataTy& _fdMap);
@@ -87,8 +85,7 @@ protected:
     bool StopConnection ();
     
     // send positions
-    void udpSend();                 // thread's main function
-    static void udpSendS (ForeFlightSender* me) { me->udpSend(); }
+    NetEventLoop::timePointTy udpSend(); // NetEventLoop timer handler, returns next wakeup
     void SendGPS (const positionTy& pos, double speed_m, double track); // position of user's aircraft
     void SendAtt (const positionTy& pos, double speed_m, double track); // attitude of user's aircraft
     void SendAllTraffic (); // other traffic
@@ -0,0 +1,174 @@
+/// @file       LTMulticast.h
+/// @brief      Multicast: Shares cleansed positions between LiveTraffic instances on a LAN
+/// @details    Defines MulticastSender and MulticastReceiver:\n
+///             - The sender regularly publishes new positions of all aircraft,
+///               as found in the flight data after data cleansing,
+///               in a compact binary format to a UDP multicast group.\n
+///             - The receiver listens to the group and passes the positions
+///               on to its own LTFlightData, so that several instances
+///               (e.g. a multi-seat setup) show the same traffic while only
+///               one of them fetches data from the internet.\n
+///             Datagram format, all values little endian:\n
+///             - Header (MC_HEADER_LEN bytes): magic "LTMC", version (1 byte),
+///               number of records (1 byte), record length (2 bytes), sender's instance id (4 bytes)\n
+///             - Records (MC_RECORD_LEN bytes each), see MulticastSender::EncodeRecord()
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#ifndef LTMulticast_h
+#define LTMulticast_h
+
+#include "LTChannel.h"
+#include "Network.h"
+
+//
+// MARK: Multicast Constants
+//
+
+#define MC_SENDER_NAME          "Multicast Sender"
+#define MC_RECEIVER_NAME        "Multicast Receiver"
+#define MC_ANY_ADDR             "0.0.0.0"
+
+constexpr uint8_t MC_MAGIC[4]           = { 'L', 'T', 'M', 'C' };   ///< first bytes of each datagram
+constexpr uint8_t MC_VERSION            = 1;        ///< format version
+constexpr size_t MC_HEADER_LEN          = 12;       ///< length of datagram header
+constexpr size_t MC_RECORD_LEN          = 64;       ///< length of one position record
+constexpr size_t MC_MAX_REC_PER_DGRAM   = 20;       ///< max records per datagram, keeps datagrams below typical MTU
+constexpr size_t MC_MAX_DGRAM_LEN       = MC_HEADER_LEN + MC_MAX_REC_PER_DGRAM * MC_RECORD_LEN;
+constexpr int MC_TTL                    = 1;        ///< multicast stays on the local network
+constexpr std::chrono::milliseconds MC_SEND_INTVL   = std::chrono::milliseconds(1000);  ///< interval for publishing new positions
+constexpr std::chrono::milliseconds MC_RETRY_INTVL  = std::chrono::milliseconds(  20);  ///< retry interval if flight data is locked
+constexpr std::chrono::milliseconds MC_COMMIT_INTVL = std::chrono::milliseconds(1000);  ///< interval for committing received updates
+
+#define MSG_MC_OPENED           "%s: Using multicast group %s:%d"
+#define MSG_MC_STOPPED          "%s: Stopped"
+#define ERR_MC_OPEN             "%s: Error opening multicast group %s:%d: %s (%s)"
+
+//
+// MARK: Multicast Sender
+//
+class MulticastSender : public LTOnlineChannel, LTFlightDataChannel
+{
+protected:
+    /// the map of flight data, data that we send out
+    mapLTFlightDataTy& fdMap;
+    /// NetEventLoop timer, which sends the data
+    unsigned timerId = 0;
+    /// multicast socket
+    UDPMulticast udpMC;
+    /// timestamp of last position sent per aircraft, only accessed by the timer
+    std::map<LTFlightData::FDKeyTy,double> mapLastSentTs;
+    /// datagram being filled, only accessed by the timer
+    uint8_t dgram[MC_MAX_DGRAM_LEN];
+    /// number of records in `dgram`
+    size_t cntRec = 0;
+
+public:
+    MulticastSender (mapLTFlightDataTy& _fdMap);
+    virtual ~MulticastSender ();
+
+    virtual std::string GetURL (const positionTy&) { return ""; }   // don't need URL, no request/reply
+    virtual bool IsLiveFeed() const { return true; }
+    virtual LTChannelType GetChType() const { return CHT_TRAFFIC_SENDER; }
+    virtual const char* ChName() const { return MC_SENDER_NAME; }
+
+    // interface called from LTChannel
+    virtual bool FetchAllData(const positionTy& pos);
+    virtual bool ProcessFetchedData (mapLTFlightDataTy&) { return true; }
+    virtual void DoDisabledProcessing();
+    virtual void Close ();
+
+    /// @brief Encodes one position record
+    /// @details Layout (offset: content):\n
+    ///          0: key type, 1: flags (bit 0: on ground), 2: squawk, 4: numeric key,\n
+    ///          8: timestamp (double), 16: latitude * 10^7, 20: longitude * 10^7,\n
+    ///          24: altitude [m] (float, NAN if unknown), 28: heading * 100,
+    ///          30: vertical speed [ft/min], 32: ground speed [kn] * 10,\n
+    ///          34: transponder type, 35: reserved,
+    ///          36: call sign (8 chars), 44: ICAO a/c type (4 chars),
+    ///          48: operator ICAO (4 chars), 52: registration (12 chars)
+    static void EncodeRecord (uint8_t* p,
+                              const LTFlightData::FDKeyTy& key,
+                              const LTFlightData::FDStaticData& stat,
+                              const LTFlightData::FDDynamicData& dyn,
+                              const positionTy& pos);
+
+protected:
+    // Start/Stop
+    bool StartConnection ();
+    bool StopConnection ();
+
+    /// NetEventLoop timer handler: publishes new positions, returns next wakeup
+    NetEventLoop::timePointTy mcSend ();
+    /// Sends and empties `dgram` if it contains any record
+    void SendDgram ();
+};
+
+//
+// MARK: Multicast Receiver
+//
+class MulticastReceiver : public LTOnlineChannel, LTFlightDataChannel
+{
+protected:
+    /// the map of flight data, where we deliver our data to
+    mapLTFlightDataTy& fdMap;
+    /// NetEventLoop timer, which commits received updates
+    unsigned timerId = 0;
+    /// multicast socket
+    UDPMulticast udpMC;
+
+    std::mutex posMutex;                ///< guards `posCamera`
+    positionTy posCamera;               ///< current camera position, set by FetchAllData()
+
+    vecFDUpdateTy vecUpd;               ///< updates not yet committed, only accessed by handlers
+    positionTy viewPos;                 ///< copy of `posCamera` used while processing, only accessed by handlers
+    std::string acFilter;               ///< copy of debug a/c filter used while processing, only accessed by handlers
+
+public:
+    MulticastReceiver (mapLTFlightDataTy& _fdMap);
+    virtual ~MulticastReceiver ();
+
+    virtual std::string GetURL (const positionTy&) { return ""; }   // don't need URL, no request/reply
+    virtual bool IsLiveFeed() const { return true; }
+    virtual LTChannelType GetChType() const { return CHT_TRACKING_DATA; }
+    virtual const char* ChName() const { return MC_RECEIVER_NAME; }
+
+    // interface called from LTChannel
+    virtual bool FetchAllData(const positionTy& pos);
+    virtual bool ProcessFetchedData (mapLTFlightDataTy&) { return true; }  // the timer commits data itself
+    virtual void DoDisabledProcessing();
+    virtual void Close ();
+
+    /// @brief Decodes one position record as encoded by MulticastSender::EncodeRecord()
+    /// @return `false` if the record is invalid
+    static bool DecodeRecord (const uint8_t* p, LTFlightDataChannel::FDUpdateTy& upd);
+
+protected:
+    // Start/Stop
+    bool StartConnection ();
+    bool StopConnection ();
+
+    /// Socket handler: receives and decodes one datagram
+    void OnData ();
+    /// Timer handler: commits updates, refreshes filter data
+    NetEventLoop::timePointTy OnTimer ();
+    /// Refreshes `viewPos` and `acFilter`
+    void RefreshFilter ();
+};
+
+#endif /* LTMulticast_h */
@@ -59,6 +59,9 @@ public:
     LTOnlineChannel(),
     LTFlightDataChannel()  {}
     virtual std::string GetURL (const positionTy& pos);
+    // OpenSky queries a bounding box, which can easily be split into tiles
+    virtual bool CanTile () const { return true; }
+    virtual std::string GetTileURL (const boundingBoxTy& tile);
     virtual bool ProcessFetchedData (mapLTFlightDataTy& fdMap);
     virtual bool IsLiveFeed() const { return true; }
     virtual LTChannelType GetChType() const { return CHT_TRACKING_DATA; }
@@ -116,26 +116,18 @@ protected:
     mapLTFlightDataTy& fdMap;
 
     // tcp connection to send current position
-    std::thread thrTcpServer;
     TCPConnection tcpPosSender;
-    volatile bool bStopTcp = false;
-    volatile bool thrTcpRunning = false;
     // current position which serves as center
     positionTy posCamera;
 
-    // udp thread and its sockets
-    std::thread thrUdpListener;
+    // udp sockets, served by NetEventLoop
     UDPReceiver udpTrafficData;
     UDPReceiver udpWeatherData;
-#if APL == 1 || LIN == 1
-    // the self-pipe to shut down the UDP listener thread gracefully
-    SOCKET udpPipe[2] = { INVALID_SOCKET, INVALID_SOCKET };
-#endif
-    volatile bool bStopUdp = false;
-    volatile bool thrUdpRunning = false;
     double lastReceivedTime     = 0.0;  // copy of simTime
     // map of last received datagrams for duplicate detection
     std::unordered_map<unsigned long,RTUDPDatagramTy> mapDatagrams;
+    // expiry schedule of mapDatagrams entries, guarded by rtMutex
+    TimingWheelTy<unsigned long> wheelDatagrams {AC_MAINT_WHEEL_RES};
     // weather, esp. current barometric pressure to correct altitude values
     double hPa = HPA_STANDARD;
     std::string lastWeather;            // for duplicate detection
@@ -186,18 +178,20 @@ protected:
     bool StopConnections ();
     
     // MARK: TCP
-    void tcpConnection ();
-    static void tcpConnectionS (RealTrafficConnection* me) { me->tcpConnection();}
+    /// Opens the TCP listener and registers it with NetEventLoop
+    void StartTcpConnection ();
+    /// Called by NetEventLoop when RealTraffic connects to the listener
+    void OnTcpAccept ();
     bool StopTcpConnection ();
 
     void SendPos (const positionTy& pos, double speed_m);
     void SendUsersPlanePos();
 
     // MARK: UDP
-    // UDP Listen: the main function for receiving UDP broadcasts
-    void udpListen ();
-    // just a wrapper to call a member function
-    static void udpListenS (RealTrafficConnection* me) { me->udpListen();}
+    /// Opens the UDP sockets and registers them with NetEventLoop
+    void StartUdpConnection ();
+    /// Called by NetEventLoop when a UDP datagram is available on `udp`
+    void OnUdpData (UDPReceiver& udp, bool bTraffic);
     bool StopUdpConnection ();
 
     // Process received datagrams
@@ -0,0 +1,103 @@
+/// @file       LTRegional.h
+/// @brief      Lightweight tracking of aircraft in the outer regional ring
+/// @details    With a regional distance configured beyond the standard search
+///             distance, channels query the larger area. Aircraft within the
+///             standard distance are tracked with full fidelity in `mapFd`
+///             as always. Aircraft in the ring outside of it only have their
+///             latest position and velocity kept in `mapRegional`: no position
+///             deque, no ground snapping, no LTAircraft object.\n
+///             Aircraft are promoted to `mapFd` as soon as data arrives that
+///             places them inside the standard distance. Aircraft flying out
+///             of it are removed from `mapFd` as before, and subsequent data
+///             is kept in `mapRegional` again.\n
+///             Regional aircraft are offered to map and LTAPI consumers via
+///             the `livetraffic/bulk/regional` dataRef.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#ifndef LTRegional_h
+#define LTRegional_h
+
+/// Latest known state of an aircraft in the outer regional ring
+struct LTRegionalAcTy {
+    double          lat     = NAN;      ///< [°] latitude
+    double          lon     = NAN;      ///< [°] longitude
+    double          alt_m   = NAN;      ///< [m] altitude, can be `NAN` on the ground
+    double          heading = NAN;      ///< [°] heading
+    double          spd     = NAN;      ///< [kt] ground speed
+    double          vsi     = NAN;      ///< [ft/min] vertical speed
+    double          ts      = NAN;      ///< [s since epoch] timestamp of the data
+    bool            gnd     = false;    ///< on ground?
+    std::string     call;               ///< call sign, if known
+    std::string     acTypeIcao;         ///< ICAO aircraft type, if known
+    const LTChannel* pChannel = nullptr;///< channel, which provided the data
+};
+
+/// Map of regional aircraft, keyed like `mapFd`
+typedef std::map<LTFlightData::FDKeyTy,LTRegionalAcTy> mapLTRegionalAcTy;
+
+/// @brief All aircraft tracked in the outer regional ring
+/// @note Access guarded by `mapRegionalMutex`, which is a lower-level lock than
+///       `mapFdMutex`: If both are needed then `mapFdMutex` must be locked first.
+extern mapLTRegionalAcTy mapRegional;
+/// Guards access to `mapRegional`
+extern std::mutex mapRegionalMutex;
+
+/// Is the regional mode active, ie. is the regional distance beyond the standard search distance?
+bool LTRegionalIsActive ();
+/// @brief Distance beyond which a fully tracked aircraft is demoted to the regional ring
+/// @details Standard distance plus `FD_REGIONAL_DEMOTE_MARGIN` if regional mode is active
+///          (so aircraft close to the boundary don't flip between full and regional tracking),
+///          just the standard distance otherwise
+double LTRegionalDemoteDist_m ();
+/// @brief Shall a position be tracked in the regional ring, ie. is it outside the standard search distance?
+/// @param bFull Is the aircraft currently tracked in full? Then it is only demoted beyond LTRegionalDemoteDist_m()
+/// @return always `false` if regional mode is inactive
+bool LTRegionalIsOuter (const positionTy& viewPos, double lat, double lon, bool bFull = false);
+
+/// @brief Stores the latest data of a regional aircraft, locks `mapRegionalMutex`
+/// @param key Aircraft's key
+/// @param stat Static data, only call sign and type are kept
+/// @param dyn Dynamic data, `nullptr` if the update carries static data only
+/// @param pos Position, only used if `dyn` is given
+/// @return Is the aircraft tracked regionally now?
+///         (Static-only updates are only accepted for known regional aircraft.)
+bool LTRegionalUpdate (const LTFlightData::FDKeyTy& key,
+                       const LTFlightData::FDStaticData& stat,
+                       const LTFlightData::FDDynamicData* dyn,
+                       const positionTy& pos);
+/// Removes an aircraft from the regional ring as it is promoted to full tracking, locks `mapRegionalMutex`
+void LTRegionalPromote (const LTFlightData::FDKeyTy& key);
+
+/// @brief Removes outdated regional aircraft and those outside the regional distance, main thread only
+/// @details Removes all regional aircraft if regional mode is inactive.
+void LTRegionalMaintenance ();
+/// Removes all regional aircraft
+void LTRegionalClear ();
+/// Number of regional aircraft
+int LTRegionalCount ();
+
+/// @brief Copies regional aircraft into LTAPI's bulk structure, main thread only
+/// @param pOut Output buffer
+/// @param startIdx 0-based index of first regional aircraft to copy
+/// @param num Number of aircraft to copy
+/// @param size Caller's size of one bulk data record
+/// @return Number of aircraft copied
+int LTRegionalCopyBulkData (char* pOut, int startIdx, int num, size_t size);
+
+#endif /* LTRegional_h */
@@ -0,0 +1,219 @@
+/// @file       LTSBS.h
+/// @brief      SBS: Receives live tracking data from a local ADS-B receiver in SBS-1/BaseStation format
+/// @see        http://woodair.net/sbs/article/barebones42_socket_data.htm
+/// @details    Defines RcvrConnection, the base for channels connected to a local receiver, and SBSConnection:\n
+///             - Keeps a TCP connection to a receiver like dump1090 (default port 30003)\n
+///             - Scans the received SBS lines in place, without copying them\n
+///             - Aggregates identity, velocity, and position messages per aircraft\n
+///             - Passes complete updates on to LTFlightData.\n
+///             For testing, any server replaying a recorded SBS stream
+///             on the configured port will do, e.g. `nc -lk 30003 < recording.sbs`.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#ifndef LTSBS_h
+#define LTSBS_h
+
+#include "LTChannel.h"
+#include "Network.h"
+
+//
+// MARK: SBS Constants
+//
+
+#define SBS_NAME                "SBS Receiver"
+
+// shared by all channels receiving a TCP data stream from a local receiver
+constexpr size_t RCVR_NET_BUF_SIZE      = 8192;     ///< receive buffer, must hold at least one complete line or frame
+constexpr std::chrono::milliseconds RCVR_CONNECT_TIMEOUT = std::chrono::milliseconds(2000); ///< max wait for a connection to establish
+constexpr std::chrono::seconds RCVR_RECONNECT_WAIT = std::chrono::seconds(10);  ///< wait before reconnecting
+constexpr std::chrono::milliseconds RCVR_COMMIT_INTVL = std::chrono::milliseconds(1000); ///< interval for committing updates to the flight data map
+constexpr double RCVR_MIN_POS_INTVL     = 1.0;      ///< [s] min time between two positions of the same aircraft passed on
+constexpr double RCVR_AC_OUTDATED       = 60.0;     ///< [s] aggregation state of aircraft not heard of for this long is removed
+
+#define MSG_RCVR_CONNECTED      "%s: Connected to %s:%d"
+#define MSG_RCVR_DISCONNECTED   "%s: Disconnected from %s:%d"
+#define ERR_RCVR_CONNECT        "%s: Cannot connect to %s:%d: %s (%s)"
+#define ERR_RCVR_CONNECT_TIMEOUT "%s: Cannot connect to %s:%d: Timeout"
+
+/// Message type in field 0 we are interested in
+#define SBS_MSG                 "MSG"
+
+/// Fields in an SBS line
+enum SBS_FIELDS_TY {
+    SBS_MSG_TYPE = 0,           ///< "MSG", "SEL", "ID", "AIR", "STA", "CLK"
+    SBS_TRANSM_TYPE,            ///< 1..8, see SBS_TRANSM_TY
+    SBS_SESSION_ID,
+    SBS_AIRCRAFT_ID,
+    SBS_HEX_IDENT,              ///< 24 bit ICAO transponder address in hex
+    SBS_FLIGHT_ID,
+    SBS_DATE_GEN,
+    SBS_TIME_GEN,
+    SBS_DATE_LOG,
+    SBS_TIME_LOG,
+    SBS_CALLSIGN,               ///< call sign (MSG,1)
+    SBS_ALT,                    ///< altitude in feet (Mode C)
+    SBS_GND_SPEED,              ///< ground speed in knots
+    SBS_TRACK,                  ///< true track
+    SBS_LAT,                    ///< latitude in degrees
+    SBS_LON,                    ///< longitude in degrees
+    SBS_VERT_RATE,              ///< vertical rate in ft/min
+    SBS_SQUAWK,                 ///< squawk code
+    SBS_ALERT,
+    SBS_EMERGENCY,
+    SBS_SPI,
+    SBS_ON_GROUND,              ///< on ground flag: -1 or 1 for true, 0 for false
+    SBS_NUM_FIELDS              ///< always last: number of fields
+};
+
+/// Transmission types of MSG lines
+enum SBS_TRANSM_TY {
+    SBS_TT_IDENT = 1,           ///< identification: call sign
+    SBS_TT_SURFACE_POS,         ///< surface position
+    SBS_TT_AIRB_POS,            ///< airborne position
+    SBS_TT_AIRB_VEL,            ///< airborne velocity
+    SBS_TT_SURV_ALT,            ///< surveillance altitude
+    SBS_TT_SURV_ID,             ///< surveillance id: squawk
+    SBS_TT_AIR_TO_AIR,          ///< air-to-air message
+    SBS_TT_ALL_CALL,            ///< all call reply
+};
+
+//
+// MARK: Receiver Connection (abstract base class)
+//
+
+/// @brief Base class for channels receiving a TCP data stream from a local receiver
+/// @details Registers a timer and the socket with NetEventLoop, which connect (and reconnect)
+///          to the receiver and receive data into `rcvBuf`. Derived classes decode the data in
+///          ProcessRcvBuf(), aggregate it per aircraft in `mapAcState`,
+///          and add complete updates by calling AddUpdate().
+///          These updates are committed once per RCVR_COMMIT_INTVL.
+class RcvrConnection : public LTOnlineChannel, LTFlightDataChannel
+{
+protected:
+    /// Aggregated state of one aircraft, collected from several partial messages
+    struct AcStateTy {
+        std::string call;               ///< call sign
+        long        squawk  = 0;        ///< squawk code
+        double      alt_ft  = NAN;      ///< last reported altitude
+        double      spd     = NAN;      ///< last reported ground speed [kn]
+        double      trk     = NAN;      ///< last reported true track
+        double      vsi     = NAN;      ///< last reported vertical rate [ft/min]
+        bool        gnd     = false;    ///< last reported on-ground status
+        double      lastPosTs = 0.0;    ///< timestamp of last position passed on
+        double      lastRcvd  = 0.0;    ///< timestamp of last message received
+    };
+
+    /// Map of aggregation states, key is the numeric ICAO transponder code
+    typedef std::unordered_map<unsigned long, AcStateTy> mapAcStateTy;
+
+protected:
+    /// the map of flight data, where we deliver our data to
+    mapLTFlightDataTy& fdMap;
+
+    // NetEventLoop registrations
+    unsigned timerId = 0;                   ///< timer for (re)connecting and committing
+    bool bConnecting = false;               ///< non-blocking connect in progress?
+    NetEventLoop::timePointTy connectDeadline;  ///< when to give up connecting
+    NetEventLoop::timePointTy nextConnect;  ///< don't try (re)connecting before this time
+
+    TCPClient tcpRcvr;                      ///< TCP connection to the receiver
+    std::string host;                       ///< receiver's host as used for the current connection
+    int port = 0;                           ///< receiver's port as used for the current connection
+    char rcvBuf[RCVR_NET_BUF_SIZE];         ///< receive buffer
+    size_t rcvLen = 0;                      ///< number of bytes in `rcvBuf`, which are not yet processed
+
+    std::mutex posMutex;                    ///< guards `posCamera`
+    positionTy posCamera;                   ///< current camera position, set by FetchAllData()
+
+    mapAcStateTy mapAcState;                ///< aggregation states per aircraft, only accessed by handlers
+    vecFDUpdateTy vecUpd;                   ///< complete updates not yet committed, only accessed by handlers
+    positionTy viewPos;                     ///< copy of `posCamera` used while processing, only accessed by handlers
+    std::string acFilter;                   ///< copy of debug a/c filter used while processing, only accessed by handlers
+
+public:
+    RcvrConnection (mapLTFlightDataTy& _fdMap);
+    virtual ~RcvrConnection ();
+
+    virtual std::string GetURL (const positionTy&) { return ""; }   // don't need URL, no request/reply
+    virtual bool IsLiveFeed() const { return true; }
+    virtual LTChannelType GetChType() const { return CHT_TRACKING_DATA; }
+
+    // interface called from LTChannel
+    virtual bool FetchAllData(const positionTy& pos);
+    virtual bool ProcessFetchedData (mapLTFlightDataTy&) { return true; }  // the timer commits data itself
+    virtual void DoDisabledProcessing();
+    virtual void Close ();
+
+protected:
+    /// Receiver's host name or address
+    virtual std::string GetHost () const = 0;
+    /// Receiver's port
+    virtual int GetPort () const = 0;
+
+    // Start/Stop
+    bool StartConnection ();
+    bool StopConnection ();
+
+    /// Timer handler: (re)connects if needed, commits updates regularly
+    NetEventLoop::timePointTy OnTimer ();
+    /// Starts connecting to the receiver
+    void Connect ();
+    /// Socket handler while connecting: finishes the connection
+    void OnConnectDone ();
+    /// Connection established: log and register for receiving
+    void OnConnected ();
+    /// Connection failed: log, count error, and wait before reconnecting
+    void OnConnectFailed (const NetRuntimeError& e);
+    /// Socket handler while connected: receives and processes data
+    void OnReceive ();
+    /// Unregisters and closes the socket, commits what we collected
+    void CloseRcvr ();
+
+    /// Processes all complete lines/frames in the receive buffer, keeps an incomplete rest
+    virtual void ProcessRcvBuf (double now) = 0;
+    /// Adds an update for the given aircraft to `vecUpd`
+    void AddUpdate (unsigned long numId, AcStateTy& ac, double lat, double lon, double now);
+    /// Commits collected updates, refreshes filter data, and removes outdated aggregation states
+    virtual void CommitAndCleanup (double now);
+    /// Refreshes `viewPos` and `acFilter`
+    void RefreshFilter ();
+};
+
+//
+// MARK: SBS Connection
+//
+class SBSConnection : public RcvrConnection
+{
+public:
+    SBSConnection (mapLTFlightDataTy& _fdMap);
+    virtual ~SBSConnection ();
+
+    virtual const char* ChName() const { return SBS_NAME; }
+
+protected:
+    virtual std::string GetHost () const;
+    virtual int GetPort () const;
+
+    /// Processes all complete lines in the receive buffer, keeps an incomplete rest
+    virtual void ProcessRcvBuf (double now);
+    /// Processes one SBS line, adds an update to `vecUpd` when a position is complete
+    void ProcessLine (std::string_view ln, double now);
+};
+
+#endif /* LTSBS_h */
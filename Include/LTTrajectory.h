@@ -0,0 +1,110 @@
+/// @file       LTTrajectory.h
+/// @brief      Debug: Records rendered trajectories and compares them with a golden recording
+/// @details    While `livetraffic/dbg/log_trajectory` is on, every position handed
+///             to X-Plane is written to LTTrajectory.log, one line per aircraft and frame.\n
+///             If LTTrajectory.golden.log exists when recording starts then each
+///             position is also compared with the golden trajectory of the same
+///             aircraft, interpolated at the same timestamp. Deviations beyond
+///             tolerances are counted and summarized when recording stops,
+///             together with the wall-clock time spent.\n
+///             The golden file is an earlier LTTrajectory.log, renamed by hand.
+///             Two runs are only comparable if both process the same input at
+///             the same sim times, e.g. historic data from a file channel with
+///             the virtual clock (`livetraffic/dbg/vclock/...`) advanced in the
+///             same steps. Deviations then point at changes in the position
+///             pipeline (cleansing, smoothing, taxiway snapping, CalcPPos).\n
+///             Recordings can also be compared outside X-Plane: The test
+///             program LTTrajectoryTest replays a recording against a golden
+///             file with the same functions (see Test/CMakeLists.txt).
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#ifndef LTTrajectory_h
+#define LTTrajectory_h
+
+//
+// MARK: Trajectory Constants
+//
+
+constexpr double TRJ_TOL_DIST_H     = 1.0;      ///< [m] tolerated horizontal deviation from golden trajectory
+constexpr double TRJ_TOL_DIST_V     = 0.5;      ///< [m] tolerated vertical deviation from golden trajectory
+constexpr double TRJ_TOL_ANGLE      = 1.0;      ///< [°] tolerated deviation of heading, pitch, roll from golden trajectory
+constexpr double TRJ_TOL_TS         = 0.001;    ///< [s] golden trajectory covers a timestamp up to this much outside its first/last position
+
+//
+// MARK: Golden Trajectories
+//
+
+/// One recorded position
+struct TrjPosTy {
+    double ts       = NAN;
+    double lat      = NAN;
+    double lon      = NAN;
+    double alt      = NAN;
+    double heading  = NAN;
+    double pitch    = NAN;
+    double roll     = NAN;
+};
+
+/// Trajectories per aircraft key, sorted by timestamp
+typedef std::map<std::string,std::vector<TrjPosTy>> mapTrjTy;
+
+/// Result of comparing positions with golden trajectories
+struct TrjCmpTy {
+    unsigned long   nCompared   = 0;    ///< positions compared with golden trajectory
+    unsigned long   nDeviating  = 0;    ///< compared positions outside tolerance
+    unsigned long   nUncovered  = 0;    ///< positions not covered by golden trajectory
+    double          maxDistH    = 0.0;  ///< [m] max horizontal deviation
+    double          maxDistV    = 0.0;  ///< [m] max vertical deviation
+    double          maxAngle    = 0.0;  ///< [°] max deviation of heading, pitch, roll
+};
+
+/// @brief Reads a trajectory file (a recording or a golden file)
+/// @param sFileName Path to the file
+/// @param[out] map Receives the trajectories, sorted by timestamp
+/// @return Number of positions read, 0 if the file cannot be read
+unsigned long LTTrajectoryRead (const std::string& sFileName, mapTrjTy& map);
+
+/// @brief Compares a position with the golden trajectory of the same aircraft, interpolated at the same timestamp
+/// @param golden Golden trajectories
+/// @param key Aircraft's key
+/// @param p Position to compare
+/// @param[in,out] cmp Statistics, which the result is added to
+void LTTrajectoryCompare (const mapTrjTy& golden, const std::string& key,
+                          const TrjPosTy& p, TrjCmpTy& cmp);
+
+//
+// MARK: Recording
+//
+
+/// Is recording active? Cheap check for the per-frame code path
+bool LTTrajectoryIsActive ();
+
+/// Starts recording, loads golden trajectories if available
+void LTTrajectoryStart ();
+
+/// Stops recording and logs a summary
+void LTTrajectoryStop ();
+
+/// @brief Records (and compares) an aircraft's current rendered position
+/// @param ac The aircraft
+/// @param calcTime Wall-clock time taken to calculate the position
+/// @note Call from X-Plane's main thread only
+void LTTrajectoryRecord (const LTAircraft& ac, std::chrono::steady_clock::duration calcTime);
+
+#endif /* LTTrajectory_h */
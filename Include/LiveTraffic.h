@@ -62,15 +62,20 @@
 
 // C++
 #include <utility>
+#include <array>
 #include <string>
 #include <map>
+#include <set>
 #include <unordered_map>
 #include <vector>
 #include <list>
 #include <deque>
 #include <thread>
+#include <mutex>
+#include <functional>
 #include <future>
 #include <algorithm>
+#include <numeric>
 #include <atomic>
 #include <chrono>
 #include <regex>
@@ -103,6 +108,7 @@
 
 // LiveTraffic Includes
 #include "Constants.h"
+#include "LTClock.h"
 #include "DataRefs.h"
 #include "CoordCalc.h"
 #include "TextIO.h"
@@ -113,12 +119,18 @@
 #include "ACInfoWnd.h"
 #include "XPCompatibility.h"
 #include "LTApt.h"
+#include "LTCpa.h"
+#include "LTTrajectory.h"
+#include "LTRegional.h"
 
 // LiveTraffic channels
 #include "Network.h"
 #include "LTChannel.h"
 #include "LTForeFlight.h"
 #include "LTRealTraffic.h"
+#include "LTSBS.h"
+#include "LTBeast.h"
+#include "LTMulticast.h"
 #include "LTOpenSky.h"
 #include "LTADSBEx.h"
 
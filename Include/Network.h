@@ -5,6 +5,9 @@
 /// @details    SocketNetworking: Any network socket connection\n
 ///             UDPReceiver: listens to and receives UDP datagram\n
 ///             TCPConnection: receives incoming TCP connection\n
+///             TCPClient: connects to a TCP server and receives its data stream\n
+///             UDPMulticast: sends to and receives from a UDP multicast group\n
+///             NetEventLoop: one thread waiting on all sockets and timers, dispatching to handlers\n
 /// @author     Birger Hoppe
 /// @copyright  (c) 2019-2020 Birger Hoppe
 /// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
@@ -160,4 +163,164 @@ protected:
     virtual void GetAddrHints (struct addrinfo& hints);
 };
 
+// Sends to/receives from a UDP multicast group
+
+class UDPMulticast : public UDPReceiver
+{
+protected:
+    struct sockaddr_in  f_group;            ///< multicast group to send to
+    std::string         f_groupAddr;        ///< multicast group to send to as text, for messages
+    
+public:
+    UDPMulticast() : UDPReceiver() { memset(&f_group, 0, sizeof(f_group)); }
+    
+    /// @brief Joins a multicast group to receive its datagrams, call after Open()
+    /// @exception NetRuntimeError if `_group` is not a valid IPv4 multicast address or joining fails
+    void JoinGroup (const std::string& _group);
+    
+    /// @brief Defines the multicast group to send to, call after Open()
+    /// @param _group Multicast group's IPv4 address
+    /// @param _port Port to send to
+    /// @param _ttl Number of router hops, 1 = local network only
+    /// @exception NetRuntimeError if `_group` is not a valid IPv4 address or options cannot be set
+    void SetSendGroup (const std::string& _group, int _port, int _ttl = 1);
+    
+    /// @brief Sends one datagram to the group defined by SetSendGroup()
+    bool SendToGroup (const void* data, size_t len);
+};
+
+// Connects to a TCP server
+
+class TCPClient : public SocketNetworking
+{
+public:
+    TCPClient() : SocketNetworking() {}
+    
+    /// @brief Connects to a TCP server
+    /// @param _addr Server's address or name
+    /// @param _port Server's port
+    /// @param _timeOut_ms Max time to wait for the connection to establish, 0 = system default
+    /// @exception NetRuntimeError if the connection cannot be established
+    void Connect (const std::string& _addr, int _port, unsigned _timeOut_ms = 0);
+    
+    /// @brief Starts connecting to a TCP server without waiting for the connection to establish
+    /// @details If `false` is returned, wait for the socket to become writable,
+    ///          then call ConnectComplete().
+    /// @return `true` if already connected, `false` if connection is in progress
+    /// @exception NetRuntimeError if the connection cannot be established
+    bool ConnectStart (const std::string& _addr, int _port);
+    
+    /// @brief Finishes a connection started by ConnectStart(), puts socket back into blocking mode
+    /// @exception NetRuntimeError if the connection failed
+    void ConnectComplete ();
+    
+    /// @brief Receives data into a buffer provided by the caller
+    /// @param pBuf Buffer to receive data into
+    /// @param len Available size of `pBuf`, no zero-termination is added
+    /// @param max_wait_ms Maximum time to wait for data
+    /// @return Number of bytes received, `0` if timed out, `-1` if an error occured or the server closed the connection
+    long timedRecvInto (char* pBuf, size_t len, int max_wait_ms);
+
+protected:
+    virtual void GetAddrHints (struct addrinfo& hints);
+};
+
+//
+// MARK: NetEventLoop
+//
+
+/// Max wait time [ms] of the event loop on platforms without a self-pipe (Windows),
+/// after which changes to the registered sockets take effect
+constexpr int NET_LOOP_MAX_WAIT_MS = 100;
+
+#define ERR_NET_LOOP_WAIT       "Network event loop: Waiting for sockets failed: %s"
+
+/// @brief A single thread, which waits for all registered sockets and timers
+///        and calls their handlers
+/// @details Uses `epoll` on Linux, `select` on other platforms.
+///          On Mac and Linux a self-pipe wakes up the thread when registrations change;
+///          on Windows it waits at most NET_LOOP_MAX_WAIT_MS.\n
+///          Handlers are called in the loop's thread while `loopMutex` is locked.
+///          They must return quickly and must not block on a socket.
+///          Registrations can be changed from any thread, including from within handlers.
+///          After RemoveSocket() or RemoveTimer() returned, the handler is no longer called.
+///          The thread is started with the first registration.
+class NetEventLoop
+{
+public:
+    /// handler called when the socket becomes readable (or writable, if registered for that)
+    typedef std::function<void()> sockHandlerTy;
+    /// time point type used for timers
+    typedef LTClock::time_point timePointTy;
+    /// handler called when the timer is due, returns next due time, or `timePointTy()` to remove the timer
+    typedef std::function<timePointTy()> timerHandlerTy;
+    
+protected:
+    /// a registered socket
+    struct SockTy {
+        sockHandlerTy   handler;            ///< called when ready
+        bool            bWrite = false;     ///< wait for writable instead of readable?
+    };
+    /// a registered timer
+    struct TimerTy {
+        timePointTy     due;                ///< when to call the handler next
+        timerHandlerTy  handler;            ///< called when due
+    };
+    
+    std::thread thrLoop;                    ///< the loop's thread
+    volatile bool bStopLoop = false;        ///< tells the loop to stop
+    std::recursive_mutex loopMutex;         ///< guards all registrations, locked while handlers execute
+    std::map<SOCKET,SockTy> mapSock;        ///< registered sockets
+    std::map<unsigned,TimerTy> mapTimer;    ///< registered timers, key is the timer's id
+    unsigned nextTimerId = 1;               ///< id of next timer to register
+    std::vector<SOCKET> vecReady;           ///< sockets found ready, only accessed by the loop's thread
+#if APL == 1 || LIN == 1
+    /// the self-pipe to wake up the loop
+    SOCKET wakePipe[2] = { INVALID_SOCKET, INVALID_SOCKET };
+#endif
+#if LIN == 1
+    int epollFd = -1;                       ///< the epoll instance
+#endif
+
+public:
+    NetEventLoop () {}
+    ~NetEventLoop ();
+    
+    /// The one global event loop
+    static NetEventLoop& Get ();
+    
+    /// @brief Registers a socket, replaces an existing registration of the same socket
+    /// @param s Socket to wait for
+    /// @param handler Called in the loop's thread when `s` becomes readable (or writable)
+    /// @param bWrite Wait for `s` becoming writable instead of readable, e.g. for a non-blocking connect
+    void AddSocket (SOCKET s, sockHandlerTy handler, bool bWrite = false);
+    /// Unregisters a socket, call before closing it
+    void RemoveSocket (SOCKET s);
+    /// @brief Registers a timer
+    /// @param due When to call `handler` first
+    /// @param handler Called in the loop's thread when due, returns next due time or `timePointTy()` to stop
+    /// @return Id of the timer, needed for RemoveTimer()
+    unsigned AddTimer (timePointTy due, timerHandlerTy handler);
+    /// Unregisters a timer, unknown ids are ignored
+    void RemoveTimer (unsigned id);
+    
+    /// Stops the loop's thread, keeps registrations (thread restarts with next registration)
+    void Stop ();
+    /// Lock this to synchronize with handlers, which don't run while it is locked
+    std::recursive_mutex& GetMutex () { return loopMutex; }
+    /// Is the calling thread the loop's thread?
+    bool IsLoopThread () const { return std::this_thread::get_id() == thrLoop.get_id(); }
+    
+protected:
+    /// Starts the thread if not yet running, `loopMutex` must be locked
+    void Start ();
+    /// Wakes up the waiting loop so that changed registrations take effect
+    void Wakeup ();
+    /// Waits for registered sockets for at most `timeout_ms` (-1 = indefinitely), fills `vecReady`
+    void Wait (int timeout_ms);
+    /// the thread's main function
+    void Loop ();
+    static void LoopS (NetEventLoop* me) { me->Loop(); }
+};
+
 #endif /* Network_h */
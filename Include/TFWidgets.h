@@ -216,6 +216,31 @@ public:
     { SetChecked(bChecked); return *this; }
 };
 
+//
+// TFCachedWidget: output field, which remembers what it displays
+//                 and calls X-Plane only if the displayed text changes
+//
+class TFCachedWidget : public TFWidget
+{
+protected:
+    char szText[64] = { 0 };    ///< text currently displayed
+    bool bNumValid  = false;    ///< `lastNum` and `lastDecimals` describe the current text?
+    long long lastNum = 0;      ///< last number displayed, scaled by 10^lastDecimals
+    int lastDecimals = 0;       ///< decimals of last number displayed
+public:
+    TFCachedWidget (XPWidgetID _me = NULL) : TFWidget(_me) {}
+    
+    /// Sets the text, calls X-Plane only if the text changed
+    void SetText (const char* s);
+    void SetText (const std::string& s) { SetText(s.c_str()); }
+    /// Shows a number, formats and calls X-Plane only if the value changed at display precision
+    void SetNumber (double d, int decimals = 0);
+    /// Formats like `printf` into a fixed buffer, calls X-Plane only if the text changed
+    void SetFormat (const char* fmt, ...);
+    /// Forgets the cached text, so that the next call updates the widget for sure
+    void Invalidate () { szText[0] = '\1'; szText[1] = 0; bNumValid = false; }
+};
+
 //
 // TFTextFieldWidget
 //
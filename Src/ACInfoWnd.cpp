@@ -365,6 +365,10 @@ widgetIds(nullptr)
     
     // value fields
     valSquawk.setId(widgetIds[ACI_TXT_SQUAWK]);
+    valDisplayedUsing.setId(widgetIds[ACI_TXT_DISPLAYED_USING]);
+    valSimTime.setId(widgetIds[ACI_TXT_SIM_TIME]);
+    valLastData.setId(widgetIds[ACI_TXT_LAST_DATA]);
+    valChannel.setId(widgetIds[ACI_TXT_CHNL]);
     valPos.setId(widgetIds[ACI_TXT_POS]);
     valBearing.setId(widgetIds[ACI_TXT_BEARING]);
     valDist.setId(widgetIds[ACI_TXT_DIST]);
@@ -726,8 +730,6 @@ void ACIWnd::UpdateDynValues()
     const LTAircraft* pAc = txtAcKey.GetAircraft();
 
     if (pAc) {
-        char szBuf[20];
-
         // _last_ dyn data object
         const LTFlightData& fd = pAc->fd;
         const LTFlightData::FDDynamicData dyn (fd.WaitForSafeCopyDyn(false));
@@ -736,43 +738,40 @@ void ACIWnd::UpdateDynValues()
         title = strAtMost(fd.ComposeLabel(), 25);
         
         // update all field values
+        // (cached widgets call X-Plane only if the displayed text actually changes)
         const positionTy& pos = pAc->GetPPos();
         double ts = dataRefs.GetSimTime();
-        valSquawk.SetDescriptor(dyn.GetSquawk());
-        XPSetWidgetDescriptor(widgetIds[ACI_TXT_DISPLAYED_USING],
-                              strAtMost(pAc->GetModelName(),25).c_str());
-        XPSetWidgetDescriptor(widgetIds[ACI_TXT_SIM_TIME], ts2string(time_t(ts)).c_str());
+        valSquawk.SetText(dyn.GetSquawk());
+        valDisplayedUsing.SetText(strAtMost(pAc->GetModelName(),25));
+        valSimTime.SetText(ts2string(time_t(ts)));
         // last update, relative to youngest timestamp for this plane
         ts -= fd.GetYoungestTS();
         ts *= -1;
         if (-10000 <= ts && ts <= 10000)
-        {
-            snprintf(szBuf,sizeof(szBuf),"%+.1f", ts);
-            XPSetWidgetDescriptor(widgetIds[ACI_TXT_LAST_DATA], szBuf);
-        }
+            valLastData.SetFormat("%+.1f", ts);
         else
-            XPSetWidgetDescriptor(widgetIds[ACI_TXT_LAST_DATA], "~");
+            valLastData.SetText("~");
         
-        XPSetWidgetDescriptor(widgetIds[ACI_TXT_CHNL],
-                              dyn.pChannel ? strAtMost(dyn.pChannel->ChName(), 15).c_str() : "");
-        valPos.SetDescriptor(pos);
-        valBearing.SetDescriptor(pAc->GetVecView().angle);
-        valDist.SetDescriptor(pAc->GetVecView().dist/M_per_NM, 1);
-        valPhase.SetDescriptor(pAc->GetFlightPhaseString());
-        valGear.SetDescriptor(pAc->GetGearPos(), 1);
-        valFlaps.SetDescriptor(pAc->GetFlapsPos(), 1);
-        valLights.SetDescriptor(pAc->GetLightsStr());
-        snprintf(szBuf,sizeof(szBuf),"%03.f", pos.heading());   // heading with 3 digits (leading zeros)
-        valHeading.SetDescriptor(szBuf);
-        valPitch.SetDescriptor(pAc->GetPitch());
-        valRoll.SetDescriptor(pAc->GetRoll());
-        valAlt.SetDescriptor(round(pos.alt_ft()));
+        valChannel.SetText(dyn.pChannel ? strAtMost(dyn.pChannel->ChName(), 15) : "");
+        valPos.SetFormat("%7.4f %c / %7.4f %c",         // same format as positionTy::operator std::string
+                         std::abs(pos.lat()), pos.lat() < 0 ? 'S' : 'N',
+                         std::abs(pos.lon()), pos.lon() < 0 ? 'W' : 'E');
+        valBearing.SetNumber(pAc->GetVecView().angle);
+        valDist.SetNumber(pAc->GetVecView().dist/M_per_NM, 1);
+        valPhase.SetText(pAc->GetFlightPhaseString());
+        valGear.SetNumber(pAc->GetGearPos(), 1);
+        valFlaps.SetNumber(pAc->GetFlapsPos(), 1);
+        valLights.SetText(pAc->GetLightsStr());
+        valHeading.SetFormat("%03.f", pos.heading());   // heading with 3 digits (leading zeros)
+        valPitch.SetNumber(pAc->GetPitch());
+        valRoll.SetNumber(pAc->GetRoll());
+        valAlt.SetNumber(pos.alt_ft());
         if (pos.IsOnGnd())
-            valAGL.SetDescriptor(positionTy::GrndE2String(positionTy::GND_ON));
+            valAGL.SetText(positionTy::GrndE2String(positionTy::GND_ON));
         else
-            valAGL.SetDescriptor(pAc->GetPHeight_ft());
-        valSpeed.SetDescriptor(pAc->GetSpeed_kt());
-        valVSI.SetDescriptor(pAc->GetVSI_ft());
+            valAGL.SetNumber(pAc->GetPHeight_ft());
+        valSpeed.SetNumber(pAc->GetSpeed_kt());
+        valVSI.SetNumber(pAc->GetVSI_ft());
         
         // visibility buttons
         btnCamera = pAc->IsInCameraView();
@@ -784,14 +783,14 @@ void ACIWnd::UpdateDynValues()
     } else {
         // no current a/c
         // clear all values
-        for (int i: {
-            ACI_TXT_SQUAWK, ACI_TXT_DISPLAYED_USING, ACI_TXT_SIM_TIME,
-            ACI_TXT_LAST_DATA, ACI_TXT_CHNL, ACI_TXT_POS, ACI_TXT_BEARING,
-            ACI_TXT_DIST, ACI_TXT_PHASE, ACI_TXT_GEAR, ACI_TXT_FLAPS,
-            ACI_TXT_LIGHTS, ACI_TXT_HEADING, ACI_TXT_PITCH, ACI_TXT_ROLL,
-            ACI_TXT_ALT, ACI_TXT_AGL, ACI_TXT_SPEED, ACI_TXT_VSI
+        for (TFCachedWidget* pW: {
+            &valSquawk, &valDisplayedUsing, &valSimTime,
+            &valLastData, &valChannel, &valPos, &valBearing,
+            &valDist, &valPhase, &valGear, &valFlaps,
+            &valLights, &valHeading, &valPitch, &valRoll,
+            &valAlt, &valAGL, &valSpeed, &valVSI
         })
-            XPSetWidgetDescriptor(widgetIds[i], "");
+            pW->SetText("");
 
         btnCamera = false;
         btnVisible = false;
@@ -800,5 +799,8 @@ void ACIWnd::UpdateDynValues()
     
     if (btnAuto)
         title += " (" INFO_WND_AUTO_AC ")";
-    SetDescriptor(title);
+    if (title != lastTitle) {
+        SetDescriptor(title);
+        lastTitle = title;
+    }
 }
@@ -95,7 +95,8 @@ positionTy CoordPlusVector (const positionTy& p, const vectorTy& vec)
     
     using namespace std;
     positionTy ret(pos);        // init with pos=p to save other values
-    ret.mergeCount = 1;         // only reset merge count
+    ret.mergeCount = 1;         // only reset merge count...
+    ret.terrainAlt = NAN;       // ...and terrain, which needs to be probed again at the new location
     
     // altitude changes by: vsi * flight-time
     // timestamp changes by:      flight-time
@@ -241,11 +242,20 @@ positionTy& positionTy::operator |= (const positionTy& pos)
     if (!flightPhase)
         flightPhase = pos.flightPhase;
     
+    // latency is determined by the earliest receipt
+    if (std::isnan(rcvTs) || pos.rcvTs < rcvTs) {
+        rcvTs = pos.rcvTs;
+        rcvCh = pos.rcvCh;
+    }
+    
     // ground status: if different, then the new one is likely off ground,
     //                but we have it determined soon
     if (onGrnd != pos.onGrnd)
         onGrnd = GND_UNKNOWN;       // IsOnGnd() will return false for this!
     
+    // we moved, so terrain needs to be probed again
+    terrainAlt = NAN;
+    
     return normalize();
 }
 
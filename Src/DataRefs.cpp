@@ -383,10 +383,38 @@ DataRefs::dataRefDefinitionT DATA_REFS_LT[CNT_DATAREFS_LT] = {
     
     {"livetraffic/bulk/quick",                      DataRefs::LTGetBulkAc,  NULL,                   (void*)DR_AC_BULK_QUICK, false },
     {"livetraffic/bulk/expensive",                  DataRefs::LTGetBulkAc,  NULL,                   (void*)DR_AC_BULK_EXPENSIVE, false },
+    {"livetraffic/bulk/regional",                   DataRefs::LTGetBulkAc,  NULL,                   (void*)DR_AC_BULK_REGIONAL, false },
+    {"livetraffic/regional/num",                    DataRefs::LTGetAcInfoI, NULL,                   (void*)DR_AC_REGIONAL_NUM, false },
 
     {"livetraffic/sim/date",                        DataRefs::LTGetSimDateTime, DataRefs::LTSetSimDateTime, (void*)1, false },
     {"livetraffic/sim/time",                        DataRefs::LTGetSimDateTime, DataRefs::LTSetSimDateTime, (void*)2, false },
 
+    {"livetraffic/stats/latency/rcv_disp_avg",      DataRefs::LTGetLatency, NULL,                   (void*)DR_STATS_LAT_RCV_DISP_AVG, false },
+    {"livetraffic/stats/latency/rcv_disp_p95",      DataRefs::LTGetLatency, NULL,                   (void*)DR_STATS_LAT_RCV_DISP_P95, false },
+    {"livetraffic/stats/latency/disp_delay_avg",    DataRefs::LTGetLatency, NULL,                   (void*)DR_STATS_LAT_DISP_DELAY_AVG, false },
+    {"livetraffic/stats/latency/disp_delay_p95",    DataRefs::LTGetLatency, NULL,                   (void*)DR_STATS_LAT_DISP_DELAY_P95, false },
+    {"livetraffic/stats/commit/cnt",                DataRefs::LTGetCommitStat, NULL,                (void*)DR_STATS_COMMIT_CNT, false },
+    {"livetraffic/stats/commit/lock_ms_max",        DataRefs::LTGetCommitStat, NULL,                (void*)DR_STATS_COMMIT_LOCK_MS, false },
+    {"livetraffic/stats/mem/flight_data",           DataRefs::LTGetMemUsage, NULL,                  (void*)DR_STATS_MEM_FLIGHT_DATA, false },
+    {"livetraffic/stats/mem/pos_buf",               DataRefs::LTGetMemUsage, NULL,                  (void*)DR_STATS_MEM_POS_BUF, false },
+    {"livetraffic/stats/mem/airports",              DataRefs::LTGetMemUsage, NULL,                  (void*)DR_STATS_MEM_AIRPORTS, false },
+    {"livetraffic/stats/mem/master_data",           DataRefs::LTGetMemUsage, NULL,                  (void*)DR_STATS_MEM_MASTER_DATA, false },
+    {"livetraffic/stats/mem/raw_buf",               DataRefs::LTGetMemUsage, NULL,                  (void*)DR_STATS_MEM_RAW_BUF, false },
+    {"livetraffic/stats/mem/total",                 DataRefs::LTGetMemUsage, NULL,                  (void*)DR_STATS_MEM_TOTAL, false },
+    {"livetraffic/cpa/num_threats",                 DataRefs::LTGetCpaInt, NULL,                    (void*)DR_CPA_NUM_THREATS, false },
+    {"livetraffic/cpa/threat1/key",                 DataRefs::LTGetCpaInt, NULL,                    (void*)DR_CPA_THREAT1_KEY, false },
+    {"livetraffic/cpa/threat1/time",                DataRefs::LTGetCpa, NULL,                       (void*)DR_CPA_THREAT1_TIME, false },
+    {"livetraffic/cpa/threat1/dist",                DataRefs::LTGetCpa, NULL,                       (void*)DR_CPA_THREAT1_DIST, false },
+    {"livetraffic/cpa/threat1/vsep",                DataRefs::LTGetCpa, NULL,                       (void*)DR_CPA_THREAT1_VSEP, false },
+    {"livetraffic/cpa/threat2/key",                 DataRefs::LTGetCpaInt, NULL,                    (void*)DR_CPA_THREAT2_KEY, false },
+    {"livetraffic/cpa/threat2/time",                DataRefs::LTGetCpa, NULL,                       (void*)DR_CPA_THREAT2_TIME, false },
+    {"livetraffic/cpa/threat2/dist",                DataRefs::LTGetCpa, NULL,                       (void*)DR_CPA_THREAT2_DIST, false },
+    {"livetraffic/cpa/threat2/vsep",                DataRefs::LTGetCpa, NULL,                       (void*)DR_CPA_THREAT2_VSEP, false },
+    {"livetraffic/cpa/threat3/key",                 DataRefs::LTGetCpaInt, NULL,                    (void*)DR_CPA_THREAT3_KEY, false },
+    {"livetraffic/cpa/threat3/time",                DataRefs::LTGetCpa, NULL,                       (void*)DR_CPA_THREAT3_TIME, false },
+    {"livetraffic/cpa/threat3/dist",                DataRefs::LTGetCpa, NULL,                       (void*)DR_CPA_THREAT3_DIST, false },
+    {"livetraffic/cpa/threat3/vsep",                DataRefs::LTGetCpa, NULL,                       (void*)DR_CPA_THREAT3_VSEP, false },
+
     // configuration options
     {"livetraffic/cfg/aircrafts_displayed",         DataRefs::LTGetInt, DataRefs::LTSetAircraftDisplayed, GET_VAR, false },
     {"livetraffic/cfg/auto_start",                  DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
@@ -403,7 +431,10 @@ DataRefs::dataRefDefinitionT DATA_REFS_LT[CNT_DATAREFS_LT] = {
     {"livetraffic/cfg/max_full_num_ac",             DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/full_distance",               DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/fd_std_distance",             DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/fd_regional_distance",        DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/fd_snap_taxi_dist",           DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/fd_tile_grid",                DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/fd_mem_budget",               DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/fd_refresh_intvl",            DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/fd_buf_period",               DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/ac_outdated_intvl",           DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
@@ -411,6 +442,11 @@ DataRefs::dataRefDefinitionT DATA_REFS_LT[CNT_DATAREFS_LT] = {
     {"livetraffic/cfg/lnd_lights_taxi",             DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/hide_below_agl",              DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/hide_taxiing",                DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/ac_task/radar",               DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/ac_task/surfaces",            DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/ac_task/info_texts",          DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/ac_task/ai_prio",             DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/ac_task/label",               DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/dr_libxplanemp",              DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/last_check_new_ver",          DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
 
@@ -419,6 +455,9 @@ DataRefs::dataRefDefinitionT DATA_REFS_LT[CNT_DATAREFS_LT] = {
     {"livetraffic/dbg/ac_pos",                      DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/dbg/log_raw_fd",                  DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, false },
     {"livetraffic/dbg/model_matching",              DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
+    {"livetraffic/dbg/log_trajectory",              DataRefs::LTGetInt, DataRefs::LTSetDebugLogTrajectory, GET_VAR, false },
+    {"livetraffic/dbg/vclock/enabled",              DataRefs::LTGetVClock, DataRefs::LTSetVClock,   (void*)DR_DBG_VCLOCK, false },
+    {"livetraffic/dbg/vclock/advance_ms",           DataRefs::LTGetVClock, DataRefs::LTSetVClock,   (void*)DR_DBG_VCLOCK_ADVANCE, false },
     
     // channel configuration options
     {"livetraffic/channel/real_traffic/listen_port",DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
@@ -428,16 +467,23 @@ DataRefs::dataRefDefinitionT DATA_REFS_LT[CNT_DATAREFS_LT] = {
     {"livetraffic/channel/fore_flight/user_plane",  DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/fore_flight/traffic",     DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/fore_flight/interval",    DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/channel/sbs/port",                DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/channel/beast/port",              DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/channel/multicast/port",          DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
 
     // channels, in ascending order of priority
     {"livetraffic/channel/futuredatachn/online",    DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, false },
     {"livetraffic/channel/fore_flight/sender",      DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
+    {"livetraffic/channel/multicast/sender",        DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/open_glider/online",      DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/adsb_exchange/online",    DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/adsb_exchange/historic",  DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, false },
     {"livetraffic/channel/open_sky/online",         DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/open_sky/ac_masterdata",  DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/real_traffic/online",     DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
+    {"livetraffic/channel/sbs/online",              DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
+    {"livetraffic/channel/beast/online",            DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
+    {"livetraffic/channel/multicast/receiver",      DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
 };
 
 // returns the actual address of the variable within DataRefs, which stores the value of interest as per dataRef definition
@@ -460,7 +506,10 @@ void* DataRefs::getVarAddr (dataRefsLT dr)
         case DR_CFG_MAX_FULL_NUM_AC:        return &maxFullNumAc;
         case DR_CFG_FULL_DISTANCE:          return &fullDistance;
         case DR_CFG_FD_STD_DISTANCE:        return &fdStdDistance;
+        case DR_CFG_FD_REGIONAL_DISTANCE:   return &fdRegionalDistance;
         case DR_CFG_FD_SNAP_TAXI_DIST:      return &fdSnapTaxiDist;
+        case DR_CFG_FD_TILE_GRID:           return &fdTileGrid;
+        case DR_CFG_FD_MEM_BUDGET:          return &fdMemBudget;
         case DR_CFG_FD_REFRESH_INTVL:       return &fdRefreshIntvl;
         case DR_CFG_FD_BUF_PERIOD:          return &fdBufPeriod;
         case DR_CFG_AC_OUTDATED_INTVL:      return &acOutdatedIntvl;
@@ -468,6 +517,11 @@ void* DataRefs::getVarAddr (dataRefsLT dr)
         case DR_CFG_LND_LIGHTS_TAXI:        return &bLndLightsTaxi;
         case DR_CFG_HIDE_BELOW_AGL:         return &hideBelowAGL;
         case DR_CFG_HIDE_TAXIING:           return &hideTaxiing;
+        case DR_CFG_AC_TASK_RADAR:          return &acTaskPeriod[0];
+        case DR_CFG_AC_TASK_SURFACES:       return &acTaskPeriod[1];
+        case DR_CFG_AC_TASK_INFO_TEXTS:     return &acTaskPeriod[2];
+        case DR_CFG_AC_TASK_AI_PRIO:        return &acTaskPeriod[3];
+        case DR_CFG_AC_TASK_LABEL:          return &acTaskPeriod[4];
         case DR_CFG_DR_LIBXPLANEMP:         return &drLibXplaneMP;
         case DR_CFG_LAST_CHECK_NEW_VER:     return &lastCheckNewVer;
 
@@ -476,6 +530,7 @@ void* DataRefs::getVarAddr (dataRefsLT dr)
         case DR_DBG_AC_POS:                 return &bDebugAcPos;
         case DR_DBG_LOG_RAW_FD:             return &bDebugLogRawFd;
         case DR_DBG_MODEL_MATCHING:         return &bDebugModelMatching;
+        case DR_DBG_LOG_TRAJECTORY:         return &bDebugLogTrajectory;
             
         // channel configuration options
         case DR_CFG_RT_LISTEN_PORT:         return &rtListenPort;
@@ -485,6 +540,9 @@ void* DataRefs::getVarAddr (dataRefsLT dr)
         case DR_CFG_FF_SEND_USER_PLANE:     return &bffUserPlane;
         case DR_CFG_FF_SEND_TRAFFIC:        return &bffTraffic;
         case DR_CFG_FF_SEND_TRAFFIC_INTVL:  return &ffSendTrfcIntvl;
+        case DR_CFG_SBS_PORT:               return &sbsPort;
+        case DR_CFG_BEAST_PORT:             return &beastPort;
+        case DR_CFG_MC_PORT:                return &mcPort;
 
         default:
             // flight channels
@@ -828,6 +886,10 @@ void    DataRefs::LTSetBool(void* p, int i)
 {
     *reinterpret_cast<int*>(p) = i != 0;
     
+    // a channel switched on/off?
+    if (std::begin(dataRefs.bChannel) <= p && p < std::end(dataRefs.bChannel))
+        dataRefs.AddCfgChange(CFG_CHG_CHANNELS);
+    
     // also enable OpenSky Master data if OpenSky tracking data is now enabled
     if (((p == &dataRefs.bChannel[DR_CHANNEL_OPEN_SKY_ONLINE - DR_CHANNEL_FIRST]) && i) ||
         // override OpenSky Master if OpenSky tracking active
@@ -841,7 +903,7 @@ void    DataRefs::LTSetBool(void* p, int i)
 //
 
 /// @brief Bulk data access to transfer a lot of a/c info to LTAPI
-/// @param inRefcon DR_AC_BULK_QUICK or DR_AC_BULK_EXPENSIVE
+/// @param inRefcon DR_AC_BULK_QUICK, DR_AC_BULK_EXPENSIVE, or DR_AC_BULK_REGIONAL
 /// @param[out] outData Points to buffer provided by caller, can be NULL to "negotiate" struct size
 /// @param inStartPos array position to start with, multiple of agreed struct size
 /// @param inNumBytes Number of byte to copy, multiple of agreed struct size / or caller's struct size during "negotiation"
@@ -862,16 +924,19 @@ int DataRefs::LTGetBulkAc (void* inRefcon, void * outData,
 {
     // quick or expensive one?
     dataRefsLT dr = (dataRefsLT)reinterpret_cast<long long>(inRefcon);
-    LOG_ASSERT(dr == DR_AC_BULK_QUICK || dr == DR_AC_BULK_EXPENSIVE);
+    LOG_ASSERT(dr == DR_AC_BULK_QUICK || dr == DR_AC_BULK_EXPENSIVE || dr == DR_AC_BULK_REGIONAL);
 
     // "Negotiation": In case of version differences between calling app
     // and LiveTraffic we need to be conscious of the callers struct size.
-    static int size_quick = 0, size_expensive = 0;
+    static int size_quick = 0, size_expensive = 0, size_regional = 0;
     if (!outData)
     {
         if (dr == DR_AC_BULK_QUICK) {
             size_quick = inNumBytes;
             return (int)sizeof(LTAPIAircraft::LTAPIBulkData);
+        } else if (dr == DR_AC_BULK_REGIONAL) {
+            size_regional = inNumBytes;
+            return (int)sizeof(LTAPIAircraft::LTAPIBulkData);
         } else {
             size_expensive = inNumBytes;
             return (int)sizeof(LTAPIAircraft::LTAPIBulkInfoTexts);
@@ -880,7 +945,8 @@ int DataRefs::LTGetBulkAc (void* inRefcon, void * outData,
     
     // Validations before starting normal operations
     // Size must have been negotiated first
-    int size = dr == DR_AC_BULK_QUICK ? size_quick : size_expensive;
+    int size = dr == DR_AC_BULK_QUICK ? size_quick :
+               dr == DR_AC_BULK_REGIONAL ? size_regional : size_expensive;
     if (!size) return 0;
 
     // Positions / copy size must both be multiples of agreed size
@@ -891,6 +957,11 @@ int DataRefs::LTGetBulkAc (void* inRefcon, void * outData,
         (inNumBytes % size != 0))
         return 0;
     
+    // Regional aircraft only have quick data, kept separately from mapFd
+    if (dr == DR_AC_BULK_REGIONAL)
+        return size * LTRegionalCopyBulkData((char*)outData, inStartPos / size,
+                                             inNumBytes / size, size_t(size));
+    
     // Normal operation: loop over requested a/c
     const int startAc = 1 + inStartPos / size;      // first a/c index (1-based)
     const int endAc = startAc + (inNumBytes / size);// last+1 a/c index (passed-the-end)
@@ -994,6 +1065,7 @@ int DataRefs::LTGetAcInfoI(void* p)
     // don't need an a/c pointer for this one:
     switch ( reinterpret_cast<long long>(p) ) {
         case DR_AC_NUM: return dataRefs.cntAc;
+        case DR_AC_REGIONAL_NUM: return LTRegionalCount();
     }
 
     // verify a/c ptr is available
@@ -1111,12 +1183,9 @@ double DataRefs::GetSimTime() const
     {
         // we use current system time (no matter what X-Plane simulates),
         // but lagging behind by the buffering time
-        using namespace std::chrono;
         return
-            // system time in microseconds
-            double(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count())
-            // divided by 1000000 to create seconds with fractionals
-            / 1000000.0
+            // system time in seconds
+            LTClock::SysNow()
             // minus the buffering time
             - GetFdBufPeriod()
             // plus the offset compared to network (this corrects for wrong system clock time as compared to reality)
@@ -1199,6 +1268,68 @@ int DataRefs::LTGetSimDateTime(void* p)
     }
 }
 
+// latency statistics of all channels, 0 if nothing measured yet
+float DataRefs::LTGetLatency(void* p)
+{
+    const LatencyStatTy& st = LTLatencyGet();
+    double d = NAN;
+    switch ( reinterpret_cast<long long>(p) ) {
+        case DR_STATS_LAT_RCV_DISP_AVG:     d = st.rcvDisp.Avg(); break;
+        case DR_STATS_LAT_RCV_DISP_P95:     d = st.rcvDisp.Percentile(0.95); break;
+        case DR_STATS_LAT_DISP_DELAY_AVG:   d = st.dispDelay.Avg(); break;
+        case DR_STATS_LAT_DISP_DELAY_P95:   d = st.dispDelay.Percentile(0.95); break;
+    }
+    return std::isnan(d) ? 0.0f : float(d);
+}
+
+// statistics of all channels' last commit of updates
+float DataRefs::LTGetCommitStat(void* p)
+{
+    size_t cnt = 0;
+    double lock_ms = 0.0;
+    LTCommitStatGet(cnt, lock_ms);
+    if (reinterpret_cast<long long>(p) == DR_STATS_COMMIT_CNT)
+        return float(cnt);
+    return float(lock_ms);
+}
+
+// estimated memory usage in KB
+int DataRefs::LTGetMemUsage(void* p)
+{
+    const long long dr = reinterpret_cast<long long>(p);
+    return int(LTMemUsage(LTMemSubsysTy(dr - DR_STATS_MEM_FLIGHT_DATA)) / 1024);
+}
+
+// number of top threats and their keys
+int DataRefs::LTGetCpaInt(void* p)
+{
+    const long long dr = reinterpret_cast<long long>(p);
+    const vecCpaTy vecThreats = LTCpaGetThreats();
+    if (dr == DR_CPA_NUM_THREATS)
+        return int(vecThreats.size());
+    static_assert(DR_CPA_THREAT1_KEY + 4 * CPA_NUM_THREATS == DR_CPA_THREAT3_VSEP + 1,
+                  "livetraffic/cpa/... dataRefs and CPA_NUM_THREATS out of sync");
+    const size_t idx = size_t(dr - DR_CPA_THREAT1_KEY) / 4;
+    return idx < vecThreats.size() ? int(vecThreats[idx].key.num) : 0;
+}
+
+// time, distance, and vertical separation of top threats, 0 if no such threat
+float DataRefs::LTGetCpa(void* p)
+{
+    const long long dr = reinterpret_cast<long long>(p) - DR_CPA_THREAT1_KEY;
+    const vecCpaTy vecThreats = LTCpaGetThreats();
+    const size_t idx = size_t(dr / 4);
+    if (idx >= vecThreats.size())
+        return 0.0f;
+    const CpaTy& cpa = vecThreats[idx];
+    switch (dr % 4) {
+        case 1:     return float(cpa.tCpa);
+        case 2:     return float(cpa.distH);
+        case 3:     return float(cpa.distV);
+        default:    return 0.0f;
+    }
+}
+
 // Enable/Disable display of aircraft
 void DataRefs::LTSetAircraftDisplayed(void*, int i)
 { dataRefs.SetAircraftDisplayed (i); }
@@ -1273,27 +1404,25 @@ bool DataRefs::SetUseHistData (bool bUseHistData, bool bForceReload)
     }
     
     // if we change this setting while running
-    // we 'simulate' a re-initialization
+    // we need to start over with all flight data,
+    // but libxplanemp and its loaded CSL models stay
     if (pluginState >= STATE_ENABLED) {
         // remove all existing aircraft
         bool bShowAc = dataRefs.AreAircraftDisplayed();
         dataRefs.SetAircraftDisplayed(false);
 
-        // disable myself / stop all connections
-        LTMainDisable();
-        
-        // Now set the new setting
-        dataRefs.bUseHistoricData = bUseHistData;
-        
-        // create the connections to flight data
-        if ( LTMainEnable() ) {
-            // display aircraft (if that was the case previously)
-            dataRefs.SetAircraftDisplayed(bShowAc);
-            return true;
-        }
-        else {
-            return false;
+        // switching between live and historic data requires other connections,
+        // a forced reload (e.g. re-init after time jump) starts over with all flight data
+        if (bForceReload || dataRefs.bUseHistoricData != (int)bUseHistData) {
+            LTFlightDataDisable();
+            dataRefs.bUseHistoricData = bUseHistData;
+            if (!LTFlightDataEnable())
+                return false;
         }
+        
+        // display aircraft (if that was the case previously)
+        dataRefs.SetAircraftDisplayed(bShowAc);
+        return true;
     }
     else {
         // not yet running, i.e. init phase: just set the value
@@ -1319,6 +1448,9 @@ bool DataRefs::SetCfgValue (void* p, int val)
         maxFullNumAc    < 5                 || maxFullNumAc     > 100   ||
         fullDistance    < 1                 || fullDistance     > 100   ||
         fdStdDistance   < 5                 || fdStdDistance    > 100   ||
+        fdRegionalDistance < 0              || fdRegionalDistance > FD_MAX_REGIONAL_DIST ||
+        fdTileGrid      < 1                 || fdTileGrid       > FD_MAX_TILE_GRID ||
+        fdMemBudget     < 0                 || fdMemBudget      > 16384 ||
         fdRefreshIntvl  < 10                || fdRefreshIntvl   > 5*60  ||
         fdBufPeriod     < fdRefreshIntvl    || fdBufPeriod      > 5*60  ||
         acOutdatedIntvl < 2*fdRefreshIntvl  || acOutdatedIntvl  > 5*60  ||
@@ -1327,7 +1459,12 @@ bool DataRefs::SetCfgValue (void* p, int val)
         rtListenPort    < 1024              || rtListenPort     > 65535 ||
         rtTrafficPort   < 1024              || rtTrafficPort    > 65535 ||
         rtWeatherPort   < 1024              || rtWeatherPort    > 65535 ||
-        ffSendPort      < 1024              || ffSendPort       > 65535
+        ffSendPort      < 1024              || ffSendPort       > 65535 ||
+        sbsPort         < 1024              || sbsPort          > 65535 ||
+        beastPort       < 1024              || beastPort        > 65535 ||
+        mcPort          < 1024              || mcPort           > 65535 ||
+        std::any_of(std::begin(acTaskPeriod), std::end(acTaskPeriod),
+                    [](int per){ return per < 1 || per > AC_TASK_PERIOD_MAX; })
         )
     {
         // undo change
@@ -1335,6 +1472,10 @@ bool DataRefs::SetCfgValue (void* p, int val)
         return false;
     }
     
+    // search radii changed?
+    if ((p == &fdStdDistance || p == &fdRegionalDistance) && val != oldVal)
+        AddCfgChange(CFG_CHG_RADIUS);
+    
     // success
     return true;
 }
@@ -1407,6 +1548,8 @@ void DataRefs::LTSetDebugAcFilter( void* /*inRefcon*/, int i )
     
     // match hex range of transpIcao codes
     if ( 0x000000 <= i && (unsigned)i <= MAX_TRANSP_ICAO ) {
+        if (dataRefs.uDebugAcFilter != unsigned(i))
+            dataRefs.AddCfgChange(CFG_CHG_AC_FILTER);
         dataRefs.uDebugAcFilter = unsigned(i);
         
         // also set the key for the a/c info datarefs
@@ -1420,6 +1563,38 @@ void DataRefs::LTSetDebugAcFilter( void* /*inRefcon*/, int i )
     }
 }
 
+// starts/stops recording trajectories
+void DataRefs::LTSetDebugLogTrajectory (void* p, int i)
+{
+    LTSetBool(p, i);
+    if (dataRefs.GetDebugLogTrajectory())
+        LTTrajectoryStart();
+    else
+        LTTrajectoryStop();
+}
+
+// virtual clock: enabled?
+int DataRefs::LTGetVClock (void* p)
+{
+    return (dataRefsLT)reinterpret_cast<long long>(p) == DR_DBG_VCLOCK ?
+        int(LTClock::IsVirtual()) : 0;
+}
+
+// virtual clock: switch on/off or advance time
+void DataRefs::LTSetVClock (void* p, int i)
+{
+    switch ((dataRefsLT)reinterpret_cast<long long>(p)) {
+        case DR_DBG_VCLOCK:
+            LTClock::SetVirtual(i != 0);
+            break;
+        case DR_DBG_VCLOCK_ADVANCE:
+            LTClock::Advance(std::chrono::milliseconds(i));
+            break;
+        default:
+            break;
+    }
+}
+
 //
 // MARK: DataRefs::dataRefDefinitionT
 //
@@ -1631,6 +1806,16 @@ bool DataRefs::LoadConfigFile()
                 dataRefs.SetDefaultCarIcaoType(sVal);
             else if (sDataRef == CFG_ADSBEX_API_KEY)
                 dataRefs.SetADSBExAPIKey(sVal);
+            else if (sDataRef == CFG_SBS_HOST)
+                dataRefs.SetSBSHost(sVal);
+            else if (sDataRef == CFG_BEAST_HOST)
+                dataRefs.SetBeastHost(sVal);
+            else if (sDataRef == CFG_MC_GROUP)
+                dataRefs.SetMCGroup(sVal);
+            // *** Network time offset per channel ***
+            else if (begins_with<std::string>(sDataRef, CFG_TS_SKEW) &&
+                     ChTsSkewFromConfig(sDataRef, sVal))
+            {}
             else
             {
                 // unknown config entry, ignore
@@ -1730,6 +1915,15 @@ bool DataRefs::SaveConfigFile()
     fOut << CFG_DEFAULT_CAR_TYPE << ' ' << dataRefs.GetDefaultCarIcaoType() << '\n';
     if (!dataRefs.GetADSBExAPIKey().empty())
         fOut << CFG_ADSBEX_API_KEY << ' ' << dataRefs.GetADSBExAPIKey() << '\n';
+    fOut << CFG_SBS_HOST << ' ' << dataRefs.GetSBSHost() << '\n';
+    fOut << CFG_BEAST_HOST << ' ' << dataRefs.GetBeastHost() << '\n';
+    fOut << CFG_MC_GROUP << ' ' << dataRefs.GetMCGroup() << '\n';
+    
+    // *** Network time offset per channel ***
+    for (int ch = DR_CHANNEL_FIRST; ch <= DR_CHANNEL_LAST; ch++)
+        if (chTsSkew[ch - DR_CHANNEL_FIRST].IsValid())
+            fOut << CFG_TS_SKEW << DATA_REFS_LT[ch].getDataNameStr() << ' '
+                 << chTsSkew[ch - DR_CHANNEL_FIRST].GetConfigString() << '\n';
 
     // *** [CSLPatchs] ***
     // add section of CSL paths to the end
@@ -1845,29 +2039,145 @@ int DataRefs::CntChannelEnabled () const
                            1);
 }
 
-// add another offset to the offset calculation (network time vs. system clock)
-// This is just a simple average calculation, not caring too much about rounding issues
-void DataRefs::ChTsOffsetAdd (double aNetTS)
+// processes a new sample of a channel's network time offset
+void DataRefs::ChTsSkewTy::Add (double sample, double sysTs)
+{
+    // first sample ever just initializes
+    if (!IsValid()) {
+        offset  = sample;
+        drift   = 0.0;
+        tsEst   = sysTs;
+        dev     = CH_TS_DEV_INIT;
+        cnt     = 1;
+        tsFirst = sysTs;
+        sumT = sumTT = sumTY = 0.0;
+        sumY    = sample;
+        nReg    = 1;
+        return;
+    }
+    
+    // residual against prediction, clipped so that outliers have limited influence
+    const double pred = Predict(sysTs);
+    const double resid = sample - pred;
+    const double clipped = std::max(-CH_TS_CLIP * dev, std::min(resid, CH_TS_CLIP * dev));
+    
+    // Too many outliers in a row? Then it's not the samples but the estimate
+    // which is off, e.g. after the system clock got adjusted: start over
+    nOutliers = (std::abs(resid) > CH_TS_CLIP * dev) ? nOutliers + 1 : 0;
+    if (nOutliers >= CH_TS_REACQUIRE) {
+        *this = ChTsSkewTy();
+        Add(sample, sysTs);
+        return;
+    }
+    dev = std::max(CH_TS_DEV_MIN, dev + CH_TS_GAIN * (std::abs(clipped) - dev));
+    
+    // first samples of a session are averaged, later ones smoothed exponentially
+    const double gain = std::max(1.0 / (cnt + 1), CH_TS_GAIN);
+    
+    // Drift is the slope of a least-squares line through this session's
+    // (clipped) samples, and only once they span a long enough baseline
+    // for the sample noise to average out
+    if (std::isnan(tsFirst))
+        tsFirst = sysTs;
+    const double t = sysTs - tsFirst;
+    const double y = pred + clipped;
+    sumT  += t;
+    sumY  += y;
+    sumTT += t * t;
+    sumTY += t * y;
+    nReg++;
+    const double varT = nReg * sumTT - sumT * sumT;
+    if (t >= CH_TS_DRIFT_BASELINE && nReg >= CH_TS_DRIFT_MIN_CNT && varT > 0.0)
+        drift = std::max(-CH_TS_DRIFT_MAX,
+                         std::min((nReg * sumTY - sumT * sumY) / varT, CH_TS_DRIFT_MAX));
+    offset = pred + gain * clipped;
+    tsEst  = sysTs;
+    cnt++;
+}
+
+// config file representation: offset;tsEst
+std::string DataRefs::ChTsSkewTy::GetConfigString () const
+{
+    char buf[100];
+    snprintf(buf, sizeof(buf), "%.3f;%.0f", offset, tsEst);
+    return buf;
+}
+
+// reads config file representation
+bool DataRefs::ChTsSkewTy::SetConfigString (const std::string& s)
+{
+    const std::vector<std::string> tok = str_tokenize(s, ";");
+    if (tok.size() != 2)
+        return false;
+    // Start over from the persisted offset only: The clocks' drift may well
+    // have changed since (NTP, restarts), so it is not extrapolated across
+    // sessions, and the expected deviation needs to be learned anew
+    *this   = ChTsSkewTy();
+    offset  = std::atof(tok[0].c_str());
+    tsEst   = std::atof(tok[1].c_str());
+    
+    // too old to be trusted?
+    if (std::isnan(offset) || std::isnan(tsEst) ||
+        std::abs(LTClock::SysNow() - tsEst) > CH_TS_PERSIST_MAX_AGE)
+        *this = ChTsSkewTy();
+    return true;
+}
+
+// reads a persisted offset estimate from a config file entry
+bool DataRefs::ChTsSkewFromConfig (const std::string& sKey, const std::string& sVal)
+{
+    for (int ch = DR_CHANNEL_FIRST; ch <= DR_CHANNEL_LAST; ch++)
+        if (CFG_TS_SKEW + DATA_REFS_LT[ch].getDataNameStr() == sKey)
+            return chTsSkew[ch - DR_CHANNEL_FIRST].SetConfigString(sVal);
+    return false;
+}
+
+// combined estimate of all enabled channels, weighted by their expected deviation
+double DataRefs::ChTsOffsetEstimate (double sysTs) const
+{
+    double sum = 0.0, sumW = 0.0;
+    for (int i = 0; i < CNT_DR_CHANNELS; i++)
+        if (bChannel[i] && chTsSkew[i].IsValid()) {
+            const double w = 1.0 / (chTsSkew[i].dev * chTsSkew[i].dev);
+            sum  += w * chTsSkew[i].Predict(sysTs);
+            sumW += w;
+        }
+    return sumW > 0.0 ? sum / sumW : NAN;
+}
+
+// start of a session: apply offset as predicted by (persisted) estimates right away
+void DataRefs::ChTsOffsetReset ()
+{
+    for (ChTsSkewTy& skew: chTsSkew)
+        skew.cnt = 0;
+    chTsOffsetTs = LTClock::SysNow();
+    const double est = ChTsOffsetEstimate(chTsOffsetTs);
+    chTsOffset = std::isnan(est) ? 0.0 : est;
+}
+
+// add another network timestamp to the offset calculation (network time vs. system clock)
+void DataRefs::ChTsOffsetAdd (dataRefsLT ch, double aNetTS)
 {
-    // after some calls we keep our offset stable (each chn has the chance twice)
-    if (cntAc > 0 ||                // and no change any longer if displaying a/c!
-        chTsOffsetCnt >= CntChannelEnabled() * 2)
+    LOG_ASSERT(DR_CHANNEL_FIRST <= ch && ch <= DR_CHANNEL_LAST);
+    
+    // For TS to become an offset we need to remove current system time;
+    // yes...since we received that timestamp time has passed, the filter
+    // will take care of that jitter.
+    const double now = LTClock::SysNow();
+    chTsSkew[ch - DR_CHANNEL_FIRST].Add(aNetTS - now, now);
+    const double est = ChTsOffsetEstimate(now);
+    if (std::isnan(est))
         return;
     
-    // for TS to become an offset we need to remove current system time;
-    // yes...since we received that timestamp time has passed...but this is all
-    // not about milliseconds...if it is plus/minus 5s we are good enough!
-    using namespace std::chrono;
-    aNetTS -=
-        // system time in microseconds
-        double(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count())
-        // divided by 1000000 to create seconds with fractionals
-        / 1000000.0;
-    
-    // now for the average
-    chTsOffset *= chTsOffsetCnt;
-    chTsOffset += aNetTS;
-    chTsOffset /= ++chTsOffsetCnt;
+    // While displaying aircraft the applied offset must not jump,
+    // as that would make aircraft jump along their path,
+    // so we then approach the estimate at a limited rate only.
+    if (cntAc > 0 && !std::isnan(chTsOffsetTs)) {
+        const double maxStep = CH_TS_SLEW_RATE * std::max(0.0, now - chTsOffsetTs);
+        chTsOffset += std::max(-maxStep, std::min(est - chTsOffset, maxStep));
+    } else
+        chTsOffset = est;
+    chTsOffsetTs = now;
 }
 
 //MARK: Processed values (static functions)
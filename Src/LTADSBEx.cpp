@@ -42,7 +42,24 @@ std::string ADSBExchangeConnection::GetURL (const positionTy& pos)
         snprintf(url, sizeof(url), ADSBEX_RAPIDAPI_25_URL, pos.lat(), pos.lon());
     else
         snprintf(url, sizeof(url), ADSBEX_URL, pos.lat(), pos.lon(),
-                 dataRefs.GetFdStdDistance_nm());
+                 dataRefs.GetFdQueryDistance_nm());
+    return std::string(url);
+}
+
+// ADSBEx queries a circle with radius GetFdQueryDistance, so the box needs twice that size
+boundingBoxTy ADSBExchangeConnection::GetQueryArea (const positionTy& pos) const
+{
+    return boundingBoxTy(pos, 2.0 * dataRefs.GetFdQueryDistance_m());
+}
+
+// put together the URL to fetch one tile:
+// ADSBEx queries a circle, so we query the circle around the tile
+std::string ADSBExchangeConnection::GetTileURL (const boundingBoxTy& tile)
+{
+    const positionTy ctr = tile.center();
+    const int dist_nm = int(std::ceil(tile.nw.dist(tile.se) / 2.0 / M_per_NM));
+    char url[128] = "";
+    snprintf(url, sizeof(url), ADSBEX_URL, ctr.lat(), ctr.lon(), dist_nm);
     return std::string(url);
 }
 
@@ -92,11 +109,14 @@ bool ADSBExchangeConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
     // We need to calculate distance to current camera later on
     const positionTy viewPos = dataRefs.GetViewPos();
     
+    // decoded updates, committed to fdMap at the end
+    vecFDUpdateTy vecUpd;
+    
     // for determining an offset as compared to network time we need to know network time
     double adsbxTime = jog_n(pObj, ADSBEX_TIME)  / 1000.0;
     if (adsbxTime > JAN_FIRST_2019)
         // if reasonable add this to our time offset calculation
-        dataRefs.ChTsOffsetAdd(adsbxTime);
+        dataRefs.ChTsOffsetAdd(GetChannel(), adsbxTime);
     
     // let's cycle the aircraft
     // fetch the aircraft array
@@ -116,92 +136,69 @@ bool ADSBExchangeConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
             }
         }
         
-        // the key: transponder Icao code
+        // early reject based on key and position only,
+        // before decoding anything else or taking any lock
+        // (ADSBEx, especially the RAPID API version, returns
+        //  aircraft regardless of distance.)
+        // The key (transponder Icao code) is normalized by FDKeyTy
+        // before being compared to the a/c filter.
         LTFlightData::FDKeyTy fdKey (LTFlightData::KEY_ICAO,
                                      jog_s(pJAc, ADSBEX_TRANSP_ICAO));
-        
-        // not matching a/c filter? -> skip it
-        if (!acFilter.empty() && (fdKey != acFilter))
-        {
+        if (!IsRecordOfInterest(fdKey, acFilter, viewPos,
+                                jog_sn_nan(pJAc, ADSBEX_LAT),
+                                jog_sn_nan(pJAc, ADSBEX_LON),
+                                jog_sn_nan(pJAc, ADSBEX_ELEVATION) * M_per_FT))
             continue;
-        }
         
-        try {
-            // from here on access to fdMap guarded by a mutex
-            // until FD object is inserted and updated
-            std::lock_guard<std::mutex> mapFdLock (mapFdMutex);
-            
-            // get the fd object from the map, key is the transpIcao
-            // this fetches an existing or, if not existing, creates a new one
-            LTFlightData& fd = fdMap[fdKey];
-            
-            // also get the data access lock once and for all
-            // so following fetch/update calls only make quick recursive calls
-            std::lock_guard<std::recursive_mutex> fdLock (fd.dataAccessMutex);
-            
-            // completely new? fill key fields
-            if ( fd.empty() )
-                fd.SetKey(fdKey);
-            
-            // fill static data
-            {
-                LTFlightData::FDStaticData stat;
-                stat.reg =        jog_s(pJAc, ADSBEX_REG);
-                stat.country =    jog_s(pJAc, ADSBEX_COUNTRY);
-                stat.acTypeIcao = jog_s(pJAc, ADSBEX_AC_TYPE_ICAO);
-                stat.mil =        jog_sb(pJAc, ADSBEX_MIL);
-                stat.trt          = transpTy(jog_sl(pJAc,ADSBEX_TRT));
-                stat.opIcao =     jog_s(pJAc, ADSBEX_OP_ICAO);
-                stat.call =       jog_s(pJAc, ADSBEX_CALL);
-
-                // update the a/c's master data
-                fd.UpdateData(std::move(stat));
-            }
-            
-            // dynamic data
-            {   // unconditional...block is only for limiting local variables
-                LTFlightData::FDDynamicData dyn;
-                
-                // ADS-B returns Java tics, that is milliseconds, we use seconds
-                double posTime = jog_sn(pJAc, ADSBEX_POS_TIME) / 1000.0;
-                
-                // non-positional dynamic data
-                dyn.radar.code =        jog_sl(pJAc, ADSBEX_RADAR_CODE);
-                dyn.gnd =               jog_sb(pJAc, ADSBEX_GND);
-                dyn.heading =           jog_sn_nan(pJAc, ADSBEX_HEADING);
-                dyn.spd =               jog_sn(pJAc, ADSBEX_SPD);
-                dyn.vsi =               jog_sn(pJAc, ADSBEX_VSI);
-                dyn.ts =                posTime;
-                dyn.pChannel =          this;
-                
-                // altitude, if airborne; correct for baro pressure difference
-                const double alt_ft = dyn.gnd ? NAN : jog_sn_nan(pJAc, ADSBEX_ELEVATION);
+        // decode the record into an update, no lock needed
+        FDUpdateTy& upd = vecUpd.emplace_back();
+        upd.key = std::move(fdKey);
+        
+        // static data
+        upd.stat.reg =        jog_s(pJAc, ADSBEX_REG);
+        upd.stat.country =    jog_s(pJAc, ADSBEX_COUNTRY);
+        upd.stat.acTypeIcao = jog_s(pJAc, ADSBEX_AC_TYPE_ICAO);
+        upd.stat.mil =        jog_sb(pJAc, ADSBEX_MIL);
+        upd.stat.trt          = transpTy(jog_sl(pJAc,ADSBEX_TRT));
+        upd.stat.opIcao =     jog_s(pJAc, ADSBEX_OP_ICAO);
+        upd.stat.call =       jog_s(pJAc, ADSBEX_CALL);
+        
+        // dynamic data
+        LTFlightData::FDDynamicData& dyn = upd.dyn;
+        
+        // ADS-B returns Java tics, that is milliseconds, we use seconds
+        double posTime = jog_sn(pJAc, ADSBEX_POS_TIME) / 1000.0;
+        
+        // non-positional dynamic data
+        dyn.radar.code =        jog_sl(pJAc, ADSBEX_RADAR_CODE);
+        dyn.gnd =               jog_sb(pJAc, ADSBEX_GND);
+        dyn.heading =           jog_sn_nan(pJAc, ADSBEX_HEADING);
+        dyn.spd =               jog_sn(pJAc, ADSBEX_SPD);
+        dyn.vsi =               jog_sn(pJAc, ADSBEX_VSI);
+        dyn.ts =                posTime;
+        dyn.pChannel =          this;
+        
+        // altitude, if airborne; correct for baro pressure difference
+        const double alt_ft = dyn.gnd ? NAN : jog_sn_nan(pJAc, ADSBEX_ELEVATION);
 
-                // position and its ground status
-                positionTy pos (jog_sn_nan(pJAc, ADSBEX_LAT),
-                                jog_sn_nan(pJAc, ADSBEX_LON),
-                                alt_ft * M_per_FT,
-                                posTime,
-                                dyn.heading);
-                pos.onGrnd = dyn.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
-                
-                // position is rather important, we check for validity
-                if ( pos.isNormal(true) ) {
-                    // ADSBEx, especially the RAPID API version, returns
-                    // aircraft regardless of distance. To avoid planes
-                    // created and immediately removed due to distanced settings
-                    // we continue only if pos is within wanted range
-                    if ( pos.dist(viewPos) <= dataRefs.GetFdStdDistance_m() )
-                        fd.AddDynData(dyn, 0, 0, &pos);
-                }
-                else
-                    LOG_MSG(logDEBUG,ERR_POS_UNNORMAL,fdKey.c_str(),pos.dbgTxt().c_str());
-            }
-        } catch(const std::system_error& e) {
-            LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
-        }
+        // position and its ground status
+        upd.pos = positionTy(jog_sn_nan(pJAc, ADSBEX_LAT),
+                             jog_sn_nan(pJAc, ADSBEX_LON),
+                             alt_ft * M_per_FT,
+                             posTime,
+                             dyn.heading);
+        upd.pos.onGrnd = dyn.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
+        
+        // position is rather important, we check for validity
+        // (distance to camera has been checked early already)
+        upd.bPos = upd.pos.isNormal(true);
+        if (!upd.bPos)
+            LOG_MSG(logDEBUG,ERR_POS_UNNORMAL,upd.key.c_str(),upd.pos.dbgTxt().c_str());
     }
     
+    // commit all decoded updates in one go
+    CommitUpdates(fdMap, vecUpd, viewPos);
+    
     // cleanup JSON
     json_value_free (pRoot);
     
@@ -849,11 +846,16 @@ bool ADSBExchangeHistorical::ProcessFetchedData (mapLTFlightDataTy& fdMap)
                     // we need a good take on the ground status of mainPos
                     // for later landing detection
                     mainPos.onGrnd = dyn.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
+                    SetRcvTs(mainPos);
                     
                     // FIXME: Called from outside main thread,
                     //        can produce wrong terrain alt (2 cases here)
                     //        Probably: Just add positions and let updated
                     //                  AppendNewPos / CalcNewPos do the job of landing detection
+                    // Note: Can't be left to the batch stage in AppendNewPos (yet):
+                    //       Ground status and terrain altitude of mainPos decide
+                    //       right here if and how trails are added. The batch stage
+                    //       probes these positions again in the main thread anyway.
                     fd.TryDeriveGrndStatus(mainPos);
                     
                     // Short Trails ("Cos" array), if available
@@ -55,11 +55,11 @@ bool NextCycle (int newCycle)
     else
     {
         prevCycle.num = newCycle-1;
-        prevCycle.elapsedTime = XPLMGetElapsedTime() - 0.1f;
+        prevCycle.elapsedTime = LTClock::Elapsed() - 0.1f;
         prevCycle.simTime  = dataRefs.GetSimTime() - 0.1;
     }
     currCycle.num = newCycle;
-    currCycle.elapsedTime = XPLMGetElapsedTime();
+    currCycle.elapsedTime = LTClock::Elapsed();
     currCycle.simTime  = dataRefs.GetSimTime();
     
     // the time that has passed since the last cycle
@@ -511,6 +511,115 @@ double AccelParam::getRatio (double deltaTS ) const
     return getDeltaDist(deltaTS) / targetDeltaDist;
 }
 
+//
+//MARK: AcTaskSchedTy
+//
+
+static_assert(ACT_NUM_TASKS == AC_TASK_NUM, "AcTaskTy and DataRefs::acTaskPeriod out of sync");
+
+AcTaskSchedTy::AcTaskSchedTy (const std::string& key) :
+phase((unsigned)std::hash<std::string>()(key))
+{
+    std::fill(std::begin(nextCycle), std::end(nextCycle), -1);
+}
+
+bool AcTaskSchedTy::IsDue (AcTaskTy task, int cycle)
+{
+    const int period = dataRefs.GetAcTaskPeriod(task);
+    int& next = nextCycle[task];
+    
+    // Not yet initialized, or cycle numbers restarted?
+    // Then first run is after this aircraft's phase offset,
+    // mixed with the task, so that an aircraft's tasks don't coincide either
+    if (next < 0 || next - cycle > period) {
+        next = cycle + int((phase + unsigned(task) * 0x9E3779B9u) % unsigned(period));
+        if (next != cycle)
+            return false;
+    }
+    
+    // not yet due?
+    if (cycle < next)
+        return false;
+    
+    // due: schedule the next run, keeping the phase even if cycles were skipped
+    next = cycle + period - (cycle - next) % period;
+    return true;
+}
+
+//
+//MARK: AISlotMgrTy
+//
+
+AISlotMgrTy aiSlots;
+
+// Sets (new) cost of an aircraft and reassigns slots if needed
+void AISlotMgrTy::Update (LTAircraft* pAc, double cost)
+{
+    auto iter = mapCost.find(pAc);
+    if (iter == mapCost.end()) {
+        // new aircraft: starts without slot
+        mapCost.emplace(pAc, cost);
+        setOther.emplace(cost, pAc);
+        pAc->aiPrio = AI_PRIO_NO_SLOT;
+    } else {
+        // known aircraft: re-insert with new cost into the same set
+        std::set<entryTy>& s = setSlot.count(entryTy(iter->second, pAc)) ? setSlot : setOther;
+        s.erase(entryTy(iter->second, pAc));
+        s.emplace(cost, pAc);
+        iter->second = cost;
+    }
+    Rebalance();
+}
+
+// Removes an aircraft, a freed slot is passed on
+void AISlotMgrTy::Remove (LTAircraft* pAc)
+{
+    auto iter = mapCost.find(pAc);
+    if (iter == mapCost.end())
+        return;
+    const entryTy e (iter->second, pAc);
+    if (!setSlot.erase(e))
+        setOther.erase(e);
+    mapCost.erase(iter);
+    Rebalance();
+}
+
+// Does the aircraft hold a slot?
+bool AISlotMgrTy::HasSlot (LTAircraft* pAc) const
+{
+    auto iter = mapCost.find(pAc);
+    return iter != mapCost.end() && setSlot.count(entryTy(iter->second, pAc)) > 0;
+}
+
+// Fills free slots and swaps holders with better challengers
+void AISlotMgrTy::Rebalance ()
+{
+    // fill free slots with the best other aircraft
+    while (setSlot.size() < numSlots && !setOther.empty())
+        Move(setOther, setOther.begin(), setSlot, AI_PRIO_SLOT);
+    
+    // swap while the best challenger is clearly better than the worst holder
+    // (terminates: a swapped-out holder can never clearly beat the new worst holder)
+    while (!setSlot.empty() && !setOther.empty()) {
+        auto worstSlot = std::prev(setSlot.end());
+        auto bestOther = setOther.begin();
+        if (bestOther->first >= worstSlot->first * (1.0 - AI_SLOT_HYSTERESIS))
+            break;
+        Move(setSlot, worstSlot, setOther, AI_PRIO_NO_SLOT);
+        Move(setOther, bestOther, setSlot, AI_PRIO_SLOT);
+    }
+}
+
+// Moves an entry between the sets and updates the aircraft's aiPrio
+void AISlotMgrTy::Move (std::set<entryTy>& from, std::set<entryTy>::iterator it,
+                        std::set<entryTy>& to, int aiPrio)
+{
+    const entryTy e = *it;
+    from.erase(it);
+    to.insert(e);
+    e.second->aiPrio = aiPrio;
+}
+
 //
 //MARK: LTAircraft::FlightModel
 //
@@ -922,7 +1031,8 @@ spoilers(MDL_SPOILERS_TIME),
 tireRpm(MDL_TIRE_SLOW_TIME, MDL_TIRE_MAX_RPM),
 gearDeflection(MDL_GEAR_DEFL_TIME, mdl.GEAR_DEFLECTION),
 probeRef(NULL), probeNextTs(0), terrainAlt(0),
-bValid(true)
+bValid(true),
+tasks(inFd.key().key)
 {
     // for some calcs we need correct timestamps _before_ first draw already
     // so make sure the currCycle struct is up-to-date
@@ -995,6 +1105,9 @@ LTAircraft::~LTAircraft()
     if (probeRef)
         XPLMDestroyProbe(probeRef);
     
+    // pass on our multiplayer/TCAS slot
+    aiSlots.Remove(this);
+    
     // Decrease number of visible aircraft and log a message about that fact
     dataRefs.DecNumAc();
     LOG_MSG(logINFO,INFO_AC_REMOVED,labelInternal.c_str());
@@ -1136,6 +1249,11 @@ bool LTAircraft::CalcPPos()
     // (Must have reach/passed posList[1] and there must be a third position,
     //  which can now serve as 'to')
     while ( posList[1].ts() <= currCycle.simTime && posList.size() >= 3 ) {
+        // posList[1] got reached on screen: record its latency
+        if (posList[1].rcvTs > lastLatencyRcvTs) {
+            lastLatencyRcvTs = posList[1].rcvTs;
+            LTLatencyAdd(posList[1], LTChannel::NetNow());
+        }
         // By just removing the first element (current 'from') from the deqeue
         // we make posList[2] the next 'to'
         posList.pop_front();
@@ -1797,10 +1915,6 @@ bool LTAircraft::YProbe ()
         
         // calc current bearing and distance for pure informational purpose ***
         vecView = positionTy(dataRefs.GetViewPos()).between(ppos);
-        // update AI slotting priority
-        CalcAIPrio();
-        // update the a/c label with fresh values
-        LabelUpdate();
     }
     
     // Success
@@ -1968,21 +2082,30 @@ bool LTAircraft::CalcVisible ()
     return bVisible;
 }
 
-/// Determines AI priority based on bearing to user's plane and ground status
-/// 1. Planes in the 30° sector in front of user's plane
-/// 2. Planes in the 90° sector in front of user's plane
-/// 3. All else
-/// If user is flying then airborne planes have in total higher prio than
-/// taxiing planes.
+/// Updates the AI slot manager with the current slot cost,
+/// which in turn sets `aiPrio` whenever our slot status changes
 /// @warning Should only be called "every so often" but not every drawing frame
 void LTAircraft::CalcAIPrio ()
+{
+    aiSlots.Update(this, CalcAISlotCost());
+}
+
+/// Slot cost is an "effective distance" [m] from the user's plane:
+/// 1. 3D distance, with vertical separation weighted by AI_SLOT_ALT_WEIGHT
+/// 2. reduced by the distance the aircraft closes in within AI_SLOT_CLOSURE_TIME
+/// 3. increased by up to AI_SLOT_BEHIND_FACTOR the farther the aircraft is off the user's track
+/// 4. increased by AI_SLOT_GND_FACTOR if user's plane is flying but this a/c is on the ground
+/// 5. but not higher than the ranking of its predicted closest approach (see LTCpa.h)
+double LTAircraft::CalcAISlotCost () const
 {
     // If this is the plane, which is currently in camera view,
     // then we want to see it in map apps as well:
-    if (IsInCameraView()) {
-        aiPrio = 0;
-        return;
-    }
+    if (IsInCameraView())
+        return 0.0;
+    
+    // invisible aircraft don't show on TCAS anyway, so they shall not block a slot
+    if (!IsVisible())
+        return std::numeric_limits<double>::max();
     
     // user's plane's position and bearing from user's plane to this aircraft
     double userSpeed, userTrack;
@@ -1990,21 +2113,37 @@ void LTAircraft::CalcAIPrio ()
     if (posUser.IsOnGnd())              // if on the ground
         userTrack = posUser.heading();      // heading is more reliable
     const double bearing = posUser.angle(ppos);
-    const double diff = abs(HeadingDiff(userTrack, bearing));
-    
-    // 1. Planes in the 30° sector in front of user's plane
-    if (diff < 30)
-        aiPrio = 0;
-    // 2. Planes in the 90° sector in front of user's plane
-    else if (diff < 90)
-        aiPrio = 1;
-    // 3. All else (default)
-    else
-        aiPrio = 2;
     
-    // Ground consideration only if user's plane is flying but this a/c not
+    // 1. distance, vertical separation counting more
+    const double dist = posUser.dist(ppos);
+    const double altDiff = std::abs(ppos.alt_m() - posUser.alt_m()) * AI_SLOT_ALT_WEIGHT;
+    double cost = std::sqrt(dist*dist + altDiff*altDiff);
+    
+    // 2. closure rate: relative velocity projected onto the line of sight, positive if approaching
+    if (!std::isnan(userSpeed) && !std::isnan(userTrack)) {
+        const double bRad = deg2rad(bearing);
+        const double relX = speed.m_s() * std::sin(deg2rad(vec.angle)) - userSpeed * std::sin(deg2rad(userTrack));
+        const double relY = speed.m_s() * std::cos(deg2rad(vec.angle)) - userSpeed * std::cos(deg2rad(userTrack));
+        const double closure = -(relX * std::sin(bRad) + relY * std::cos(bRad));
+        if (std::isfinite(closure))
+            cost = std::max(cost - closure * AI_SLOT_CLOSURE_TIME, 0.0);
+    }
+    
+    // 3. relevance to the user's flight: ahead is more relevant than behind
+    const double diff = std::abs(HeadingDiff(userTrack, bearing));
+    if (std::isfinite(diff))
+        cost *= 1.0 + diff / 180.0 * (AI_SLOT_BEHIND_FACTOR - 1.0);
+    
+    // 4. Ground consideration only if user's plane is flying but this a/c not
     if (!posUser.IsOnGnd() && IsOnGrnd())
-        aiPrio += 3;
+        cost *= AI_SLOT_GND_FACTOR;
+    
+    // 5. A predicted close approach counts at least as much
+    CpaTy cpa;
+    if (LTCpaGet(fd.key(), cpa) && cpa.cost < cost)
+        cost = cpa.cost;
+    
+    return cost;
 }
 
 //
@@ -2261,9 +2400,22 @@ XPMPPlaneCallbackResult LTAircraft::GetPlanePosition(XPMPPlanePosition_t* outPos
         multiIdx = outPosition->multiIdx;
         
         // calculate new position and return it
+        const bool bTrj = LTTrajectoryIsActive();
+        const std::chrono::steady_clock::time_point tCalc =
+            bTrj ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
         if (!dataRefs.IsReInitAll() &&          // avoid any calc if to be re-initialized
             CalcPPos())
         {
+            // debug: record rendered trajectory
+            if (bTrj)
+                LTTrajectoryRecord(*this, std::chrono::steady_clock::now() - tCalc);
+            
+            // periodic tasks, staggered across aircraft
+            if (tasks.IsDue(ACT_AI_PRIO, cycle))    // update AI slotting priority
+                CalcAIPrio();
+            if (tasks.IsDue(ACT_LABEL, cycle))      // update the a/c label with fresh values
+                LabelUpdate();
+            
             // copy ppos (by type conversion)
             *outPosition = ppos;
             
@@ -2318,12 +2470,17 @@ XPMPPlaneCallbackResult LTAircraft::GetPlaneSurfaces(XPMPPlaneSurfaces_t* outSur
             surfaces.spoilerRatio = surfaces.speedBrakeRatio = (float)spoilers.get();
             surfaces.reversRatio = (float)reversers.get();
 
-            // for engine / prop rotation we derive a value based on flight model
-            if (doc8643.hasRotor())
-                surfaces.engRotRpm = surfaces.propRotRpm = float(mdl.PROP_RPM_MAX);
-            else
-                surfaces.engRotRpm = surfaces.propRotRpm =
-                    float(mdl.PROP_RPM_MAX/2 + surfaces.thrust * mdl.PROP_RPM_MAX/2);
+            // rpm values change slowly, refresh them only periodically
+            if (tasks.IsDue(ACT_SURFACES, currCycle.num)) {
+                // for engine / prop rotation we derive a value based on flight model
+                if (doc8643.hasRotor())
+                    surfaces.engRotRpm = surfaces.propRotRpm = float(mdl.PROP_RPM_MAX);
+                else
+                    surfaces.engRotRpm = surfaces.propRotRpm =
+                        float(mdl.PROP_RPM_MAX/2 + surfaces.thrust * mdl.PROP_RPM_MAX/2);
+                // tire rotation similarly
+                surfaces.tireRotRpm = (float)tireRpm.get();
+            }
             
             // Make props and rotors move based on rotation speed and time passed since last cycle
             surfaces.engRotDegree += (float)RpmToDegree(surfaces.engRotRpm, currCycle.diffTime);
@@ -2334,8 +2491,7 @@ XPMPPlaneCallbackResult LTAircraft::GetPlaneSurfaces(XPMPPlaneSurfaces_t* outSur
             // Gear deflection - has an effect during touch-down only
             surfaces.tireDeflect = (float)gearDeflection.get();
             
-            // Tire rotation similarly
-            surfaces.tireRotRpm = (float)tireRpm.get();
+            // Tire rotation
             surfaces.tireRotDegree += (float)RpmToDegree(surfaces.tireRotRpm, currCycle.diffTime);
             while (surfaces.tireRotDegree >= 360.0f)
                 surfaces.tireRotDegree -= 360.0f;
@@ -2368,9 +2524,9 @@ XPMPPlaneCallbackResult LTAircraft::GetPlaneRadar(XPMPPlaneRadar_t* outRadar)
             return xpmpData_Unavailable;
         
         // for radar 'calculation' we need some dynData
-        // but radar doesn't change often...just only check every 100th cycle
+        // but radar doesn't change often...just only check periodically
         if (!dataRefs.IsReInitAll() &&
-            currCycle.num % 100 == 0 )
+            tasks.IsDue(ACT_RADAR, currCycle.num))
         {
             // fetch new data if available
             LTFlightData::FDDynamicData dynCopy;
@@ -2382,7 +2538,6 @@ XPMPPlaneCallbackResult LTAircraft::GetPlaneRadar(XPMPPlaneRadar_t* outRadar)
             }
         }
         
-        // GetPlaneSurfaces fetches fresh data every 10th cycle
         // just copy over our entire structure
         *outRadar = radar;
         
@@ -2410,8 +2565,9 @@ XPMPPlaneCallbackResult LTAircraft::GetInfoTexts(XPMPInfoTexts_t* outInfo)
         if (!IsValid() || dataRefs.IsReInitAll())
             return xpmpData_Unavailable;
         
-        // Is there new data to send?
-        if (ShallSendNewInfoData())
+        // Is there new data to send? (only checked periodically)
+        if (ShallSendNewInfoData() &&
+            tasks.IsDue(ACT_INFO_TEXTS, currCycle.num))
         {
             // fetch new data if available
             LTFlightData::FDStaticData statCopy;
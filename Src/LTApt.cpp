@@ -181,6 +181,10 @@ public:
     
     /// Return the node's type
     nodeTy GetType () const { return type; }
+    /// Return the index of the a node (into Apt::vecTaxiNodes or Apt::vecRwyEndPts, depending on type)
+    size_t GetIdxA () const { return a; }
+    /// Return the index of the b node (into Apt::vecTaxiNodes or Apt::vecRwyEndPts, depending on type)
+    size_t GetIdxB () const { return b; }
     
     // Poor man's polymorphism: rwy endpoints are stored at a different place
     // than taxiway nodes. And we only store indexes as pointers are
@@ -205,6 +209,24 @@ public:
 typedef std::vector<TaxiEdge> vecTaxiEdgeTy;
 /// List of const pointers to taxi edges (for search function results)
 typedef std::list<const TaxiEdge*> lstTaxiEdgeCPtrTy;
+/// Per taxi node: the list of indexes into Apt::vecTaxiEdges of edges connected to that node
+typedef std::vector< std::vector<size_t> > vecNodeEdgesTy;
+
+/// @brief One candidate edge for one position during map matching
+/// @details A position has a couple of candidates, which are the states
+///          of the hidden Markov model, see Apt::MatchTrack
+struct MatchCandTy {
+    const TaxiEdge* pEdge = nullptr;    ///< candidate edge
+    double x = NAN;                     ///< base point on the edge, local coordinates, east axis
+    double z = NAN;                     ///< base point on the edge, local coordinates, south axis
+    double cost = 0.0;                  ///< accumulated cost of best path ending in this candidate
+    size_t prev = 0;                    ///< index of best predecessor in previous position's candidates
+};
+/// Candidates of one position
+typedef std::vector<MatchCandTy> vecMatchCandTy;
+
+/// A position to be inserted into a track at the given index
+typedef std::vector< std::pair<size_t,positionTy> > vecPosInsertTy;
 
 /// Represents an airport as read from apt.dat
 class Apt {
@@ -216,6 +238,7 @@ protected:
     vecTaxiNodesTy vecTaxiNodes;        ///< vector of taxi network nodes
     vecRwyEndPtTy  vecRwyEndPts;        ///< vector of runway endpoints
     vecTaxiEdgeTy  vecTaxiEdges;        ///< vector of taxi network edges, each connecting any two nodes
+    vecNodeEdgesTy vecNodeEdges;        ///< per taxi node the edges connected to it (built in AddApt after sorting edges)
 
 public:
     /// Constructor expects an id
@@ -356,42 +379,86 @@ public:
     }
     
     
-    /// @brief Find closest taxi edge matching the passed position including its heading
-    /// @param pos Search position, only nearby nodes with a similar heading are considered
-    /// @param[out] basePt Receives the coordinates of the base point in case of a match. Only lat and lon will be modified.
-    /// @param _maxDist_m Maximum distance in meters between `pos` and edge to be considered a match
-    /// @param _angleTolerance Maximum difference between `pos.heading()` and TaxiEdge::angle to be considered a match
-    /// @return Pointer to closest taxiway edge or `nullptr` if no match was found
-    const TaxiEdge* FindClosestEdge (const positionTy& pos,
-                                     positionTy& basePt,
-                                     int _maxDist_m,
-                                     double _angleTolerance = ART_EDGE_ANGLE_TOLERANCE) const
+    /// @brief Build the list of edges per taxi node, required for quickly finding neighbouring edges
+    /// @note Must be called after the edges have been sorted as we store indexes into Apt::vecTaxiEdges
+    void BuildNodeEdges ()
     {
-        const TaxiEdge* bestEdge = nullptr;
-        const TaxiNode* bestFrom = nullptr;
-        const TaxiNode* bestTo   = nullptr;
-        distToLineTy bestDist;
-        bestDist.dist2 = (double)sqr(_maxDist_m);
-        // At maximum, we allow that the base of the shortest dist to edge is about GetFdSnapTaxiDist_m outside of line ends
-        const double maxDistBeyondLineEnd2 = (double)sqr(_maxDist_m);;
+        vecNodeEdges.clear();
+        vecNodeEdges.resize(vecTaxiNodes.size());
+        for (size_t i = 0; i < vecTaxiEdges.size(); ++i) {
+            const TaxiEdge& e = vecTaxiEdges[i];
+            // runways connect rwy endpoints, not taxi nodes, so they have no neighbours in this sense
+            if (e.GetType() == TaxiEdge::RUN_WAY)
+                continue;
+            vecNodeEdges[e.GetIdxA()].push_back(i);
+            vecNodeEdges[e.GetIdxB()].push_back(i);
+        }
+    }
+    
+    /// @brief Returns the passed-in edge plus all edges connected to either of its nodes, if matching the heading
+    /// @param pEdge The edge, which serves as the center of the search, must be an edge of this airport
+    /// @param _headSearch The heading we search for and which the edge has to match
+    /// @param _angleTolerance Maximum difference between `_headSearch` and TaxiEdge::angle to be considered a match
+    /// @param[out] lst Matching egdes are added to this list
+    /// @return Anything found? Basically: `!lst.empty()`
+    bool FindNeighbourEdges (const TaxiEdge* pEdge,
+                             double _headSearch,
+                             double _angleTolerance,
+                             lstTaxiEdgeCPtrTy& lst) const
+    {
+        // TaxiEdge::angle is normalized to [0..180), so we compare modulo 180
+        if (_headSearch >= 180.0)
+            _headSearch -= 180.0;
+        auto headMatches = [_headSearch,_angleTolerance](const TaxiEdge& e)
+        {
+            const double d = std::abs(e.angle - _headSearch);
+            return std::min(d, 180.0 - d) <= _angleTolerance;
+        };
         
-        // We calculate in local coordinates
-        double pt_x = NAN, pt_y = NAN, pt_z = NAN;
-        XPLMWorldToLocal(pos.lat(), pos.lon(), pos.alt_m(),
-                         &pt_x, &pt_y, &pt_z);
+        // the edge itself
+        if (headMatches(*pEdge))
+            lst.push_back(pEdge);
         
-        // Get a list of edges matching pos.heading()
-        lstTaxiEdgeCPtrTy lstEdges;
-        const double headSearch = HeadingNormalize(pos.heading());
-        if (!FindEdgesForHeading(headSearch,
-                                 _angleTolerance,
-                                 lstEdges))
-            return nullptr;
+        // Runways aren't part of the taxi node network, no neighbours
+        if (pEdge->GetType() == TaxiEdge::RUN_WAY)
+            return !lst.empty();
         
-        // Edges are normalized to angle of [0..180),
-        // do we fly the other way round?
-        const bool bHeadInverted = headSearch >= 180.0;
-
+        // all edges connected to any of the two nodes
+        for (size_t n: { pEdge->GetIdxA(), pEdge->GetIdxB() }) {
+            if (n >= vecNodeEdges.size())
+                continue;
+            for (size_t i: vecNodeEdges[n]) {
+                const TaxiEdge& e = vecTaxiEdges[i];
+                if (&e != pEdge && headMatches(e))
+                    lst.push_back(&e);
+            }
+        }
+        
+        // Found anything?
+        return !lst.empty();
+    }
+    
+    /// Intermediate result of searching the closest edge
+    struct ClosestEdgeTy {
+        const TaxiEdge* pEdge = nullptr;    ///< closest edge found so far
+        const TaxiNode* pFrom = nullptr;    ///< edge's node we come from
+        const TaxiNode* pTo   = nullptr;    ///< edge's node we go to
+        distToLineTy    dist;               ///< distance to that edge, `dist.dist2` serves as upper bound for further search
+    };
+    
+    /// @brief Find an edge of the given list closer than the best one found so far
+    /// @param pt_x Search position's local x coordinate
+    /// @param pt_z Search position's local z coordinate
+    /// @param bHeadInverted Do we move against the edges' normalized angle?
+    /// @param maxDistBeyondLineEnd2 Maximum squared distance the base point may lie outside the edge's ends
+    /// @param lstEdges Candidate edges, typically pre-selected by heading
+    /// @param[in,out] best Best edge found so far, only replaced by a closer one
+    void FindClosestEdgeOfList (double pt_x, double pt_z,
+                                bool bHeadInverted,
+                                double maxDistBeyondLineEnd2,
+                                const lstTaxiEdgeCPtrTy& lstEdges,
+                                ClosestEdgeTy& best) const
+    {
         // Analyze the edges to find the closest edge
         for (const TaxiEdge* e: lstEdges)
         {
@@ -411,7 +478,7 @@ public:
                                dist);
             
             // If distance is farther then best we know: skip
-            if (dist.dist2 >= bestDist.dist2)
+            if (dist.dist2 >= best.dist.dist2)
                 continue;
             
             // If base of shortest path to point is too far outside actual line
@@ -419,39 +486,92 @@ public:
                 continue;
             
             // We have a new best match!
-            bestEdge = e;
-            bestFrom = &from;
-            bestTo   = &to;
-            bestDist = dist;
+            best.pEdge = e;
+            best.pFrom = &from;
+            best.pTo   = &to;
+            best.dist  = dist;
+        }
+    }
+    
+    /// @brief Find closest taxi edge matching the passed position including its heading
+    /// @details If the previous position's edge is known, then that edge and its
+    ///          neighbours are tried first. Only if none of them is closer than
+    ///          ART_EDGE_SEED_DIST all edges matching the heading are searched,
+    ///          for anything closer than the best neighbour.
+    /// @param pos Search position, only nearby nodes with a similar heading are considered
+    /// @param[out] basePt Receives the coordinates of the base point in case of a match. Only lat and lon will be modified.
+    /// @param _maxDist_m Maximum distance in meters between `pos` and edge to be considered a match
+    /// @param _angleTolerance Maximum difference between `pos.heading()` and TaxiEdge::angle to be considered a match
+    /// @param pPrevEdge (Optional) Edge matched by the previous position of the same track
+    /// @return Pointer to closest taxiway edge or `nullptr` if no match was found
+    const TaxiEdge* FindClosestEdge (const positionTy& pos,
+                                     positionTy& basePt,
+                                     int _maxDist_m,
+                                     double _angleTolerance = ART_EDGE_ANGLE_TOLERANCE,
+                                     const TaxiEdge* pPrevEdge = nullptr) const
+    {
+        ClosestEdgeTy best;
+        best.dist.dist2 = (double)sqr(_maxDist_m);
+        // At maximum, we allow that the base of the shortest dist to edge is about GetFdSnapTaxiDist_m outside of line ends
+        const double maxDistBeyondLineEnd2 = (double)sqr(_maxDist_m);
+        
+        // We calculate in local coordinates
+        double pt_x = NAN, pt_y = NAN, pt_z = NAN;
+        XPLMWorldToLocal(pos.lat(), pos.lon(), pos.alt_m(),
+                         &pt_x, &pt_y, &pt_z);
+        
+        // Edges are normalized to angle of [0..180),
+        // do we fly the other way round?
+        const double headSearch = HeadingNormalize(pos.heading());
+        const bool bHeadInverted = headSearch >= 180.0;
+        
+        // First try: the previous edge and its neighbours
+        lstTaxiEdgeCPtrTy lstEdges;
+        if (pPrevEdge &&
+            FindNeighbourEdges(pPrevEdge, headSearch, _angleTolerance, lstEdges))
+            FindClosestEdgeOfList(pt_x, pt_z, bHeadInverted, maxDistBeyondLineEnd2, lstEdges, best);
+        
+        // No neighbour close enough? Then search all edges matching pos.heading(),
+        // the best neighbour (if any) bounding the search distance
+        if (!best.pEdge || best.dist.dist2 > sqr(ART_EDGE_SEED_DIST)) {
+            lstEdges.clear();
+            if (FindEdgesForHeading(headSearch, _angleTolerance, lstEdges))
+                FindClosestEdgeOfList(pt_x, pt_z, bHeadInverted, maxDistBeyondLineEnd2, lstEdges, best);
         }
         
         // Nothing found?
-        if (!bestEdge || !bestFrom || !bestTo)
+        if (!best.pEdge || !best.pFrom || !best.pTo)
             return nullptr;
         
         // Compute base point on the line,
         // ie. the point on the line with shortest distance
         // to pos
-        DistResultToBaseLoc(bestFrom->x, bestFrom->z,   // edge's starting point
-                            bestTo->x, bestTo->z,       // edge's end point
-                            bestDist,
-                            pt_x, pt_z);                // base point's local coordinates
+        DistResultToBaseLoc(best.pFrom->x, best.pFrom->z,   // edge's starting point
+                            best.pTo->x, best.pTo->z,       // edge's end point
+                            best.dist,
+                            pt_x, pt_z);                    // base point's local coordinates
         double lat = NAN, lon = NAN, alt = NAN;
         XPLMLocalToWorld(pt_x, pt_y, pt_z,
                          &lat, &lon, &alt);
         
         basePt.lat() = lat;
         basePt.lon() = lon;
-        return bestEdge;
+        return best.pEdge;
     }
     
     /// @brief Find best matching taxi edge based on passed-in position/heading info
-    bool SnapToTaxiway (positionTy& pos, bool bLogging) const
+    /// @param pos Position to snap, will be moved to the edge if a match is found
+    /// @param bLogging Do logging via LOG_MSG?
+    /// @param pPrevEdge (Optional) Edge matched by the previous position of the same track, speeds up search
+    /// @return The edge `pos` was snapped to, or `nullptr` if none found
+    const TaxiEdge* SnapToTaxiway (positionTy& pos, bool bLogging,
+                                   const TaxiEdge* pPrevEdge = nullptr) const
     {
         const double old_lat = pos.lat(), old_lon = pos.lon();
         
         // Find the closest edge and right away move pos there
-        const TaxiEdge* pEdge = FindClosestEdge(pos, pos, dataRefs.GetFdSnapTaxiDist_m());
+        const TaxiEdge* pEdge = FindClosestEdge(pos, pos, dataRefs.GetFdSnapTaxiDist_m(),
+                                                ART_EDGE_ANGLE_TOLERANCE, pPrevEdge);
         if (pEdge) {
             // found a match, say hurray
             if (bLogging) {
@@ -464,13 +584,309 @@ public:
             //  downside is that we will pass in this position again and again...)
             if (pEdge->GetType() != TaxiEdge::RUN_WAY)
                 pos.flightPhase = LTAPIAircraft::FPH_TAXI;
-            return true;
+            return pEdge;
         }
         
         // nothing found
+        return nullptr;
+    }
+    
+    // --- MARK: Map Matching
+    
+    /// @brief Do both edges meet in a common taxi node?
+    /// @param e1 One edge
+    /// @param e2 Other edge
+    /// @param[out] n Receives the index (into Apt::vecTaxiNodes) of the common node
+    /// @return `true` if there is a common node, `false` otherwise or if any of the two is a runway
+    static bool SharedNode (const TaxiEdge& e1, const TaxiEdge& e2, size_t& n)
+    {
+        if (e1.GetType() == TaxiEdge::RUN_WAY || e2.GetType() == TaxiEdge::RUN_WAY)
+            return false;
+        for (size_t n1: { e1.GetIdxA(), e1.GetIdxB() })
+            if (n1 == e2.GetIdxA() || n1 == e2.GetIdxB()) {
+                n = n1;
+                return true;
+            }
         return false;
     }
     
+    /// @brief Heading along an edge in the direction closest to a given heading
+    /// @param e The edge, TaxiEdge::angle is normalized to [0..180)
+    /// @param head Heading to align with, typically the position's original heading
+    /// @return `e.angle` or `e.angle + 180`, or `head` unchanged if `NAN`
+    static double EdgeHeading (const TaxiEdge& e, double head)
+    {
+        if (std::isnan(head))
+            return head;
+        return std::abs(HeadingDiff(e.angle, head)) <= 90.0 ? e.angle : e.angle + 180.0;
+    }
+    
+    /// @brief Collect the closest candidate edges for a position
+    /// @details Edges connected to the previous position's candidates are tried first.
+    ///          Only if none of them is closer than ART_EDGE_SEED_DIST all edges
+    ///          matching the heading are compared by distance, so that the closest ones
+    ///          are found even if the track jumps over to an edge not connected to the
+    ///          previous one. Staying on the same or an adjacent edge is preferred
+    ///          by the transition cost in MatchTrack.
+    ///          Result is pruned to the ART_MATCH_MAX_CAND closest edges.
+    /// @param pos Position in search of candidates, only the heading is used
+    /// @param pt_x Position's local x coordinate
+    /// @param pt_z Position's local z coordinate
+    /// @param _maxDist_m Maximum distance in meters between `pos` and edge to be considered a match
+    /// @param pPrev (Optional) Candidates of the previous position
+    /// @param[out] vecCand Receives the candidates, MatchCandTy::cost is set to the emission cost
+    void FindMatchCandidates (const positionTy& pos,
+                              double pt_x, double pt_z,
+                              int _maxDist_m,
+                              const vecMatchCandTy* pPrev,
+                              vecMatchCandTy& vecCand) const
+    {
+        const double maxDist2 = (double)sqr(_maxDist_m);
+        const double headSearch = HeadingNormalize(pos.heading());
+        lstTaxiEdgeCPtrTy lstEdges;
+        
+        // Evaluate all edges in lstEdges and add those close enough to vecCand
+        auto evalEdges = [&]()
+        {
+            for (const TaxiEdge* e: lstEdges)
+            {
+                const TaxiNode& from = e->GetA(*this);
+                const TaxiNode& to   = e->GetB(*this);
+                if (!from.HasLocalCoords() || !to.HasLocalCoords())
+                    continue;
+                
+                distToLineTy dist;
+                DistPointToLineSqr(pt_x, pt_z, from.x, from.z, to.x, to.z, dist);
+                if (dist.dist2 >= maxDist2 ||
+                    dist.DistSqrOfBaseBeyondLine() > maxDist2)
+                    continue;
+                
+                MatchCandTy cand;
+                cand.pEdge = e;
+                cand.x = pt_x;
+                cand.z = pt_z;
+                DistResultToBaseLoc(from.x, from.z, to.x, to.z, dist, cand.x, cand.z);
+                cand.cost = dist.dist2 / maxDist2;      // emission cost
+                vecCand.push_back(cand);
+            }
+        };
+        
+        // First try: neighbourhood of the previous candidates
+        if (pPrev) {
+            for (const MatchCandTy& c: *pPrev)
+                FindNeighbourEdges(c.pEdge, headSearch, ART_EDGE_ANGLE_TOLERANCE, lstEdges);
+            lstEdges.sort();
+            lstEdges.unique();
+            evalEdges();
+        }
+        
+        // No neighbour close enough? Then compare all edges matching the heading
+        const double seedCost = sqr(ART_EDGE_SEED_DIST) / maxDist2;
+        if (std::none_of(vecCand.cbegin(), vecCand.cend(),
+                         [seedCost](const MatchCandTy& c){ return c.cost <= seedCost; }))
+        {
+            lstEdges.clear();
+            vecCand.clear();
+            if (FindEdgesForHeading(headSearch, ART_EDGE_ANGLE_TOLERANCE, lstEdges))
+                evalEdges();
+        }
+        
+        // Prune to the closest candidates
+        auto compCost = [](const MatchCandTy& a, const MatchCandTy& b){ return a.cost < b.cost; };
+        if (vecCand.size() > ART_MATCH_MAX_CAND) {
+            std::partial_sort(vecCand.begin(), vecCand.begin() + ART_MATCH_MAX_CAND,
+                              vecCand.end(), compCost);
+            vecCand.resize(ART_MATCH_MAX_CAND);
+        }
+    }
+    
+    /// @brief Map-match a window of ground positions onto the taxi network
+    /// @details Hidden Markov model: Each position's states are its candidate edges,
+    ///          emission cost is the squared distance to the edge,
+    ///          transition cost prefers staying on the same or an adjacent edge
+    ///          and penalizes differences between the distance travelled along the
+    ///          edges and the distance between the original positions.
+    ///          The Viterbi algorithm finds the cheapest path incrementally position by position,
+    ///          with candidates pruned to ART_MATCH_MAX_CAND, so cost is linear in window length.\n
+    ///          Positions are moved onto the chosen edges and take over the edge's heading.
+    ///          Where the path turns from one edge into an adjacent one, a position
+    ///          at the common taxi node is proposed for insertion.\n
+    ///          If the position right before the window has already been matched
+    ///          earlier, it anchors the path as a fixed state on its edge,
+    ///          so that the window continues where the previous match ended.
+    /// @param posDeque The track
+    /// @param idxBegin First position of the window, all positions in the window are expected to be on the ground and within the airport
+    /// @param idxEnd One past the last position of the window
+    /// @param bAnchor Is the position at `idxBegin-1` an already matched position on the ground of this airport?
+    /// @param[out] vecIns Receives positions to be inserted at taxi nodes
+    /// @return Number of positions changed
+    int MatchTrack (dequePositionTy& posDeque,
+                    size_t idxBegin, size_t idxEnd,
+                    bool bAnchor,
+                    vecPosInsertTy& vecIns) const
+    {
+        const int maxDist_m = dataRefs.GetFdSnapTaxiDist_m();
+        int cntMatched = 0;
+        
+        // Local coordinates of the original positions
+        std::vector<double> vX, vY, vZ;
+        // The Viterbi trellis: one vector of candidates per position
+        std::vector<vecMatchCandTy> trellis;
+        size_t idxSeg = idxBegin;               // first position of current trellis
+        size_t nFixed = 0;                      // number of fixed states at the beginning of the trellis
+        
+        // Anchor: the previously matched position is the only state of the first trellis entry
+        if (bAnchor && idxBegin > 0) {
+            const positionTy& anchor = posDeque[idxBegin-1];
+            positionTy basePt (anchor);
+            MatchCandTy cand;
+            cand.pEdge = FindClosestEdge(anchor, basePt, maxDist_m);
+            if (cand.pEdge) {
+                double pt_y = NAN;
+                XPLMWorldToLocal(anchor.lat(), anchor.lon(), anchor.alt_m(),
+                                 &cand.x, &pt_y, &cand.z);
+                trellis.push_back(vecMatchCandTy { cand });
+                vX.push_back(cand.x);
+                vY.push_back(pt_y);
+                vZ.push_back(cand.z);
+                idxSeg = idxBegin-1;
+                nFixed = 1;
+            }
+        }
+        
+        for (size_t i = idxBegin; i <= idxEnd; ++i)
+        {
+            vecMatchCandTy vecCand;
+            double pt_x = NAN, pt_y = NAN, pt_z = NAN;
+            if (i < idxEnd) {
+                const positionTy& pos = posDeque[i];
+                XPLMWorldToLocal(pos.lat(), pos.lon(), pos.alt_m(),
+                                 &pt_x, &pt_y, &pt_z);
+                FindMatchCandidates(pos, pt_x, pt_z, maxDist_m,
+                                    trellis.empty() ? nullptr : &trellis.back(),
+                                    vecCand);
+            }
+            
+            // No candidates (or end of window): conclude the path found so far
+            if (vecCand.empty()) {
+                cntMatched += ApplyMatch(posDeque, idxSeg, trellis, nFixed, vY, vecIns);
+                trellis.clear();
+                vX.clear(); vY.clear(); vZ.clear();
+                idxSeg = i+1;
+                nFixed = 0;
+                continue;
+            }
+            
+            // Viterbi step: find cheapest predecessor per candidate
+            if (!trellis.empty()) {
+                const vecMatchCandTy& vecPrev = trellis.back();
+                const double dPos = std::hypot(pt_x - vX.back(), pt_z - vZ.back());
+                for (MatchCandTy& c: vecCand) {
+                    double bestCost = HUGE_VAL;
+                    for (size_t j = 0; j < vecPrev.size(); ++j) {
+                        const MatchCandTy& p = vecPrev[j];
+                        size_t n = 0;
+                        double cost = p.cost;
+                        if (p.pEdge != c.pEdge)
+                            cost += SharedNode(*p.pEdge, *c.pEdge, n) ? ART_MATCH_ADJ_COST : ART_MATCH_JUMP_COST;
+                        cost += std::abs(std::hypot(c.x - p.x, c.z - p.z) - dPos) / maxDist_m;
+                        if (cost < bestCost) {
+                            bestCost = cost;
+                            c.prev = j;
+                        }
+                    }
+                    c.cost += bestCost;
+                }
+            }
+            
+            trellis.emplace_back(std::move(vecCand));
+            vX.push_back(pt_x);
+            vY.push_back(pt_y);
+            vZ.push_back(pt_z);
+        }
+        
+        return cntMatched;
+    }
+    
+    /// @brief Backtrack the cheapest path through the trellis and move positions onto it
+    /// @param posDeque The track
+    /// @param idxSeg Index of the position matching the first trellis entry
+    /// @param trellis Candidates per position as computed by MatchTrack
+    /// @param nFixed Number of fixed states at the beginning of the trellis, their positions are not moved
+    /// @param vY Local y coordinates of the positions, needed to convert back to world coordinates
+    /// @param[out] vecIns Receives positions to be inserted at taxi nodes
+    /// @return Number of positions changed
+    int ApplyMatch (dequePositionTy& posDeque,
+                    size_t idxSeg,
+                    const std::vector<vecMatchCandTy>& trellis,
+                    size_t nFixed,
+                    const std::vector<double>& vY,
+                    vecPosInsertTy& vecIns) const
+    {
+        if (trellis.size() <= nFixed)
+            return 0;
+        
+        // Backtrack from the cheapest final candidate
+        std::vector<const MatchCandTy*> path(trellis.size(), nullptr);
+        const vecMatchCandTy& last = trellis.back();
+        const MatchCandTy* pC = &*std::min_element(last.begin(), last.end(),
+                                                   [](const MatchCandTy& a, const MatchCandTy& b)
+                                                   { return a.cost < b.cost; });
+        for (size_t k = trellis.size(); k-- > 0; ) {
+            path[k] = pC;
+            if (k > 0)
+                pC = &trellis[k-1][pC->prev];
+        }
+        
+        // Move positions onto their edges (the fixed ones already are)
+        for (size_t k = nFixed; k < path.size(); ++k) {
+            positionTy& pos = posDeque[idxSeg+k];
+            double lat = NAN, lon = NAN, alt = NAN;
+            XPLMLocalToWorld(path[k]->x, vY[k], path[k]->z, &lat, &lon, &alt);
+            pos.lat() = lat;
+            pos.lon() = lon;
+            // now moving along the edge
+            pos.heading() = EdgeHeading(*path[k]->pEdge, pos.heading());
+            // see SnapToTaxiway: we don't mark positions on a runway
+            if (path[k]->pEdge->GetType() != TaxiEdge::RUN_WAY)
+                pos.flightPhase = LTAPIAircraft::FPH_TAXI;
+        }
+        
+        // Propose positions at nodes where the path turns into an adjacent edge
+        for (size_t k = 1; k < path.size(); ++k) {
+            size_t n = 0;
+            if (path[k-1]->pEdge == path[k]->pEdge ||
+                !SharedNode(*path[k-1]->pEdge, *path[k]->pEdge, n))
+                continue;
+            
+            const TaxiNode& node = vecTaxiNodes[n];
+            const positionTy& p1 = posDeque[idxSeg+k-1];
+            const positionTy& p2 = posDeque[idxSeg+k];
+            const double d1 = DistLatLon(p1.lat(), p1.lon(), node.lat, node.lon);
+            const double d2 = DistLatLon(node.lat, node.lon, p2.lat(), p2.lon());
+            if (d1 + d2 <= 0.0)
+                continue;
+            const double f = d1 / (d1 + d2);
+            const double ts = p1.ts() + f * (p2.ts() - p1.ts());
+            if (ts - p1.ts() < ART_MATCH_MIN_TS_GAP ||
+                p2.ts() - ts < ART_MATCH_MIN_TS_GAP)
+                continue;
+            
+            vecIns.emplace_back(idxSeg+k,
+                                positionTy(node.lat, node.lon,
+                                           p1.alt_m() + f * (p2.alt_m() - p1.alt_m()),
+                                           ts,
+                                           // turning into the next edge here
+                                           EdgeHeading(*path[k]->pEdge, p2.heading()),
+                                           0.0, 0.0,
+                                           positionTy::GND_ON,
+                                           positionTy::UNIT_WORLD, positionTy::UNIT_DEG,
+                                           LTAPIAircraft::FPH_TAXI));
+        }
+        
+        return int(path.size() - nFixed);
+    }
+    
     // --- MARK: Runways
     
     /// The vector of runway endpoints
@@ -578,6 +994,21 @@ public:
     /// Enlarge the bounding box by a few meters
     void EnlargeBounds_m (double meter) { bounds.enlarge_m(meter); }
     
+    // --- MARK: Memory
+    
+    /// Estimated memory usage [bytes], excluding the map node
+    size_t MemUsage () const
+    {
+        size_t n = sizeof(Apt) + id.capacity() +
+        vecTaxiNodes.capacity() * sizeof(TaxiNode) +
+        vecRwyEndPts.capacity() * sizeof(RwyEndPt) +
+        vecTaxiEdges.capacity() * sizeof(TaxiEdge) +
+        vecNodeEdges.capacity() * sizeof(vecNodeEdgesTy::value_type);
+        for (const vecNodeEdgesTy::value_type& v: vecNodeEdges)
+            n += v.capacity() * sizeof(size_t);
+        return n;
+    }
+    
     // --- MARK: Static Functions
     
     /// @brief Add airport to list of airports
@@ -616,6 +1047,9 @@ void Apt::AddApt (Apt&& apt)
               apt.vecTaxiEdges.end(),
               TaxiEdge::CompHeadLess);
     
+    // Now that edge indexes are final we can note which edges meet at which node
+    apt.BuildNodeEdges();
+    
     // Fancy debug-level logging message, listing all runways
     LOG_MSG(logDEBUG, "apt.dat: Added %s at %s with %lu runways (%s) and [%lu|%lu] taxi nodes|edges",
             apt.GetId().c_str(),
@@ -1298,10 +1732,71 @@ bool LTAptSnap (positionTy& pos, bool bLogging)
         return false;
 
     // Let's snap!
-    return pApt->SnapToTaxiway(pos, bLogging);
+    return pApt->SnapToTaxiway(pos, bLogging) != nullptr;
 }
 
 
+// Map-matches all ground positions of a track onto the rwy and taxiway network
+int LTAptSnapTrack (dequePositionTy& posDeque, bool bLogging)
+{
+    // Configured off?
+    if (dataRefs.GetFdSnapTaxiDist_m() <= 0 || posDeque.empty())
+        return 0;
+    
+    // Access to the list of airports is guarded by a lock
+    std::lock_guard<std::mutex> lock(mtxGMapApt);
+    
+    int cntMatched = 0;
+    vecPosInsertTy vecIns;                      // positions to insert at taxi nodes
+    const Apt* pApt = nullptr;                  // airport of the current window
+    size_t idxBegin = 0;                        // begin of current window
+    for (size_t i = 0; i <= posDeque.size(); ++i)
+    {
+        // Only positions on the ground, which have (not yet) been artificially added,
+        // and which stay within the same airport make up a window
+        const positionTy* pPos = i < posDeque.size() ? &posDeque[i] : nullptr;
+        const bool bEligible = pPos && pPos->IsOnGnd() && pPos->flightPhase == 0;
+        if (bEligible && pApt && pApt->Contains(*pPos))
+            continue;                           // extends the current window
+        
+        // conclude current window, continuing from the position before
+        // if that one has been matched already
+        if (pApt) {
+            const positionTy* pPrev = idxBegin > 0 ? &posDeque[idxBegin-1] : nullptr;
+            const bool bAnchor = pPrev && pPrev->IsOnGnd() &&
+                                 pPrev->flightPhase == LTAPIAircraft::FPH_TAXI &&
+                                 pApt->Contains(*pPrev);
+            cntMatched += pApt->MatchTrack(posDeque, idxBegin, i, bAnchor, vecIns);
+        }
+        
+        // Which airport are we looking at? Only search again if we left the previous one
+        pApt = bEligible ? LTAptFind(*pPos) : nullptr;
+        idxBegin = i;
+    }
+    
+    // Insert positions at taxi nodes, from the back so indexes stay valid
+    for (auto iter = vecIns.rbegin(); iter != vecIns.rend(); ++iter)
+        posDeque.insert(posDeque.begin() + iter->first, iter->second);
+    
+    if (bLogging && cntMatched > 0) {
+        LOG_MSG(logDEBUG, "Map-matched %d positions to taxiways, inserted %lu positions at taxi nodes",
+                cntMatched, vecIns.size());
+    }
+    
+    return cntMatched + int(vecIns.size());
+}
+
+
+// Estimated memory usage of all loaded airports
+size_t LTAptMemUsage ()
+{
+    size_t n = 0;
+    std::lock_guard<std::mutex> lock(mtxGMapApt);
+    for (const mapAptTy::value_type& p: gmapApt)
+        n += p.second.MemUsage() + p.first.capacity() + MEM_MAP_NODE_OVERHEAD;
+    return n;
+}
+
 // Cleanup
 void LTAptDisable ()
 {
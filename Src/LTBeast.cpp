@@ -0,0 +1,301 @@
+/// @file       LTBeast.cpp
+/// @brief      Beast: Receives raw Mode-S frames in Beast binary format from a local ADS-B receiver
+/// @see        https://github.com/firestuff/adsb-tools/blob/master/protocols/beast.md
+/// @see        The 1090MHz Riddle, https://mode-s.org/decode/
+/// @details    Implements BeastConnection:\n
+///             - Keeps a TCP connection to a receiver like dump1090 (default port 30005)\n
+///             - Unescapes Beast frames, verifies CRC-24 of DF17/18 extended squitter\n
+///             - Decodes identification, airborne/surface position (CPR), and velocity\n
+///             - Passes complete updates on to LTFlightData.\n
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+//
+// MARK: Decoding helpers
+//
+
+/// Character set of the identification message
+static const char AIS_CHARSET[] = "#ABCDEFGHIJKLMNOPQRSTUVWXYZ##### ###############0123456789######";
+
+/// Ground speed [kn] from the movement field of a surface position
+static double beastMovement (int mov)
+{
+    if (mov == 0)   return NAN;         // not available
+    if (mov == 1)   return 0.0;         // stopped
+    if (mov <= 8)   return 0.125 + (mov -   2) * 0.125;
+    if (mov <= 12)  return   1.0 + (mov -   9) * 0.25;
+    if (mov <= 38)  return   2.0 + (mov -  13) * 0.5;
+    if (mov <= 93)  return  15.0 + (mov -  39) * 1.0;
+    if (mov <= 108) return  70.0 + (mov -  94) * 2.0;
+    if (mov <= 123) return 100.0 + (mov - 109) * 5.0;
+    if (mov == 124) return 175.0;
+    return NAN;                         // 125-127: reserved
+}
+
+//
+// MARK: Beast Connection
+//
+
+BeastConnection::BeastConnection (mapLTFlightDataTy& _fdMap) :
+LTChannel(DR_CHANNEL_BEAST_ONLINE),
+RcvrConnection(_fdMap)
+{}
+
+// Unregister before we are gone, handlers call our virtual functions
+BeastConnection::~BeastConnection ()
+{
+    StopConnection();
+}
+
+std::string BeastConnection::GetHost () const
+{
+    return dataRefs.GetBeastHost();
+}
+
+int BeastConnection::GetPort () const
+{
+    return DataRefs::GetCfgInt(DR_CFG_BEAST_PORT);
+}
+
+// Unescapes all complete frames in the receive buffer, keeps an incomplete rest
+// A frame is: <esc> <type> <6 bytes MLAT timestamp> <1 byte signal> <message>,
+// with any <esc> inside the frame doubled
+void BeastConnection::ProcessRcvBuf (double now)
+{
+    const uint8_t* const buf = reinterpret_cast<const uint8_t*>(rcvBuf);
+    size_t i = 0;                       // start of current frame
+    while (i < rcvLen)
+    {
+        // search for the start of a frame
+        if (buf[i] != BEAST_ESC) {
+            ++i;
+            continue;
+        }
+        if (i + 1 >= rcvLen)            // need more data
+            break;
+
+        // frame type defines length, we only decode long Mode-S frames
+        const uint8_t type = buf[i+1];
+        const size_t msgLen =
+        type == BEAST_TYPE_MODE_AC      ? 2 :
+        type == BEAST_TYPE_MODE_S_SHORT ? 7 :
+        type == BEAST_TYPE_MODE_S_LONG  ? MODES_LONG_LEN : 0;
+        if (!msgLen) {                  // unknown type: resync
+            ++i;
+            continue;
+        }
+
+        // unescape the frame
+        uint8_t frame[BEAST_HEADER_LEN + MODES_LONG_LEN];
+        const size_t frameLen = BEAST_HEADER_LEN + msgLen;
+        size_t n = 0;
+        size_t j = i + 2;
+        bool bBroken = false;
+        while (n < frameLen && j < rcvLen) {
+            if (buf[j] == BEAST_ESC) {
+                if (j + 1 >= rcvLen)    // can't tell yet
+                    break;
+                if (buf[j+1] != BEAST_ESC) {
+                    bBroken = true;     // start of next frame inside this one
+                    break;
+                }
+                ++j;
+            }
+            frame[n++] = buf[j++];
+        }
+
+        if (bBroken) {                  // resync at the next frame start
+            i = j;
+            continue;
+        }
+        if (n < frameLen)               // incomplete: wait for more data
+            break;
+
+        if (type == BEAST_TYPE_MODE_S_LONG)
+            ProcessModeS(frame + BEAST_HEADER_LEN, now);
+        i = j;
+    }
+
+    // move an incomplete rest to the front of the buffer
+    rcvLen -= i;
+    if (rcvLen >= sizeof(rcvBuf))       // buffer full without complete frame: discard the garbage
+        rcvLen = 0;
+    else if (rcvLen > 0 && i > 0)
+        memmove(rcvBuf, rcvBuf + i, rcvLen);
+}
+
+// Decodes one Mode-S long frame
+void BeastConnection::ProcessModeS (const uint8_t* msg, double now)
+{
+    // only ADS-B extended squitter with ICAO address
+    const int df = msg[0] >> 3;
+    if (df != 17 && !(df == 18 && (msg[0] & 0x07) == 0))
+        return;
+
+    // verify parity
+    const uint32_t parity = (uint32_t(msg[11]) << 16) | (uint32_t(msg[12]) << 8) | msg[13];
+    if (ModeSCrc(msg, MODES_LONG_LEN - 3) != parity) {
+        ++cntCrcErr;
+        return;
+    }
+
+    // the aircraft's transponder code
+    const unsigned long numId = ((unsigned long)msg[1] << 16) | ((unsigned long)msg[2] << 8) | msg[3];
+    if (numId == 0)
+        return;
+
+    // aggregation state of this aircraft
+    AcStateTy& ac = mapAcState[numId];
+    ac.lastRcvd = now;
+
+    // the ME field and its type code
+    const uint8_t* me = msg + 4;
+    const int tc = me[0] >> 3;
+
+    // *** Identification ***
+    if (1 <= tc && tc <= 4)
+    {
+        const uint64_t bits =
+        (uint64_t(me[1]) << 40) | (uint64_t(me[2]) << 32) | (uint64_t(me[3]) << 24) |
+        (uint64_t(me[4]) << 16) | (uint64_t(me[5]) <<  8) |  uint64_t(me[6]);
+        char call[9];
+        for (int c = 0; c < 8; ++c)
+            call[c] = AIS_CHARSET[(bits >> (42 - 6*c)) & 0x3F];
+        call[8] = '\0';
+        // trim trailing spaces and invalid characters
+        for (int c = 7; c >= 0 && (call[c] == ' ' || call[c] == '#'); --c)
+            call[c] = '\0';
+        if (ac.call != call)
+            ac.call = call;
+    }
+
+    // *** Airborne velocity ***
+    else if (tc == 19)
+    {
+        const int st = me[0] & 0x07;
+        const double factor = (st == 2 || st == 4) ? 4.0 : 1.0;      // supersonic
+        if (st == 1 || st == 2) {       // ground speed
+            const int vEW = ((me[1] & 0x03) << 8) | me[2];
+            const int vNS = ((me[3] & 0x7F) << 3) | (me[4] >> 5);
+            if (vEW && vNS) {
+                const double vx = (vEW - 1) * factor * ((me[1] & 0x04) ? -1.0 : 1.0);
+                const double vy = (vNS - 1) * factor * ((me[3] & 0x80) ? -1.0 : 1.0);
+                ac.spd = std::sqrt(vx*vx + vy*vy);
+                ac.trk = HeadingNormalize(rad2deg(std::atan2(vx, vy)));
+            }
+        }
+        else if (st == 3 || st == 4) {  // airspeed and heading
+            if (me[1] & 0x04)
+                ac.trk = (((me[1] & 0x03) << 8) | me[2]) * 360.0 / 1024.0;
+            const int as = ((me[3] & 0x7F) << 3) | (me[4] >> 5);
+            if (as)
+                ac.spd = (as - 1) * factor;
+        }
+        const int vr = ((me[4] & 0x07) << 6) | (me[5] >> 2);
+        if (vr)
+            ac.vsi = (vr - 1) * 64.0 * ((me[4] & 0x08) ? -1.0 : 1.0);
+    }
+
+    // *** Surface or airborne position ***
+    else if ((5 <= tc && tc <= 18) || (20 <= tc && tc <= 22))
+    {
+        const bool bSurface = tc <= 8;
+        if (bSurface) {
+            ac.gnd = true;
+            const double spd = beastMovement(((me[0] & 0x07) << 4) | (me[1] >> 4));
+            if (!std::isnan(spd))
+                ac.spd = spd;
+            if (me[1] & 0x08)           // track valid?
+                ac.trk = (((me[1] & 0x07) << 4) | (me[2] >> 4)) * 360.0 / 128.0;
+        } else {
+            ac.gnd = false;
+            const int alt12 = (me[1] << 4) | (me[2] >> 4);
+            if (tc >= 20)               // GNSS height in meters
+                ac.alt_ft = alt12 / M_per_FT;
+            else if (alt12 & 0x10)      // 25ft increments (Q bit set), Gillham coding not supported
+                ac.alt_ft = ((((alt12 & 0xFE0) >> 1) | (alt12 & 0x0F)) * 25.0) - 1000.0;
+        }
+
+        // store the CPR encoded position
+        CprStateTy& st = mapCpr[numId];
+        CprTy cpr;
+        const int odd = CprFromME(me, cpr);
+        cpr.ts = now;
+        st.cpr[odd] = cpr;
+
+        // decode, and if successful pass it on
+        double lat = NAN, lon = NAN;
+        if (DecodeCpr(st, odd, now, lat, lon)) {
+            st.lat = lat;
+            st.lon = lon;
+            st.ts = now;
+            AddUpdate(numId, ac, lat, lon, now);
+        }
+    }
+}
+
+// Decodes a CPR position, either globally from an even/odd pair or locally from a reference
+bool BeastConnection::DecodeCpr (CprStateTy& st, int odd, double now,
+                                 double& lat, double& lon)
+{
+    const CprTy& cur   = st.cpr[odd];
+    const CprTy& other = st.cpr[1-odd];
+
+    // reference: our last decoded position if recent enough, otherwise the camera
+    const bool bOwnRef = !std::isnan(st.lat) && st.ts + CPR_MAX_LOCAL_AGE >= now;
+    const double refLat = bOwnRef ? st.lat : viewPos.lat();
+    const double refLon = bOwnRef ? st.lon : viewPos.lon();
+    const double maxDist = cur.bSurface ? CPR_MAX_LOCAL_DIST_SURF : CPR_MAX_LOCAL_DIST_AIRB;
+    const bool bRefValid = !std::isnan(refLat) && !std::isnan(refLon);
+
+    // surface positions are ambiguous without any reference
+    if (cur.bSurface && !bRefValid)
+        return false;
+
+    // global decoding from a recent pair of the same kind
+    if (other.ts > 0.0 && other.bSurface == cur.bSurface &&
+        cur.ts - other.ts <= CPR_MAX_PAIR_INTVL &&
+        CprGlobal(st.cpr[0], st.cpr[1], odd, refLat, refLon, lat, lon))
+    {
+        // plausible compared to our previous position?
+        if (!bOwnRef || DistLatLonSqr(lat, lon, refLat, refLon) <= maxDist * maxDist)
+            return true;
+    }
+
+    // local decoding requires a reference we can trust,
+    // for airborne positions only our own previous position is close enough
+    if (!bRefValid || (!cur.bSurface && !bOwnRef))
+        return false;
+    CprLocal(cur, odd, refLat, refLon, lat, lon);
+    return DistLatLonSqr(lat, lon, refLat, refLon) <= maxDist * maxDist;
+}
+
+// Also removes outdated CPR states
+void BeastConnection::CommitAndCleanup (double now)
+{
+    RcvrConnection::CommitAndCleanup(now);
+    for (mapCprStateTy::iterator it = mapCpr.begin(); it != mapCpr.end(); )
+    {
+        if (mapAcState.count(it->first) == 0)
+            it = mapCpr.erase(it);
+        else
+            ++it;
+    }
+}
@@ -0,0 +1,160 @@
+/// @file       LTBeastDecode.cpp
+/// @brief      Beast: Static Mode-S decoding functions (CRC-24, CPR)
+/// @see        The 1090MHz Riddle, https://mode-s.org/decode/
+/// @details    Kept apart from the network part of BeastConnection
+///             so that they can be tested stand-alone, see Test/LTBeastTest.cpp.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+//
+// MARK: Decoding helpers
+//
+
+/// Computes the CRC-24 lookup table at compile time
+static constexpr std::array<uint32_t,256> ModeSCrcTable ()
+{
+    std::array<uint32_t,256> t {};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i << 16;
+        for (int b = 0; b < 8; ++b)
+            c = (c & 0x800000) ? ((c << 1) ^ MODES_CRC_POLY) : (c << 1);
+        t[i] = c & 0xFFFFFF;
+    }
+    return t;
+}
+
+/// CRC-24 lookup table, one entry per byte value
+static constexpr std::array<uint32_t,256> MODES_CRC_TABLE = ModeSCrcTable();
+
+/// Modulo, which always returns a positive value
+inline double cprMod (double a, double b)
+{
+    const double r = std::fmod(a, b);
+    return r < 0.0 ? r + b : r;
+}
+
+//
+// MARK: Static decoding functions
+//
+
+// Calculates the Mode-S CRC-24 over the first len bytes
+uint32_t BeastConnection::ModeSCrc (const uint8_t* msg, size_t len)
+{
+    uint32_t crc = 0;
+    for (size_t i = 0; i < len; ++i)
+        crc = ((crc << 8) ^ MODES_CRC_TABLE[((crc >> 16) ^ msg[i]) & 0xFF]) & 0xFFFFFF;
+    return crc;
+}
+
+// Extracts the CPR encoded position from the ME field of a position message
+int BeastConnection::CprFromME (const uint8_t* me, CprTy& cpr)
+{
+    cpr.lat = (uint32_t(me[2] & 0x03) << 15) | (uint32_t(me[3]) << 7) | (me[4] >> 1);
+    cpr.lon = (uint32_t(me[4] & 0x01) << 16) | (uint32_t(me[5]) << 8) | me[6];
+    cpr.bSurface = (me[0] >> 3) <= 8;   // type codes 5-8 are surface positions
+    return (me[2] >> 2) & 0x01;
+}
+
+// Number of longitude zones at given latitude
+int BeastConnection::CprNL (double lat)
+{
+    lat = std::abs(lat);
+    if (lat < 1e-9)     return 59;
+    if (lat >= 87.0)    return lat > 87.0 ? 1 : 2;
+    const double a = 1.0 - std::cos(PI / (2.0 * CPR_NZ));
+    const double b = std::cos(deg2rad(lat));
+    return int(std::floor(2.0 * PI / std::acos(1.0 - a / (b*b))));
+}
+
+// Global CPR decoding from an even/odd pair, newer tells which is the newer one
+bool BeastConnection::CprGlobal (const CprTy& even, const CprTy& odd, int newer,
+                                 double refLat, double refLon,
+                                 double& lat, double& lon)
+{
+    const bool bSurface = even.bSurface;
+    const double range = bSurface ? 90.0 : 360.0;
+    const double latE = even.lat / CPR_MAX;
+    const double latO = odd.lat  / CPR_MAX;
+    const double lonE = even.lon / CPR_MAX;
+    const double lonO = odd.lon  / CPR_MAX;
+
+    // latitude index and both latitudes
+    const double j = std::floor(59.0 * latE - 60.0 * latO + 0.5);
+    double rlatE = range / 60.0 * (cprMod(j, 60.0) + latE);
+    double rlatO = range / 59.0 * (cprMod(j, 59.0) + latO);
+    if (bSurface) {
+        // northern or southern solution, whichever is closer to the reference
+        if (std::abs(refLat - (rlatE - 90.0)) < std::abs(refLat - rlatE)) rlatE -= 90.0;
+        if (std::abs(refLat - (rlatO - 90.0)) < std::abs(refLat - rlatO)) rlatO -= 90.0;
+    } else {
+        if (rlatE >= 270.0) rlatE -= 360.0;
+        if (rlatO >= 270.0) rlatO -= 360.0;
+    }
+    if (rlatE < -90.0 || rlatE > 90.0 || rlatO < -90.0 || rlatO > 90.0)
+        return false;
+
+    // both positions must be in the same longitude zone
+    const int nl = CprNL(rlatE);
+    if (nl != CprNL(rlatO))
+        return false;
+
+    // longitude based on the newer frame
+    lat = newer ? rlatO : rlatE;
+    const int ni = std::max(nl - newer, 1);
+    const double m = std::floor(lonE * (nl - 1) - lonO * nl + 0.5);
+    lon = range / ni * (cprMod(m, ni) + (newer ? lonO : lonE));
+    if (bSurface) {
+        // 4 possible solutions 90 degrees apart, take the one closest to the reference
+        double bestLon = lon, bestDiff = 360.0;
+        for (int k = 0; k < 4; ++k) {
+            double cand = lon + k * 90.0;
+            while (cand >= 180.0) cand -= 360.0;
+            const double diff = std::abs(HeadingDiff(cand, refLon));
+            if (diff < bestDiff) {
+                bestDiff = diff;
+                bestLon = cand;
+            }
+        }
+        lon = bestLon;
+    }
+    else if (lon >= 180.0)
+        lon -= 360.0;
+
+    return true;
+}
+
+// Local CPR decoding from one frame relative to a reference position
+void BeastConnection::CprLocal (const CprTy& cpr, int odd,
+                                double refLat, double refLon,
+                                double& lat, double& lon)
+{
+    const double range = cpr.bSurface ? 90.0 : 360.0;
+    const double dLat = range / (60.0 - odd);
+    const double yz = cpr.lat / CPR_MAX;
+    const double j = std::floor(refLat / dLat) +
+                     std::floor(0.5 + cprMod(refLat, dLat) / dLat - yz);
+    lat = dLat * (j + yz);
+
+    const double dLon = range / std::max(CprNL(lat) - odd, 1);
+    const double xz = cpr.lon / CPR_MAX;
+    const double m = std::floor(refLon / dLon) +
+                     std::floor(0.5 + cprMod(refLon, dLon) / dLon - xz);
+    lon = dLon * (m + xz);
+}
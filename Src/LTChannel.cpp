@@ -48,6 +48,7 @@ std::thread CalcPosThread;              // the thread for pos calc (TriggerCalcN
 std::mutex  FDThreadSynchMutex;         // supports wake-up and stop synchronization
 std::condition_variable FDThreadSynchCV;
 volatile bool bFDMainStop = true;       // will be reset once the main thread starts
+volatile bool bFDWakeup = false;        // wake up the main thread early for a new cycle, e.g. after settings changes
 
 // the global vector of all flight and master data connections
 listPtrLTChannelTy    listFDC;
@@ -193,6 +194,411 @@ void LTChannel::SetEnable (bool bEnable)
     dataRefs.SetChannelEnabled(channel,bEnable);
 }
 
+// system time, corrected the same way as sim time is
+double LTChannel::NetNow ()
+{
+    return
+    // system time in seconds
+    LTClock::SysNow()
+    // corrected by network time diff (which only works if also OpenSky or ADSBEx are active)
+    + dataRefs.GetChTsOffset();
+}
+
+//
+//MARK: Latency Statistics
+//
+
+/// latency statistics per channel
+static LatencyStatTy latStat[CNT_DR_CHANNELS];
+/// latency statistics of all channels combined
+static LatencyStatTy latStatAll;
+
+void LatencyHistTy::Add (double lat)
+{
+    if (std::isnan(lat))
+        return;
+    if (lat < 0.0)
+        lat = 0.0;
+    const size_t b = std::min(size_t(lat / LAT_HIST_BUCKET), LAT_HIST_BUCKETS-1);
+    std::lock_guard<std::mutex> lock(mtx);
+    hist[b]++;
+    cnt++;
+    sum += lat;
+    if (lat > maxVal)
+        maxVal = lat;
+}
+
+void LatencyHistTy::clear ()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    hist.fill(0);
+    cnt = 0;
+    sum = maxVal = 0.0;
+}
+
+unsigned LatencyHistTy::Count () const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return cnt;
+}
+
+double LatencyHistTy::Avg () const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return cnt ? sum / cnt : NAN;
+}
+
+double LatencyHistTy::Max () const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return cnt ? maxVal : NAN;
+}
+
+// walks the buckets until the requested share is reached,
+// returns the upper bound of that bucket (but not more than the max value)
+double LatencyHistTy::Percentile (double p) const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!cnt)
+        return NAN;
+    const double need = p * cnt;
+    unsigned n = 0;
+    for (size_t b = 0; b < LAT_HIST_BUCKETS; ++b) {
+        n += hist[b];
+        if (n >= need && n > 0)
+            return std::min((b+1) * LAT_HIST_BUCKET, maxVal);
+    }
+    return maxVal;
+}
+
+std::string LatencyHistTy::Summary () const
+{
+    char s[100];
+    snprintf(s, sizeof(s), INFO_LATENCY_SUMMARY,
+             Count(), Avg(), Percentile(0.5), Percentile(0.95), Max());
+    return s;
+}
+
+// records both latencies with the channel and all channels combined
+void LTLatencyAdd (const positionTy& pos, double now)
+{
+    if (std::isnan(pos.rcvTs))
+        return;
+    const double rcvDisp = now - pos.rcvTs;
+    const double dispDelay = now - pos.ts();
+    if (DR_CHANNEL_FIRST <= pos.rcvCh && pos.rcvCh <= DR_CHANNEL_LAST) {
+        LatencyStatTy& st = latStat[pos.rcvCh - DR_CHANNEL_FIRST];
+        st.rcvDisp.Add(rcvDisp);
+        st.dispDelay.Add(dispDelay);
+    }
+    latStatAll.rcvDisp.Add(rcvDisp);
+    latStatAll.dispDelay.Add(dispDelay);
+}
+
+const LatencyStatTy& LTLatencyGet (int ch)
+{
+    if (DR_CHANNEL_FIRST <= ch && ch <= DR_CHANNEL_LAST)
+        return latStat[ch - DR_CHANNEL_FIRST];
+    return latStatAll;
+}
+
+void LTLatencyLog ()
+{
+    if (!latStatAll.rcvDisp.Count())
+        return;
+    for (const ptrLTChannelTy& p: listFDC) {
+        const LatencyStatTy& st = LTLatencyGet(p->GetChannel());
+        if (st.rcvDisp.Count())
+            LOG_MSG(logINFO, INFO_LATENCY, p->ChName(),
+                    st.rcvDisp.Summary().c_str(),
+                    st.dispDelay.Summary().c_str());
+    }
+    LOG_MSG(logINFO, INFO_LATENCY, INFO_LATENCY_ALL,
+            latStatAll.rcvDisp.Summary().c_str(),
+            latStatAll.dispDelay.Summary().c_str());
+}
+
+void LTLatencyReset ()
+{
+    for (LatencyStatTy& st: latStat) {
+        st.rcvDisp.clear();
+        st.dispDelay.clear();
+    }
+    latStatAll.rcvDisp.clear();
+    latStatAll.dispDelay.clear();
+}
+
+// Sum of updates and longest lock time of all channels' last commit
+void LTCommitStatGet (size_t& cnt, double& lock_ms)
+{
+    cnt = 0;
+    lock_ms = 0.0;
+    for (const ptrLTChannelTy& p: listFDC) {
+        const LTFlightDataChannel* pFdCh = dynamic_cast<const LTFlightDataChannel*>(p.get());
+        if (pFdCh && pFdCh->IsEnabled()) {
+            cnt += pFdCh->GetLastCommitCnt();
+            lock_ms = std::max(lock_ms, pFdCh->GetLastCommitLock_ms());
+        }
+    }
+}
+
+//
+//MARK: Memory Accounting
+//
+
+/// memory usage per subsystem [bytes] as of the last check
+static std::atomic<size_t> memUsage[MEM_TOTAL];
+/// memory budget exceeded after evicting all we could? (flight data thread then trims raw buffers)
+static std::atomic<bool> bMemOverBudget(false);
+
+size_t LTMemUsage (LTMemSubsysTy sub)
+{
+    if (0 <= sub && sub < MEM_TOTAL)
+        return memUsage[sub];
+    // total
+    size_t n = 0;
+    for (const std::atomic<size_t>& m: memUsage)
+        n += m;
+    return n;
+}
+
+// Updates usage of raw buffers and master data, called from the flight data thread,
+// which owns these buffers
+static void LTFlightDataMemChannels ()
+{
+    size_t raw = 0;
+    size_t md = LTACMasterdataChannel::GetRequestListSize();
+    for (ptrLTChannelTy& p: listFDC) {
+        if (bMemOverBudget)
+            p->TrimRawBuf();
+        raw += p->GetRawBufSize();
+        md  += p->GetMasterDataSize();
+    }
+    memUsage[MEM_RAW_BUF] = raw;
+    memUsage[MEM_MASTER_DATA] = md;
+}
+
+// Updates usage of flight data and position buffers, enforces the budget
+void LTFlightDataMemCheck ()
+{
+    // only every MEM_CHECK_INTVL seconds
+    static LTClock::time_point nextCheck;
+    const LTClock::time_point now = LTClock::now();
+    if (now < nextCheck)
+        return;
+    nextCheck = now + std::chrono::duration_cast<LTClock::duration>
+    (std::chrono::duration<double>(MEM_CHECK_INTVL));
+    
+    // airport data is guarded by its own lock
+    memUsage[MEM_AIRPORTS] = LTAptMemUsage();
+    
+    /// A flight data object, which could be removed to save memory
+    struct EvictCandTy {
+        LTFlightData::FDKeyTy key;
+        double dist;            ///< [m] distance to camera, infinite if no position
+        size_t bytes;           ///< memory used
+    };
+    std::vector<EvictCandTy> vecCand;
+    
+    try {
+        // access guarded by the fd mutex
+        std::lock_guard<std::mutex> lock (mapFdMutex);
+        const positionTy viewPos = dataRefs.GetViewPos();
+        
+        // sum up flight data and position buffers
+        size_t fdTotal = 0, posTotal = 0;
+        for (mapLTFlightDataTy::value_type& fdPair: mapFd)
+        {
+            LTFlightData& fd = fdPair.second;
+            std::lock_guard<std::recursive_mutex> fdLock (fd.dataAccessMutex);
+            size_t fdBytes = 0, posBytes = 0;
+            fd.MemUsage(fdBytes, posBytes);
+            fdTotal  += fdBytes;
+            posTotal += posBytes;
+            
+            // aircraft not displayed can be removed
+            if (!fd.hasAc()) {
+                const dequePositionTy& posDeque = fd.GetPosDeque();
+                vecCand.push_back({fdPair.first,
+                                   posDeque.empty() ? HUGE_VAL : viewPos.dist(posDeque.back()),
+                                   fdBytes + posBytes});
+            }
+        }
+        memUsage[MEM_FLIGHT_DATA] = fdTotal;
+        memUsage[MEM_POS_BUF] = posTotal;
+        
+        // budget exceeded?
+        const int budget_MB = dataRefs.GetFdMemBudget_MB();
+        const size_t budget = size_t(budget_MB) * 1024 * 1024;
+        size_t total = LTMemUsage(MEM_TOTAL);
+        if (!budget || total <= budget) {
+            bMemOverBudget = false;
+            return;
+        }
+        
+        // remove farthest aircraft first
+        const size_t totalBefore = total;
+        std::sort(vecCand.begin(), vecCand.end(),
+                  [](const EvictCandTy& a, const EvictCandTy& b){ return a.dist > b.dist; });
+        int cntEvicted = 0;
+        for (const EvictCandTy& c: vecCand) {
+            if (total <= budget)
+                break;
+            mapFd.erase(c.key);
+            wheelFdMaint.Remove(c.key);
+            total -= std::min(total, c.bytes);
+            cntEvicted++;
+        }
+        if (cntEvicted > 0)
+            LOG_MSG(logINFO, INFO_MEM_EVICTED, budget_MB, cntEvicted,
+                    double(totalBefore) / (1024*1024), double(total) / (1024*1024));
+        
+        // still too much? Then trim buffers
+        if (total > budget) {
+            for (mapLTFlightDataTy::value_type& fdPair: mapFd) {
+                std::lock_guard<std::recursive_mutex> fdLock (fdPair.second.dataAccessMutex);
+                fdPair.second.TrimBuffers();
+            }
+            // warn only once while over budget
+            if (!bMemOverBudget)
+                LOG_MSG(logWARN, WARN_MEM_OVER_BUDGET, budget_MB, double(total) / (1024*1024));
+            bMemOverBudget = true;
+        } else
+            bMemOverBudget = false;
+        
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
+    }
+}
+
+//
+//MARK: LTFlightDataChannel
+//
+
+// Early reject of a tracking data record, based on key and position only
+bool LTFlightDataChannel::IsRecordOfInterest (const LTFlightData::FDKeyTy& key,
+                                              const std::string& acFilter,
+                                              const positionTy& viewPos,
+                                              double lat, double lon, double alt_m)
+{
+    // not matching a/c filter?
+    if (!acFilter.empty() && key != acFilter)
+        return false;
+    
+    // Records without position are passed on as they might still carry useful static data
+    if (std::isnan(lat) || std::isnan(lon))
+        return true;
+    
+    // too far away from camera? (also considering the regional ring)
+    const double maxDist = double(dataRefs.GetFdQueryDistance_m());
+    if (DistLatLonSqr(lat, lon, viewPos.lat(), viewPos.lon()) > maxDist * maxDist)
+        return false;
+    
+    // unreasonably high?
+    if (!std::isnan(alt_m) && alt_m > MDL_ALT_MAX * M_per_FT)
+        return false;
+    
+    return true;
+}
+
+// Commits decoded updates to the flight data map
+// Aircraft outside the standard distance are only tracked in the regional ring
+void LTFlightDataChannel::CommitUpdates (mapLTFlightDataTy& fdMap, vecFDUpdateTy& vecUpd,
+                                         const positionTy& viewPos)
+{
+    const size_t cnt = vecUpd.size();
+    double lock_ms = 0.0;
+    lastCommitCnt = cnt;
+    lastCommitLock_ms = lock_ms;
+    if (vecUpd.empty())
+        return;
+    
+    // positions not yet tagged count as received with the data just processed
+    for (FDUpdateTy& upd: vecUpd)
+        if (std::isnan(upd.pos.rcvTs))
+            SetRcvTs(upd.pos);
+    
+    // group by aircraft, keeping the order of updates per aircraft
+    std::stable_sort(vecUpd.begin(), vecUpd.end(),
+                     [](const FDUpdateTy& a, const FDUpdateTy& b){ return a.key < b.key; });
+    
+    try {
+        // from here on access to fdMap guarded by a mutex
+        std::lock_guard<std::mutex> mapFdLock (mapFdMutex);
+        const std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+        
+        for (vecFDUpdateTy::iterator it = vecUpd.begin(); it != vecUpd.end(); )
+        {
+            // all updates of this aircraft
+            const vecFDUpdateTy::iterator itEnd =
+            std::find_if(it, vecUpd.end(), [&](const FDUpdateTy& u){ return u.key != it->key; });
+            
+            // Route by the latest position: Outside the standard distance
+            // the aircraft is only tracked lightweight in the regional ring.
+            // Fully tracked aircraft are demoted only a margin further out.
+            // Updates without position go to where the aircraft is known.
+            vecFDUpdateTy::iterator itLastPos = itEnd;
+            for (vecFDUpdateTy::iterator i = it; i != itEnd; ++i)
+                if (i->bPos) itLastPos = i;
+            mapLTFlightDataTy::iterator fdIter = fdMap.find(it->key);
+            const bool bFull = fdIter != fdMap.end() && fdIter->second.IsValid();
+            bool bRegional = false;
+            if (itLastPos != itEnd)
+                bRegional = LTRegionalIsOuter(viewPos, itLastPos->pos.lat(), itLastPos->pos.lon(), bFull);
+            else if (LTRegionalIsActive() && !bFull)
+                bRegional = true;
+            
+            if (bRegional) {
+                // Demoted? Then the full flight data is no longer fed and has to go.
+                // Only the main thread may remove the aircraft, so we invalidate
+                // and have the next maintenance run remove it right away.
+                if (bFull) {
+                    std::lock_guard<std::recursive_mutex> fdLock (fdIter->second.dataAccessMutex);
+                    fdIter->second.SetInvalid();
+                    wheelFdMaint.Schedule(it->key, dataRefs.GetSimTime());
+                    LOG_MSG(logDEBUG, DBG_REGIONAL_DEMOTE, it->key.c_str());
+                }
+                
+                for (; it != itEnd; ++it)
+                    LTRegionalUpdate(it->key, it->stat,
+                                     it->bPos ? &it->dyn : nullptr, it->pos);
+                continue;
+            }
+            
+            // inside the standard distance: promote from the regional ring
+            if (itLastPos != itEnd && LTRegionalIsActive())
+                LTRegionalPromote(it->key);
+            
+            // get the fd object from the map
+            // this fetches an existing or, if not existing, creates a new one
+            LTFlightData& fd = fdMap[it->key];
+            
+            // also get the data access lock once and for all updates of this aircraft
+            std::lock_guard<std::recursive_mutex> fdLock (fd.dataAccessMutex);
+            
+            // completely new? fill key fields
+            if ( fd.empty() )
+                fd.SetKey(it->key);
+            
+            // all updates for this aircraft
+            for (; it != itEnd; ++it)
+            {
+                fd.UpdateData(std::move(it->stat));
+                if (it->bPos)
+                    fd.AddDynData(it->dyn, 0, 0, &it->pos);
+            }
+        }
+        
+        lock_ms = std::chrono::duration<double, std::milli>
+        (std::chrono::steady_clock::now() - tStart).count();
+        lastCommitLock_ms = lock_ms;
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
+    }
+    
+    LOG_MSG(logDEBUG, DBG_COMMIT_UPDATES, ChName(), cnt, lock_ms);
+}
+
 //
 //MARK: LTACMasterdata
 //
@@ -264,6 +670,37 @@ void LTACMasterdataChannel::ClearMasterDataRequests ()
 }
 
 
+// estimated memory of a list of master data requests
+static size_t MemAcStatUpdate (const listAcStatUpdateTy& l)
+{
+    size_t n = 0;
+    for (const acStatUpdateTy& u: l)
+        n += sizeof(acStatUpdateTy) + MEM_MAP_NODE_OVERHEAD +
+             u.acKey.key.capacity() + u.callSign.capacity();
+    return n;
+}
+
+size_t LTACMasterdataChannel::GetRequestListSize ()
+{
+    try {
+        // multi-threaded access guarded by listAcStatMutex
+        std::lock_guard<std::mutex> lock (listAcStatMutex);
+        return MemAcStatUpdate(listAcStatUpdate);
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "listAcStatUpdate", e.what());
+    }
+    return 0;
+}
+
+// private request list and read buffer
+size_t LTACMasterdataChannel::GetMasterDataSize () const
+{
+    size_t n = MemAcStatUpdate(listAc) + currKey.capacity();
+    for (const std::string& ln: listMd)
+        n += ln.capacity() + MEM_MAP_NODE_OVERHEAD;
+    return n;
+}
+
 // copy all requested a/c to our private list,
 // the global one is refreshed before the next call.
 void LTACMasterdataChannel::CopyGlobalRequestList ()
@@ -363,6 +800,9 @@ size_t LTOnlineChannel::ReceiveData(const char *ptr, size_t size, size_t nmemb,
         {LOG_MSG(logFATAL,ERR_MALLOC,me.netDataSize); me.SetValid(false); return 0;}
     }
     
+    // remember when data arrived, for latency measurement
+    me.netRcvTs = NetNow();
+    
     // save the received data, ensure zero-termination
     memmove(me.netData + me.netDataPos, ptr, realsize);
     me.netDataPos += realsize;
@@ -424,6 +864,16 @@ void LTOnlineChannel::DebugLogRaw(const char *data)
     << "\n" << std::endl;
 }
 
+// static CURL Write Callback when fetching tiles
+size_t LTOnlineChannel::ReceiveTileData(const char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+    const size_t realsize = size * nmemb;
+    TileTy& tile = *reinterpret_cast<TileTy*>(userdata);
+    tile.data.append(ptr, realsize);
+    tile.rcvTs = NetNow();
+    return realsize;
+}
+
 // fetch flight data from internet (takes time!)
 bool LTOnlineChannel::FetchAllData (const positionTy& pos)
 {
@@ -432,6 +882,11 @@ bool LTOnlineChannel::FetchAllData (const positionTy& pos)
     // make sure CURL is initialized
     if ( !InitCurl() ) return false;
     
+    // shall we split the query area into tiles?
+    listTiles.clear();
+    if (dataRefs.GetFdTileGrid() > 1 && CanTile())
+        return FetchAllTiles(pos);
+    
     // ask for the URL
     std::string url (GetURL(pos));
     
@@ -451,30 +906,50 @@ bool LTOnlineChannel::FetchAllData (const positionTy& pos)
     netData[0] = 0;
     // LOG_MSG(logDEBUG,DBG_SENDING_HTTP,ChName(),url.c_str());
     DebugLogRaw(url.c_str());
-    if ( (cc=curl_easy_perform(pCurl)) != CURLE_OK )
-    {
-        // problem with querying revocation list?
-        if (IsRevocationError(curl_errtxt)) {
-            // try not to query revoke list
-            curl_easy_setopt(pCurl, CURLOPT_SSL_OPTIONS, CURLSSLOPT_NO_REVOKE);
-            LOG_MSG(logWARN, ERR_CURL_DISABLE_REV_QU, ChName());
-            // and just give it another try
-            cc = curl_easy_perform(pCurl);
-        }
-
-        // if (still) error, then log error and bail out
-        if (cc != CURLE_OK) {
-            SHOW_MSG(logERR, ERR_CURL_PERFORM, ChName(), cc, curl_errtxt);
-            IncErrCnt();
-            return false;
-        }
+    cc = curl_easy_perform(pCurl);
+    
+    // problem with querying revocation list? Then try again without
+    cc = RetryOnRevocationError(pCurl, cc, curl_errtxt);
+    
+    // if (still) error, then log error and bail out
+    if (cc != CURLE_OK) {
+        SHOW_MSG(logERR, ERR_CURL_PERFORM, ChName(), cc, curl_errtxt);
+        IncErrCnt();
+        return false;
     }
     
     // check HTTP response code
     httpResponse = 0;
     curl_easy_getinfo(pCurl, CURLINFO_RESPONSE_CODE, &httpResponse);
+    LogHttpResponse(httpResponse, url);
+    
+    // if requested log raw data received
+    DebugLogRaw(netData);
+    
+    // success
+    return true;
+}
+
+// Retries a failed transfer once without querying the revocation list if that was the problem
+CURLcode LTOnlineChannel::RetryOnRevocationError (CURL* pHandle, CURLcode cc, const char* errTxt)
+{
+    if (cc == CURLE_OK || !IsRevocationError(errTxt))
+        return cc;
+    
+    // try not to query revoke list, also for all future (tile) requests
+    curl_easy_setopt(pCurl, CURLOPT_SSL_OPTIONS, CURLSSLOPT_NO_REVOKE);
+    if (pHandle != pCurl)
+        curl_easy_setopt(pHandle, CURLOPT_SSL_OPTIONS, CURLSSLOPT_NO_REVOKE);
+    LOG_MSG(logWARN, ERR_CURL_DISABLE_REV_QU, ChName());
     
-    switch (httpResponse) {
+    // and just give it another try
+    return curl_easy_perform(pHandle);
+}
+
+// Logs unexpected HTTP response codes
+void LTOnlineChannel::LogHttpResponse (long resp, const std::string& url) const
+{
+    switch (resp) {
         case HTTP_OK:
             // log number of bytes received
             // LOG_MSG(logDEBUG,DBG_RECEIVED_BYTES,ChName(),(long)netDataPos);
@@ -482,18 +957,179 @@ bool LTOnlineChannel::FetchAllData (const positionTy& pos)
             
         case HTTP_NOT_FOUND:
             // not found is typically handled separately, so only debug-level
-            LOG_MSG(logDEBUG,ERR_CURL_HTTP_RESP,ChName(),httpResponse, url.c_str());
+            LOG_MSG(logDEBUG,ERR_CURL_HTTP_RESP,ChName(),resp, url.c_str());
             break;
             
         default:
             // all other responses are warnings
-            LOG_MSG(logWARN,ERR_CURL_HTTP_RESP,ChName(),httpResponse, url.c_str());
+            LOG_MSG(logWARN,ERR_CURL_HTTP_RESP,ChName(),resp, url.c_str());
     }
+}
+
+// Total area to query around `pos`
+boundingBoxTy LTOnlineChannel::GetQueryArea (const positionTy& pos) const
+{
+    return boundingBoxTy(pos, dataRefs.GetFdQueryDistance_m());
+}
+
+// Fetches the query area split into tiles
+// The query area is split into GetFdTileGrid() x GetFdTileGrid() tiles.
+// Tiles around the camera are requested every cycle, the next ring of tiles
+// only every second cycle, the next ring every third cycle and so on,
+// but each ring often enough that its aircraft don't become outdated.
+// All tiles of a cycle are fetched concurrently using CURL's multi interface.
+// Responses are kept in listTiles, inner tiles first, and handed over
+// one by one to ProcessFetchedData via NextFetchedData.
+bool LTOnlineChannel::FetchAllTiles (const positionTy& pos)
+{
+    const int n = dataRefs.GetFdTileGrid();
+    const boundingBoxTy area = GetQueryArea(pos);
+    const double latStep = (area.nw.lat() - area.se.lat()) / n;
+    const double lonStep = (area.se.lon() - area.nw.lon()) / n;
+    const double ctr = (n-1) / 2.0;         // index of center tile (can be "between" tiles if n is even)
+    // max number of cycles between two requests of the same tile:
+    // the next response must arrive before aircraft are considered outdated
+    const int maxPeriod = std::max(1, (dataRefs.GetAcOutdatedIntvl() - dataRefs.GetFdRefreshIntvl()) /
+                                      dataRefs.GetFdRefreshIntvl());
     
-    // if requested log raw data received
-    DebugLogRaw(netData);
+    // determine the tiles to fetch in this cycle
+    for (int i = 0; i < n; ++i)             // north to south
+    {
+        for (int j = 0; j < n; ++j)         // west to east
+        {
+            // which ring around the center are we in?
+            const int ring = int(std::max(std::abs(i-ctr), std::abs(j-ctr)));
+            // ring r is fetched every (r+1)th cycle only, capped by maxPeriod
+            if (tileCycle % unsigned(std::min(ring+1, maxPeriod)) != 0)
+                continue;
+            
+            const boundingBoxTy tile (positionTy(area.nw.lat() -  i    * latStep, area.nw.lon() +  j    * lonStep),
+                                      positionTy(area.nw.lat() - (i+1) * latStep, area.nw.lon() + (j+1) * lonStep));
+            TileTy& t = listTiles.emplace_back();
+            t.ring = ring;
+            t.url  = GetTileURL(tile);
+            if (t.url.empty())
+                listTiles.pop_back();
+        }
+    }
+    ++tileCycle;
     
-    // success
+    // inner tiles first
+    listTiles.sort([](const TileTy& a, const TileTy& b){ return a.ring < b.ring; });
+    
+    // add all tiles to a multi handle
+    CURLM* pMulti = curl_multi_init();
+    if (!pMulti) {
+        LOG_MSG(logERR, ERR_CURL_MULTI_INIT, ChName());
+        IncErrCnt();
+        listTiles.clear();
+        return false;
+    }
+    for (TileTy& t: listTiles)
+    {
+        // duplicate our main handle, so channel-specific settings (like HTTP headers) apply to the tiles, too
+        t.pCurl = curl_easy_duphandle(pCurl);
+        if (!t.pCurl) {
+            LOG_MSG(logERR, ERR_CURL_EASY_INIT);
+            t.cc = CURLE_FAILED_INIT;
+            continue;
+        }
+        curl_easy_setopt(t.pCurl, CURLOPT_URL, t.url.c_str());
+        curl_easy_setopt(t.pCurl, CURLOPT_ERRORBUFFER, t.curl_errtxt);
+        curl_easy_setopt(t.pCurl, CURLOPT_WRITEFUNCTION, LTOnlineChannel::ReceiveTileData);
+        curl_easy_setopt(t.pCurl, CURLOPT_WRITEDATA, &t);
+        curl_easy_setopt(t.pCurl, CURLOPT_PRIVATE, &t);
+        t.cc = CURLE_GOT_NOTHING;           // until we know better
+        curl_multi_add_handle(pMulti, t.pCurl);
+        DebugLogRaw(t.url.c_str());
+    }
+    
+    // get fresh data via the internet, all tiles at the same time
+    // (blocking, it is assumed that this is called in a separate thread)
+    int running = 0;
+    do {
+        if (curl_multi_perform(pMulti, &running) != CURLM_OK)
+            break;
+        if (running > 0)
+            curl_multi_wait(pMulti, NULL, 0, FD_TILE_WAIT_MS, NULL);
+    } while (running > 0 && !bFDMainStop);
+    
+    // collect the transfer results
+    CURLMsg* pMsg = nullptr;
+    int msgLeft = 0;
+    while ((pMsg = curl_multi_info_read(pMulti, &msgLeft)) != nullptr) {
+        if (pMsg->msg == CURLMSG_DONE) {
+            char* pPriv = nullptr;
+            curl_easy_getinfo(pMsg->easy_handle, CURLINFO_PRIVATE, &pPriv);
+            if (pPriv)
+                reinterpret_cast<TileTy*>(pPriv)->cc = pMsg->data.result;
+        }
+    }
+    
+    // cleanup handles, check results, and remove failed tiles:
+    // a failed tile does not invalidate the others
+    bool bFailed = false;
+    for (listTileTy::iterator it = listTiles.begin(); it != listTiles.end(); )
+    {
+        TileTy& t = *it;
+        if (t.pCurl) {
+            curl_multi_remove_handle(pMulti, t.pCurl);
+            
+            // problem with querying revocation list? Then try again without
+            if (t.cc != CURLE_OK && IsRevocationError(t.curl_errtxt)) {
+                t.data.clear();
+                t.cc = RetryOnRevocationError(t.pCurl, t.cc, t.curl_errtxt);
+            }
+            
+            curl_easy_getinfo(t.pCurl, CURLINFO_RESPONSE_CODE, &t.httpResponse);
+            curl_easy_cleanup(t.pCurl);
+            t.pCurl = nullptr;
+        }
+        
+        // if (still) error, then log error and drop the tile,
+        // shown to the user only once per cycle
+        if (t.cc != CURLE_OK) {
+            if (!bFailed) {
+                SHOW_MSG(logERR, ERR_CURL_PERFORM, ChName(), t.cc, t.curl_errtxt);
+            } else {
+                LOG_MSG(logERR, ERR_CURL_PERFORM, ChName(), t.cc, t.curl_errtxt);
+            }
+            bFailed = true;
+            it = listTiles.erase(it);
+            continue;
+        }
+        
+        // check HTTP response code
+        LogHttpResponse(t.httpResponse, t.url);
+        
+        // if requested log raw data received
+        DebugLogRaw(t.data.c_str());
+        ++it;
+    }
+    curl_multi_cleanup(pMulti);
+    
+    // a failed cycle counts as one error, just like a failed FetchAllData
+    if (bFailed)
+        IncErrCnt();
+    
+    // provide the first tile's data for processing
+    return NextFetchedData();
+}
+
+// Hands over the next fetched tile to netData
+bool LTOnlineChannel::NextFetchedData ()
+{
+    if (listTiles.empty())
+        return false;
+    
+    // move tile data into the standard receive buffer
+    TileTy& t = listTiles.front();
+    netDataPos = 0;
+    netData[0] = 0;
+    httpResponse = t.httpResponse;
+    ReceiveData(t.data.data(), 1, t.data.size(), this);
+    netRcvTs = t.rcvTs;             // data has been received earlier already
+    listTiles.pop_front();
     return true;
 }
 
@@ -509,6 +1145,29 @@ bool LTOnlineChannel::IsRevocationError (const std::string& err)
     return false;
 }
 
+// receive buffer plus any tile data not yet processed
+size_t LTOnlineChannel::GetRawBufSize () const
+{
+    size_t n = netDataSize;
+    for (const TileTy& t: listTiles)
+        n += sizeof(TileTy) + MEM_MAP_NODE_OVERHEAD + t.url.capacity() + t.data.capacity();
+    return n;
+}
+
+// shrink the receive buffer back to its initial size
+void LTOnlineChannel::TrimRawBuf ()
+{
+    if (netDataSize <= CURL_MAX_WRITE_SIZE)
+        return;
+    char* p = (char*)realloc(netData, CURL_MAX_WRITE_SIZE);
+    if (!p)                         // keep the larger buffer then
+        return;
+    netData = p;
+    netDataSize = CURL_MAX_WRITE_SIZE;
+    netDataPos = 0;
+    netData[0] = 0;
+}
+
 //
 //MARK: LTFileChannel
 //
@@ -517,6 +1176,15 @@ LTFileChannel::LTFileChannel () :
 zuluLastRead(0)
 {}
 
+// lines read from the historic file
+size_t LTFileChannel::GetRawBufSize () const
+{
+    size_t n = 0;
+    for (const std::string& ln: listFd)
+        n += ln.capacity() + MEM_MAP_NODE_OVERHEAD;
+    return n;
+}
+
 //
 //MARK: Init Functions
 //
@@ -545,6 +1213,9 @@ bool LTFlightDataEnable()
         // TODO: master data readers for historic data, like reading CSV file
     } else {
         // load live feed readers (in order of priority)
+        listFDC.emplace_back(new MulticastReceiver(mapFd));
+        listFDC.emplace_back(new BeastConnection(mapFd));
+        listFDC.emplace_back(new SBSConnection(mapFd));
         listFDC.emplace_back(new RealTrafficConnection(mapFd));
         listFDC.emplace_back(new OpenSkyConnection);
         listFDC.emplace_back(new ADSBExchangeConnection);
@@ -552,6 +1223,7 @@ bool LTFlightDataEnable()
         listFDC.emplace_back(new OpenSkyAcMasterdata);
         // load other channels
         listFDC.emplace_back(new ForeFlightSender(mapFd));
+        listFDC.emplace_back(new MulticastSender(mapFd));
     }
     
     // check for validity after construction, disable all invalid ones
@@ -569,6 +1241,8 @@ void LTFlightDataDisable()
 {
     // remove all flight data connections
     listFDC.clear();
+    // no more sockets to serve
+    NetEventLoop::Get().Stop();
 }
 
 void LTFlightDataStop()
@@ -584,12 +1258,15 @@ void LTFlightDataStop()
 // and it runs in a loop until LTFlightDataHideAircraft stops it
 void LTFlightDataSelectAc ()
 {
+    // when to log latency statistics next
+    auto nextLatencyLog = LTClock::now() + std::chrono::seconds(LAT_LOG_INTVL);
+    
     while ( !bFDMainStop )
     {
         // determine when to be called next
         // (calls to network requests might take a long time,
         //  see wait in OpenSkyAcMasterdata::FetchAllData)
-        auto nextWakeup = std::chrono::steady_clock::now();
+        auto nextWakeup = LTClock::now();
         nextWakeup += std::chrono::seconds(dataRefs.GetFdRefreshIntvl());
         
         // LiveTraffic Top Level Exception Handling
@@ -607,10 +1284,13 @@ void LTFlightDataSelectAc ()
                         
                         // if enabled fetch data and process it
                         if ( p->FetchAllData(pos) && !bFDMainStop ) {
-                            if (p->ProcessFetchedData(mapFd))
-                                // reduce error count if processed successfully
-                                // as a chance to appear OK in the long run
-                                p->DecErrCnt();
+                            // fetched data might come in several parts (like tiles)
+                            do {
+                                if (p->ProcessFetchedData(mapFd))
+                                    // reduce error count if processed successfully
+                                    // as a chance to appear OK in the long run
+                                    p->DecErrCnt();
+                            } while (!bFDMainStop && p->NextFetchedData());
                         }
                     } else {
                         // if disabled...maybe do still some processing to connections
@@ -633,6 +1313,15 @@ void LTFlightDataSelectAc ()
             // Clear away processed master data requests
             LTACMasterdataChannel::ClearMasterDataRequests();
             
+            // memory usage of channels' buffers
+            LTFlightDataMemChannels();
+            
+            // regularly log latency statistics
+            if (LTClock::now() >= nextLatencyLog) {
+                LTLatencyLog();
+                nextLatencyLog += std::chrono::seconds(LAT_LOG_INTVL);
+            }
+            
         } catch (const std::exception& e) {
             LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
             // in case of any exception here completely re-init
@@ -646,8 +1335,9 @@ void LTFlightDataSelectAc ()
         // by condition variable trigger
         {
             std::unique_lock<std::mutex> lk(FDThreadSynchMutex);
-            FDThreadSynchCV.wait_until(lk, nextWakeup,
-                                       []{return bFDMainStop;});
+            LTClock::WaitUntil(FDThreadSynchCV, lk, nextWakeup,
+                               []{return bFDMainStop || bFDWakeup;});
+            bFDWakeup = false;
             lk.unlock();
         }
     }
@@ -672,6 +1362,9 @@ bool LTFlightDataShowAircraft()
         return false;
     }
     
+    // latency statistics start anew
+    LTLatencyReset();
+    
     // create a new thread that receives flight data / creates aircraft
     bFDMainStop = false;
     FDMainThread = std::thread ( LTFlightDataSelectAc );
@@ -686,6 +1379,9 @@ bool LTFlightDataShowAircraft()
     // flag for: as soon as data arrives start buffer countdown
     initTimeBufFilled = -1;
     
+    // we start from scratch, so no settings changes to apply
+    dataRefs.FetchCfgChanges();
+    
     return true;
 }
 
@@ -705,6 +1401,9 @@ void LTFlightDataHideAircraft()
         FDMainThread = std::thread();
     }
     
+    // final latency statistics
+    LTLatencyLog();
+    
     // tell all connection to close
     for ( ptrLTChannelTy& p: listFDC ) {
         p->Close();
@@ -715,15 +1414,94 @@ void LTFlightDataHideAircraft()
         // access guarded by a mutex
         std::lock_guard<std::mutex> lock (mapFdMutex);
         mapFd.clear();
+        wheelFdMaint.clear();
         LOG_ASSERT ( dataRefs.GetNumAc() == 0 );
     } catch(const std::system_error& e) {
         LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
     }
     
+    // also all aircraft of the regional ring
+    LTRegionalClear();
+    
+    // no more closest approaches to predict
+    LTCpaClear();
+    
+    // debug: end of a trajectory recording
+    if (dataRefs.GetDebugLogTrajectory()) {
+        LTTrajectoryStop();
+        dataRefs.SetDebugLogTrajectory(false);
+    }
+    
     // not showing any longer
     LOG_MSG(logINFO,INFO_AC_ALL_REMOVED);
 }
 
+// Applies settings changes incrementally
+void LTFlightDataApplyCfgChanges (unsigned chg)
+{
+    if (!chg)
+        return;
+    
+    // have the flight data thread start a new cycle right away,
+    // so that channels start, stop, or query the changed area
+    {
+        std::lock_guard<std::mutex> lk(FDThreadSynchMutex);
+        bFDWakeup = true;
+    }
+    FDThreadSynchCV.notify_all();
+    
+    // remove only flight data affected by the change
+    try {
+        const positionTy viewPos = dataRefs.GetViewPos();
+        const double maxDist = double(dataRefs.GetFdStdDistance_m());
+        const std::string acFilter = dataRefs.GetDebugAcFilter();
+        
+        std::lock_guard<std::mutex> lock (mapFdMutex);
+        int cntRemoved = 0;
+        for (mapLTFlightDataTy::iterator fdIter = mapFd.begin();
+             fdIter != mapFd.end();)
+        {
+            LTFlightData& fd = fdIter->second;
+            bool bRemove = false;
+            {
+                std::lock_guard<std::recursive_mutex> fdLock (fd.dataAccessMutex);
+                
+                // data from a channel, which got disabled?
+                const LTChannel* pChn = nullptr;
+                if ((chg & CFG_CHG_CHANNELS) && fd.GetCurrChannel(pChn) &&
+                    !dataRefs.IsChannelEnabled(pChn->GetChannel()))
+                    bRemove = true;
+                
+                // out of a reduced search radius?
+                if ((chg & CFG_CHG_RADIUS) && !bRemove) {
+                    const dequePositionTy& posDeque = fd.GetPosDeque();
+                    if (fd.hasAc())
+                        bRemove = fd.GetAircraft()->GetVecView().dist > maxDist;
+                    else if (!posDeque.empty())
+                        bRemove = viewPos.dist(posDeque.back()) > maxDist;
+                }
+                
+                // not matching a new a/c filter?
+                if ((chg & CFG_CHG_AC_FILTER) && !bRemove &&
+                    !acFilter.empty() && fdIter->first.key != acFilter)
+                    bRemove = true;
+            }
+            
+            if (bRemove) {
+                wheelFdMaint.Remove(fdIter->first);
+                fdIter = mapFd.erase(fdIter);
+                cntRemoved++;
+            } else
+                ++fdIter;
+        }
+        
+        if (cntRemoved > 0)
+            LOG_MSG(logINFO, INFO_CFG_CHG_REMOVED, cntRemoved);
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
+    }
+}
+
 //
 //MARK: Aircraft Maintenance
 //      (called from flight loop callback!)
@@ -738,20 +1516,32 @@ void LTFlightDataAcMaintenance()
         std::lock_guard<std::mutex> lock (mapFdMutex);
         double simTime = dataRefs.GetSimTime();
         
-        // iterate all flight data and remove outdated aircraft along with their fd data
-        // (although c++ doc says map iterators won't be affected by erase it actually crashes...
-        //  so we do it the old-fashioned way and store a vector of to-be-deleted keys
-        //  and do the actual delete in a second round)
-        std::vector<mapLTFlightDataTy::key_type> vFdKeysToErase;
-        for ( mapLTFlightDataTy::value_type& fdPair: mapFd )
+        // Safety net: Every fd object is supposed to be scheduled in the wheel.
+        // Should one have slipped through then schedule all missing ones now.
+        if (mapFd.size() > wheelFdMaint.size()) {
+            for (const mapLTFlightDataTy::value_type& fdPair: mapFd)
+                if (!wheelFdMaint.contains(fdPair.first))
+                    wheelFdMaint.Schedule(fdPair.first, simTime);
+        }
+        
+        // only look at those flight data objects, which are due for maintenance,
+        // instead of sweeping the entire map
+        static std::vector<mapLTFlightDataTy::key_type> vFdKeysDue;
+        vFdKeysDue.clear();
+        wheelFdMaint.PopDue(simTime, vFdKeysDue);
+        for ( const mapLTFlightDataTy::key_type& key: vFdKeysDue )
         {
-            // do the maintenance, remember a/c to be deleted
-            if ( fdPair.second.AircraftMaintenance(simTime) )
-                vFdKeysToErase.push_back(fdPair.first);
+            mapLTFlightDataTy::iterator fdIter = mapFd.find(key);
+            if (fdIter == mapFd.end())          // removed meanwhile
+                continue;
+            
+            // do the maintenance, remove outdated fd objects, reschedule the others
+            double nextMaint = NAN;
+            if ( fdIter->second.AircraftMaintenance(simTime, nextMaint) )
+                mapFd.erase(fdIter);
+            else
+                wheelFdMaint.Schedule(key, nextMaint);
         }
-        // now remove all outdated fd objects remembered for deletion
-        for ( const mapLTFlightDataTy::key_type& key: vFdKeysToErase )
-            mapFd.erase(key);
         
     } catch(const std::system_error& e) {
         LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
@@ -0,0 +1,121 @@
+/// @file       LTClock.cpp
+/// @brief      LiveTraffic's clock, running on real or on virtual time
+/// @details    In virtual mode, time only moves forward when advanced by
+///             LTClock::Advance(), e.g. via the dataRef
+///             `livetraffic/dbg/vclock/advance_ms`.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+//
+// MARK: Virtual Time State
+//
+
+std::atomic<bool>       LTClock::bVirtual (false);
+std::atomic<LTClock::rep> LTClock::vNow (0);
+LTClock::rep            LTClock::vStart = 0;
+double                  LTClock::vSysStart = 0.0;
+float                   LTClock::vElapsedStart = 0.0f;
+
+//
+// MARK: Time Sources
+//
+
+// Current time point
+LTClock::time_point LTClock::now () noexcept
+{
+    if (bVirtual)
+        return time_point(duration(vNow.load()));
+    return time_point(std::chrono::steady_clock::now().time_since_epoch());
+}
+
+// Current system time in seconds since the epoch
+double LTClock::SysNow ()
+{
+    using namespace std::chrono;
+    if (bVirtual)
+        return vSysStart + duration_cast<std::chrono::duration<double>>(duration(vNow.load() - vStart)).count();
+    return double(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count())
+    / 1000000.0;
+}
+
+// Seconds since X-Plane started
+float LTClock::Elapsed ()
+{
+    using namespace std::chrono;
+    if (bVirtual)
+        return vElapsedStart + duration_cast<std::chrono::duration<float>>(duration(vNow.load() - vStart)).count();
+    return XPLMGetElapsedTime();
+}
+
+//
+// MARK: Virtual Time Control
+//
+
+// Switches between real and virtual time
+void LTClock::SetVirtual (bool _bVirtual, double startSysTime)
+{
+    if (_bVirtual == bVirtual)
+        return;
+
+    if (_bVirtual) {
+        // virtual time starts where real time is now
+        vStart          = std::chrono::steady_clock::now().time_since_epoch().count();
+        vSysStart       = std::isnan(startSysTime) ? SysNow() : startSysTime;
+        vElapsedStart   = XPLMGetElapsedTime();
+        vNow            = vStart;
+        bVirtual        = true;
+        LOG_MSG(logINFO, INFO_CLOCK_VIRTUAL, ts2string(time_t(vSysStart)).c_str());
+    } else {
+        bVirtual = false;
+        LOG_MSG(logINFO, INFO_CLOCK_REAL);
+    }
+}
+
+// Virtual mode only: moves time forward
+void LTClock::Advance (duration d)
+{
+    if (bVirtual && d.count() > 0)
+        vNow += d.count();
+}
+
+//
+// MARK: Waiting
+//
+
+// Sleeps for the given duration of real or virtual time
+void LTClock::SleepFor (duration d)
+{
+    if (!bVirtual) {
+        std::this_thread::sleep_for(d);
+        return;
+    }
+    const time_point deadline = now() + d;
+    while (bVirtual && now() < deadline)
+        std::this_thread::sleep_for(LTCLOCK_VIRT_POLL);
+}
+
+// Caps a socket wait timeout so that virtual deadlines are checked often enough
+int LTClock::CapWaitMs (int timeout_ms)
+{
+    // infinite waits don't have a deadline to check
+    if (!bVirtual || timeout_ms < 0)
+        return timeout_ms;
+    return std::min(timeout_ms, int(LTCLOCK_VIRT_POLL.count()));
+}
@@ -0,0 +1,296 @@
+/// @file       LTCpa.cpp
+/// @brief      Closest point of approach (CPA): Predicts which aircraft come close to the user's plane
+/// @details    Regularly computes, in a separate thread, time and distance of the
+///             closest approach between the user's plane and every tracked aircraft.
+///             The user's plane is extrapolated along its current track and speed,
+///             the aircraft follow their future positions as buffered in `posDeque`.\n
+///             The calculation collects all path segments of the fleet into flat arrays
+///             first and then processes them in one tight, branch-free loop.\n
+///             The result ranks the most threatening aircraft. They are exposed via
+///             `livetraffic/cpa/...` dataRefs and feed into AI slot priority
+///             and aircraft creation.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+//
+// MARK: Global Results
+//
+
+/// Guards access to the results
+static std::mutex mtxCpa;
+/// Latest results per aircraft, guarded by `mtxCpa`
+static std::map<LTFlightData::FDKeyTy,CpaTy> mapCpa;
+/// Latest top threats, most threatening first, guarded by `mtxCpa`
+static vecCpaTy vecThreats;
+
+/// Is currently an async calculation running?
+static std::future<void> futCpa;
+
+//
+// MARK: Calculation (separate thread)
+//
+
+/// @brief Path segments of all aircraft in structure-of-arrays layout
+/// @details Coordinates are local [m] relative to the user's plane at `simTime`,
+///          east (x), north (y), up (z). Each segment is already expressed relative
+///          to the user's plane: `r` is the relative position at segment start,
+///          `v` the relative velocity.
+struct CpaSegmentsTy {
+    std::vector<double> t0;     ///< [s] segment start relative to `simTime`
+    std::vector<double> dur;    ///< [s] segment duration
+    std::vector<double> rx, ry, rz;
+    std::vector<double> vx, vy, vz;
+    // output
+    std::vector<double> tCpa;   ///< [s] time of CPA within segment relative to `simTime`
+    std::vector<double> distH;  ///< [m] horizontal distance at CPA
+    std::vector<double> distV;  ///< [m] vertical separation at CPA
+    std::vector<double> cost;   ///< ranking value
+
+    size_t size () const { return t0.size(); }
+
+    void push_back (double _t0, double _dur,
+                    double _rx, double _ry, double _rz,
+                    double _vx, double _vy, double _vz)
+    {
+        t0.push_back(_t0); dur.push_back(_dur);
+        rx.push_back(_rx); ry.push_back(_ry); rz.push_back(_rz);
+        vx.push_back(_vx); vy.push_back(_vy); vz.push_back(_vz);
+    }
+
+    /// Computes the CPA of all segments in one loop without branches
+    void Calc ()
+    {
+        const size_t n = size();
+        tCpa.resize(n); distH.resize(n); distV.resize(n); cost.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            // time of horizontal closest approach within segment
+            const double vv = vx[i]*vx[i] + vy[i]*vy[i];
+            const double t  = std::min(std::max(-(rx[i]*vx[i] + ry[i]*vy[i]) / (vv + 1e-9), 0.0), dur[i]);
+            const double dx = rx[i] + vx[i]*t;
+            const double dy = ry[i] + vy[i]*t;
+            const double dz = rz[i] + vz[i]*t;
+            tCpa[i]  = t0[i] + t;
+            distH[i] = std::sqrt(dx*dx + dy*dy);
+            distV[i] = std::abs(dz);
+            const double dzW = dz * AI_SLOT_ALT_WEIGHT;
+            cost[i]  = std::sqrt(dx*dx + dy*dy + dzW*dzW) + tCpa[i] * CPA_TIME_WEIGHT;
+        }
+    }
+};
+
+/// Calculates CPA of all aircraft, runs in a separate thread
+/// @param posUser User's plane's position, its timestamp is "now"
+/// @param userSpeed [m/s] user's plane's speed
+/// @param userTrack [°] user's plane's track
+static void AsyncCpaCalc (positionTy posUser, double userSpeed, double userTrack)
+{
+    const double simTime = posUser.ts();
+
+    // user's velocity, user's vertical movement is not considered
+    if (std::isnan(userSpeed) || std::isnan(userTrack))
+        userSpeed = userTrack = 0.0;
+    const double uVx = userSpeed * std::sin(deg2rad(userTrack));
+    const double uVy = userSpeed * std::cos(deg2rad(userTrack));
+
+    // conversion into local coordinates around user's plane
+    const double mPerLon = LonDegInMtr(posUser.lat());
+    auto toLocal = [&](const positionTy& p, double& x, double& y, double& z)
+    {
+        double dLon = p.lon() - posUser.lon();
+        if (dLon > 180.0)        dLon -= 360.0;
+        else if (dLon < -180.0)  dLon += 360.0;
+        x = dLon * mPerLon;
+        y = (p.lat() - posUser.lat()) * LAT_DEG_IN_MTR;
+        z = p.alt_m() - posUser.alt_m();
+    };
+
+    // *** Collect the path segments of all aircraft ***
+    CpaSegmentsTy seg;
+    std::vector<LTFlightData::FDKeyTy> vecKeys;     // aircraft keys
+    std::vector<size_t> vecBegin;                   // index of aircraft's first segment, plus one final entry
+    try {
+        // don't block anyone for long, try again next time
+        std::unique_lock<std::mutex> lock (mapFdMutex, std::try_to_lock);
+        if (!lock)
+            return;
+
+        for (mapLTFlightDataTy::value_type& fdPair: mapFd)
+        {
+            LTFlightData& fd = fdPair.second;
+            std::unique_lock<std::recursive_mutex> fdLock (fd.dataAccessMutex, std::try_to_lock);
+            if (!fdLock)
+                continue;
+            const dequePositionTy& dq = fd.GetPosDeque();
+            const size_t segBefore = seg.size();
+
+            // all segments between consecutive positions, which overlap [simTime, simTime+horizon]
+            for (size_t i = 0; i+1 < dq.size(); ++i) {
+                const positionTy& p0 = dq[i];
+                const positionTy& p1 = dq[i+1];
+                if (p0.ts() >= simTime + CPA_HORIZON)
+                    break;
+                if (!p0.isNormal() || !p1.isNormal() || p1.ts() <= p0.ts() || p1.ts() <= simTime)
+                    continue;
+
+                // aircraft's velocity along the segment
+                double x0, y0, z0, x1, y1, z1;
+                toLocal(p0, x0, y0, z0);
+                toLocal(p1, x1, y1, z1);
+                const double d = p1.ts() - p0.ts();
+                const double aVx = (x1-x0)/d, aVy = (y1-y0)/d, aVz = (z1-z0)/d;
+
+                // Segment starts now earliest. If the first buffered position is
+                // still in the future (aircraft already flies towards it) then
+                // the first segment is extended backwards to now.
+                const double s0 = (i == 0) ? simTime : std::max(p0.ts(), simTime);
+                const double s1 = std::min(p1.ts(), simTime + CPA_HORIZON);
+                if (s1 <= s0)
+                    continue;
+
+                // relative position at segment start, user starting at origin at simTime
+                const double ds = s0 - p0.ts();
+                seg.push_back(s0 - simTime, s1 - s0,
+                              x0 + aVx*ds - uVx*(s0 - simTime),
+                              y0 + aVy*ds - uVy*(s0 - simTime),
+                              z0 + aVz*ds,
+                              aVx - uVx, aVy - uVy, aVz);
+            }
+
+            // Only a single position known? Then extrapolate it by the
+            // aircraft's latest known speed and track over the entire horizon.
+            if (dq.size() == 1 && dq[0].isNormal() && dq[0].ts() < simTime + CPA_HORIZON) {
+                const LTFlightData::FDDynamicData dyn = fd.WaitForSafeCopyDyn(false);
+                if (!std::isnan(dyn.spd) && !std::isnan(dyn.heading)) {
+                    const double spd = dyn.spd / KT_per_M_per_S;
+                    const double aVx = spd * std::sin(deg2rad(dyn.heading));
+                    const double aVy = spd * std::cos(deg2rad(dyn.heading));
+                    const double aVz = (dyn.gnd || std::isnan(dyn.vsi)) ? 0.0 : dyn.vsi * Ms_per_FTm;
+                    double x0, y0, z0;
+                    toLocal(dq[0], x0, y0, z0);
+                    const double ds = simTime - dq[0].ts();
+                    seg.push_back(0.0, CPA_HORIZON,
+                                  x0 + aVx*ds, y0 + aVy*ds, z0 + aVz*ds,
+                                  aVx - uVx, aVy - uVy, aVz);
+                }
+            }
+
+            // remember the aircraft if it contributed segments
+            if (seg.size() > segBefore) {
+                vecKeys.push_back(fdPair.first);
+                vecBegin.push_back(segBefore);
+            }
+        }
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
+        return;
+    }
+    vecBegin.push_back(seg.size());
+
+    // *** Calculate ***
+    seg.Calc();
+
+    // *** Reduce to one result per aircraft: its most threatening segment ***
+    std::map<LTFlightData::FDKeyTy,CpaTy> newMap;
+    vecCpaTy newThreats;
+    for (size_t a = 0; a < vecKeys.size(); ++a) {
+        size_t best = vecBegin[a];
+        for (size_t i = best+1; i < vecBegin[a+1]; ++i)
+            if (seg.cost[i] < seg.cost[best])
+                best = i;
+        CpaTy cpa;
+        cpa.key   = vecKeys[a];
+        cpa.tCpa  = seg.tCpa[best];
+        cpa.distH = seg.distH[best];
+        cpa.distV = seg.distV[best];
+        cpa.cost  = seg.cost[best];
+        if (cpa.IsThreat())
+            newThreats.push_back(cpa);
+        newMap.emplace(cpa.key, cpa);
+    }
+
+    // top threats only, most threatening first
+    const size_t nThreats = std::min(newThreats.size(), CPA_NUM_THREATS);
+    std::partial_sort(newThreats.begin(), newThreats.begin() + nThreats, newThreats.end(),
+                      [](const CpaTy& a, const CpaTy& b){ return a.cost < b.cost; });
+    newThreats.resize(nThreats);
+
+    // *** Publish ***
+    std::lock_guard<std::mutex> lock (mtxCpa);
+    mapCpa.swap(newMap);
+    vecThreats.swap(newThreats);
+}
+
+//
+// MARK: X-Plane Main Thread
+//
+
+// Starts a new CPA calculation in a separate thread, unless one is still running
+void LTCpaUpdate ()
+{
+    // previous calculation still running?
+    if (futCpa.valid() &&
+        futCpa.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+    // user's plane's position, speed, and track can only be read in the main thread
+    double userSpeed = NAN, userTrack = NAN;
+    const positionTy posUser = dataRefs.GetUsersPlanePos(userSpeed, userTrack);
+    if (!posUser.isNormal(true))
+        return;
+
+    futCpa = std::async(std::launch::async,
+                        AsyncCpaCalc, posUser, userSpeed, userTrack);
+}
+
+// Waits for a running calculation and removes all results
+void LTCpaClear ()
+{
+    if (futCpa.valid())
+        futCpa.wait();
+    std::lock_guard<std::mutex> lock (mtxCpa);
+    mapCpa.clear();
+    vecThreats.clear();
+}
+
+// Returns the latest CPA result of an aircraft
+bool LTCpaGet (const LTFlightData::FDKeyTy& key, CpaTy& cpa)
+{
+    std::lock_guard<std::mutex> lock (mtxCpa);
+    auto iter = mapCpa.find(key);
+    if (iter == mapCpa.end())
+        return false;
+    cpa = iter->second;
+    return true;
+}
+
+// Is the aircraft one of the top threats?
+bool LTCpaIsThreat (const LTFlightData::FDKeyTy& key)
+{
+    std::lock_guard<std::mutex> lock (mtxCpa);
+    return std::any_of(vecThreats.cbegin(), vecThreats.cend(),
+                       [&key](const CpaTy& cpa){ return cpa.key == key; });
+}
+
+// Returns a copy of the top threats
+vecCpaTy LTCpaGetThreats ()
+{
+    std::lock_guard<std::mutex> lock (mtxCpa);
+    return vecThreats;
+}
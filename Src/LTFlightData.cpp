@@ -35,6 +35,8 @@ mapLTFlightDataTy mapFd;
 // (note that mapFdMutex must be locked before dataAccessMutex
 //  to avoid deadlocks, mapFdMutex is considered a higher-level lock)
 std::mutex      mapFdMutex;
+// maintenance schedule of all flight data objects, guarded by mapFdMutex
+TimingWheelTy<LTFlightData::FDKeyTy> wheelFdMaint (AC_MAINT_WHEEL_RES);
 
 // flag to indicate that there is no new positional data
 // to analyse for terrain altitude and subsequently
@@ -290,6 +292,8 @@ void LTFlightData::SetInvalid()
 void LTFlightData::SetKey (const FDKeyTy& _key)
 {
     acKey = _key;
+    // a new flight data object: first maintenance right away
+    wheelFdMaint.Schedule(acKey, dataRefs.GetSimTime());
 //    LOG_MSG(logDEBUG, "FD crated for %s", key().c_str());
 }
 
@@ -345,13 +349,14 @@ bool LTFlightData::outdated (double simTime) const
     if (dataRefs.IsReInitAll())
         return true;
     
-    // a/c turned invalid (due to exceptions)?
-    if (pAc && !pAc->IsValid())
+    // a/c turned invalid (due to exceptions or demotion to regional)?
+    if (!bValid || (pAc && !pAc->IsValid()))
         return true;
     
     // flown out of sight? -> outdated, remove
+    // (in regional mode only a margin further out, see CommitUpdates)
     if (pAc &&
-        pAc->GetVecView().dist > dataRefs.GetFdStdDistance_m())
+        pAc->GetVecView().dist > LTRegionalDemoteDist_m())
         return true;
     
     // cover the special case of finishing landing and roll-out without live positions
@@ -370,6 +375,37 @@ bool LTFlightData::outdated (double simTime) const
     youngestTS + dataRefs.GetAcOutdatedIntvl() < (std::isnan(simTime) ? dataRefs.GetSimTime() : simTime);
 }
 
+// estimated memory usage of flight data and position buffers
+void LTFlightData::MemUsage (size_t& fdBytes, size_t& posBytes) const
+{
+    // flight data: the object itself plus what its strings allocated
+    fdBytes = sizeof(LTFlightData) + MEM_MAP_NODE_OVERHEAD +
+    acKey.key.capacity() + acKey.icao.capacity() + acKey.flarm.capacity() +
+    acKey.rtId.capacity() + acKey.ogn.capacity() +
+    labelStat.capacity() +
+    statData.reg.capacity() + statData.country.capacity() +
+    statData.acTypeIcao.capacity() + statData.man.capacity() +
+    statData.mdl.capacity() + statData.catDescr.capacity() +
+    statData.call.capacity() + statData.originAp.capacity() +
+    statData.destAp.capacity() + statData.flight.capacity() +
+    statData.op.capacity() + statData.opIcao.capacity();
+    
+    // position buffers: positions (incl. their valarray) and dynamic data
+    posBytes = (posDeque.size() + posToAdd.size()) * MEM_POS_SIZE +
+    dynDataDeque.size() * sizeof(FDDynamicData);
+    // the aircraft and its positions
+    if (pAc)
+        posBytes += sizeof(LTAircraft) + pAc->posList.size() * MEM_POS_SIZE;
+}
+
+// releases unused capacity of the buffers
+void LTFlightData::TrimBuffers ()
+{
+    posDeque.shrink_to_fit();
+    posToAdd.shrink_to_fit();
+    dynDataDeque.shrink_to_fit();
+}
+
 #define ADD_LABEL(b,txt) if (b && !txt.empty()) { labelStat += txt; labelStat += ' '; }
 // update static data parts of the a/c label for reuse for performance reasons
 void LTFlightData::UpdateStaticLabel()
@@ -617,7 +653,14 @@ void LTFlightData::DataCleansing (bool& bChanged)
     {
         // We have a plane which is in approach.
         const LTAircraft::FlightModel& mdl = pAc->mdl;
-        const double maxHoverAlt_m = pAc->GetTerrainAlt_m() + (MAX_HOVER_AGL * M_per_FT);
+        // hovering is judged against the terrain below each position as cached
+        // by the ground status classification, the aircraft's current terrain otherwise
+        const double acTerrainAlt_m = pAc->GetTerrainAlt_m();
+        auto maxHoverAlt_m = [acTerrainAlt_m](const positionTy& pos)
+        {
+            return (std::isnan(pos.terrainAlt) ? acTerrainAlt_m : pos.terrainAlt) +
+                   (MAX_HOVER_AGL * M_per_FT);
+        };
         
         // What we now search for is data at level altitude following a descend.
         // So we follow our positions as long as they are descending.
@@ -641,7 +684,7 @@ void LTFlightData::DataCleansing (bool& bChanged)
         // Delete all positions hovering above the runway.
         while (iter != posDeque.cend() &&                         // not the end,
                !iter->IsOnGnd() &&                                // between ground and
-               iter->alt_m() < maxHoverAlt_m &&                   // max hover altitude
+               iter->alt_m() < maxHoverAlt_m(*iter) &&            // max hover altitude
                std::abs(iter->vsi_ft(prevPos)) <= mdl.VSI_STABLE) // and flying level
         {
             // remove that hovering position
@@ -697,49 +740,42 @@ void LTFlightData::DataSmoothing (bool& bChanged)
     if (numPos < 2)
         return;
     
-    // what is the total distance travelled between first and last?
-    // (to take curves into account we need to sum up individual distances)
-    double dist = 0.0;
-    dequePositionTy::iterator itPrev = posDeque.begin();        // previous pos
-    for (dequePositionTy::iterator it = std::next(itPrev);      // next pos
-         itPrev != itLast;
-         ++it, ++itPrev)
-    {
-        dist += itPrev->dist(*it);                              // distance between prev and next
-    }
+    // Pass 1: Distances of the individual segments between first and last,
+    //         summed up, so that vecDist[i] is the distance travelled from first to pos i
+    //         (to take curves into account we need to sum up individual distances)
+    std::vector<double> vecDist(numPos+1, 0.0);
+    for (size_t i = 1; i <= numPos; ++i)
+        vecDist[i] = posDeque[i-1].dist(posDeque[i]);
+    std::partial_sum(vecDist.begin(), vecDist.end(), vecDist.begin());
+    
     const double totTime = itLast->ts() - posFirst.ts();
     // sanity check: some reasonable time
     if (totTime < 1.0)
         return;
     // avg speed:
-    const double speed = dist / totTime;
+    const double speed = vecDist[numPos] / totTime;
     // sanity check: some reasonable speed to avoid INF and NAN values
     if (speed < 1.0)
         return;
 
-    // all positions between first and last are now to be moved in a way
-    // that the speed stays constant in all segments
-    itPrev = posDeque.begin();
-    for (dequePositionTy::iterator it = std::next(itPrev);
-         it != itLast;
-         ++it, ++itPrev)
-    {
-        // speed is constant, but distances differs from leg to leg
-        // and, thus, determines time difference:
-        it->ts() = itPrev->ts() + itPrev->dist(*it) / speed;
-    }
+    // Pass 2: all positions between first and last are now to be moved in a way
+    // that the speed stays constant in all segments, ie. time is proportional to distance travelled.
+    // Each timestamp only depends on the prefix sum, not on the previous result.
+    const double ts0 = posFirst.ts();
+    std::vector<double> vecTs(numPos);
+    for (size_t i = 1; i < numPos; ++i)
+        vecTs[i] = ts0 + vecDist[i] / speed;
+    for (size_t i = 1; i < numPos; ++i)
+        posDeque[i].ts() = vecTs[i];
     
     // If previously there where two (or more) positions with the exact same
     // position but different timestamps then these positions now have the very
     // same timestamp. (Distance between them is 0, with the above calculation
     // time difference now is also 0.) We must remove these duplicates:
-    dequePositionTy::iterator dup;
-    while ((dup = std::adjacent_find(posDeque.begin(), posDeque.end(),
-                                     // find two adjacent positions with same timestamp:
-                                     [](const positionTy& a, const positionTy& b){return dequal(a.ts(),b.ts());})) != posDeque.end())
-    {
-        posDeque.erase(dup);
-    }
+    posDeque.erase(std::unique(posDeque.begin(), posDeque.end(),
+                               // two adjacent positions with same timestamp:
+                               [](const positionTy& a, const positionTy& b){return dequal(a.ts(),b.ts());}),
+                   posDeque.end());
     
     // so we changed data
     bChanged = true;
@@ -753,23 +789,9 @@ void LTFlightData::SnapToTaxiways (bool& bChanged)
         posDeque.empty())
         return;
     
-    // Loop over position in the deque
-    dequePositionTy::iterator iter = posDeque.begin();
-    while (iter != posDeque.end())
-    {
-        // Only act on positions on the ground,
-        // which have (not yet) been artificially added
-        positionTy& pos = *iter;
-        if (pos.IsOnGnd() && pos.flightPhase == 0)
-        {
-            // Try snapping to a rwy or taxiway
-            if (LTAptSnap(pos, dataRefs.GetDebugAcPos(key())))
-                bChanged = true;
-        } // non-artificial ground position
-        
-        // move on to next
-        ++iter;
-    } // while all posDeque positions
+    // Snap the entire track in one go
+    if (LTAptSnapTrack(posDeque, dataRefs.GetDebugAcPos(key())) > 0)
+        bChanged = true;
 }
 
 
@@ -1473,17 +1495,22 @@ void LTFlightData::AppendNewPos()
             return;
         }
         
-       // loop the positions to add
-        while (!posToAdd.empty())
+        // posDeque is sorted by timestamp, so we can use binary search to find
+        // merge partners and insert positions. Working the new positions
+        // in timestamp order, too, mostly means appending at the end.
+        std::stable_sort(posToAdd.begin(), posToAdd.end());
+        
+        // timestamp range of positions touched, heading is recalculated for those (and their neighbours) only
+        double tsTouchedFirst = NAN, tsTouchedLast = NAN;
+        
+        // *** ground status *** (plays a role in merge determination)
+        // determined for all new positions in one batch,
+        // will set ground altitude if on ground
+        DeriveGrndStatus(posToAdd, true);
+        
+        // loop the positions to add
+        for (positionTy& pos: posToAdd)
         {
-            // take next pos from queue
-            positionTy pos = posToAdd.front();
-            posToAdd.pop_front();
-            
-            // *** ground status *** (plays a role in merge determination)
-            // will set ground altitude if on ground
-            TryDeriveGrndStatus(pos);
-            
             // *** insert/merge position ***
             
             // based on timestamp find possible "similar" position
@@ -1491,10 +1518,12 @@ void LTFlightData::AppendNewPos()
             // and if so merge with that position to avoid too many position in
             // a very short time frame, as that leads to zick-zack courses in a
             // matter of meters only as can happen when merging different data streams
-            dequePositionTy::iterator i =   // first: find a merge partner
-            std::find_if(posDeque.begin(), posDeque.end(),
-                         [&pos](const positionTy& p){return p.canBeMergedWith(pos);});
-            if (i != posDeque.end()) {      // found merge partner!
+            
+            // first: find a merge partner, the first position with ts >= pos.ts - SIMILAR_TS_INTVL
+            dequePositionTy::iterator i =
+            std::lower_bound(posDeque.begin(), posDeque.end(), pos.ts() - SIMILAR_TS_INTVL,
+                             [](const positionTy& p, double ts){return p.ts() < ts;});
+            if (i != posDeque.end() && i->canBeMergedWith(pos)) {      // found merge partner!
                 // make sure we don't overlap with predecessor/successor position
                 if (((i == posDeque.begin()) || (*std::prev(i) < pos)) &&
                     ((std::next(i) == posDeque.end()) || (*std::next(i) > pos)))
@@ -1513,9 +1542,8 @@ void LTFlightData::AppendNewPos()
             }
             else
             {
-                // second: find insert-before position
-                i = std::find_if(posDeque.begin(), posDeque.end(),
-                                 [&pos](const positionTy& p){return p > pos;});
+                // second: find insert-before position, the first position with ts > pos.ts
+                i = std::upper_bound(posDeque.begin(), posDeque.end(), pos);
                 
                 // *** Sanity Check if we have valid vectors already ***
                 if (pAc || !posDeque.empty())
@@ -1559,6 +1587,12 @@ void LTFlightData::AppendNewPos()
             // i now points to the inserted/merged element
             positionTy& p = *i;
             
+            // remember the range of touched positions
+            if (std::isnan(tsTouchedFirst) || p.ts() < tsTouchedFirst)
+                tsTouchedFirst = p.ts();
+            if (std::isnan(tsTouchedLast) || p.ts() > tsTouchedLast)
+                tsTouchedLast = p.ts();
+            
             // *** heading ***
             
             // Most calculations and data cleansing actions base on timestamp.
@@ -1571,22 +1605,20 @@ void LTFlightData::AppendNewPos()
             // delivers 'dancing' track/heading values for stationary planes.
             // There is no way of finding the 'right' heading in these cases,
             // the plane points anywhere...but at least it doesn't dance.
+            // Heading is recalculated only after this loop. If prev(i) has
+            // been touched in this batch, then its heading is not final yet:
+            // calculate it now, so that p inherits the same heading as it did
+            // when heading was recalculated right after each insert.
             if (i != posDeque.begin()) {            // is there anything before i?
-                const positionTy& prevP = *std::prev(i);
-                const vectorTy vec = prevP.between(p);
-                if (vec.dist <= SIMILAR_POS_DIST)
-                    p.heading() = prevP.heading();
+                const dequePositionTy::iterator iPrev = std::prev(i);
+                const vectorTy vec = iPrev->between(p);
+                if (vec.dist <= SIMILAR_POS_DIST) {
+                    if (tsTouchedFirst <= iPrev->ts() && iPrev->ts() <= tsTouchedLast)
+                        CalcHeading(iPrev);
+                    p.heading() = iPrev->heading();
+                }
             }
             
-            // Recalc heading of adjacent positions: before p, p itself, and after p
-            if (i != posDeque.begin())              // is there anything before i?
-                CalcHeading(std::prev(i));
-            
-            CalcHeading(i);                         // i itself, latest here a nan heading is rectified
-            
-            if (std::next(i) != posDeque.end())     // is there anything after i?
-                CalcHeading(std::next(i));
-            
             // *** pitch ***
             // just a rough value, LTAircraft::CalcPPos takes care of the details
             if (p.onGrnd)
@@ -1597,11 +1629,27 @@ void LTFlightData::AppendNewPos()
             // *** roll ***
             // LTAircraft::CalcPPos takes care of the details
             p.roll() = 0;
-            
-            // *** last checks ***
-            
-            // should be fully valid position now
-            LOG_ASSERT_FD(*this, p.isFullyValid());
+        }
+        posToAdd.clear();
+        
+        // Recalc heading once for all touched positions plus one adjacent position before and after
+        if (!std::isnan(tsTouchedFirst)) {
+            dequePositionTy::iterator iFirst =
+            std::lower_bound(posDeque.begin(), posDeque.end(), tsTouchedFirst,
+                             [](const positionTy& p, double ts){return p.ts() < ts;});
+            dequePositionTy::iterator iEnd =
+            std::upper_bound(posDeque.begin(), posDeque.end(), tsTouchedLast,
+                             [](double ts, const positionTy& p){return ts < p.ts();});
+            if (iFirst != posDeque.begin())
+                --iFirst;
+            if (iEnd != posDeque.end())
+                ++iEnd;
+            for (dequePositionTy::iterator i = iFirst; i != iEnd; ++i) {
+                CalcHeading(i);                     // latest here a nan heading is rectified
+                // *** last checks ***
+                // should be fully valid position now
+                LOG_ASSERT_FD(*this, i->isFullyValid());
+            }
         }
         
         // posDeque should be sorted, i.e. no two adjacent positions a,b should be a > b
@@ -1621,6 +1669,10 @@ void LTFlightData::AppendNewPos()
             TriggerCalcNewPos(NAN);
         }
         
+        // enough positions to create an aircraft? Then have maintenance look at us soon
+        if (!hasAc() && posDeque.size() >= 2)
+            wheelFdMaint.ScheduleBefore(key(), dataRefs.GetSimTime());
+        
         // print all positional information as debug info on request
         if (dataRefs.GetDebugAcPos(key())) {
             LOG_MSG(logDEBUG,DBG_POS_DATA,Positions2String().c_str());
@@ -1641,12 +1693,7 @@ LTFlightData::tryResult LTFlightData::TryFetchNewPos (dequePositionTy& acPosList
         
         // we are called from X-Plane's main thread,
         // so we take our chance to determine proper terrain altitudes
-        for (positionTy& pos: posDeque) {
-            if ((pos.IsOnGnd() && std::isnan(pos.alt_m())) ||    // GND_ON but alt unknown
-                pos.onGrnd == positionTy::GND_UNKNOWN) {    // GND_UNKNOWN
-                TryDeriveGrndStatus(pos);
-            }
-        }
+        DeriveGrndStatus(posDeque, false);
         
         // the very first call (i.e. FD doesn't even know the a/c's ptr yet)?
         if (!pAc) {
@@ -1702,27 +1749,12 @@ bool LTFlightData::TryDeriveGrndStatus (positionTy& pos)
         if ( lock )
         {
             // what's the terrain altitude at that pos?
-            double terrainAlt = YProbe_at_m(pos);
-            if (std::isnan(terrainAlt))
+            pos.terrainAlt = YProbe_at_m(pos);
+            if (std::isnan(pos.terrainAlt))
                 return false;
             
-            // Now 2 options:
-            // If position already says itself: I'm on the ground, then keep it like that
-            // Otherwise decide based on altitude _if_ it's on the ground
-            if (!pos.IsOnGnd() &&
-                // say it's on the ground if below terrain+10ft
-                pos.alt_m() < terrainAlt + FD_GND_AGL)
-                pos.onGrnd = positionTy::GND_ON;
-
-            // if it was or now is on the ground correct the altitue to terrain altitude
-            // (very slightly below to be sure to actually touch down even after rounding effects)
-            if (pos.IsOnGnd())
-                pos.alt_m() = terrainAlt - MDL_CLOSE_TO_GND;
-            else
-                // make sure it's either GND_ON or GND_OFF, nothing lese
-                pos.onGrnd = positionTy::GND_OFF;
-
             // successfully determined a status
+            ClassifyGrndStatus(pos);
             return true;
         }
     } catch(const std::system_error& e) {
@@ -1733,6 +1765,52 @@ bool LTFlightData::TryDeriveGrndStatus (positionTy& pos)
     return false;
 }
 
+// Batch stage: determines ground status of positions
+void LTFlightData::DeriveGrndStatus (dequePositionTy& dq, bool bAll)
+{
+    // Pass 1: select the positions in question and probe their terrain,
+    //         unless already known from an earlier pass
+    //         (static buffer is fine as we run in X-Plane's main thread only)
+    static std::vector<positionTy*> vecPos;
+    vecPos.clear();
+    for (positionTy& pos: dq) {
+        if (bAll ||
+            pos.onGrnd == positionTy::GND_UNKNOWN ||                // GND_UNKNOWN
+            (pos.IsOnGnd() && std::isnan(pos.alt_m())))             // GND_ON but alt unknown
+        {
+            if (bAll || std::isnan(pos.terrainAlt))
+                pos.terrainAlt = YProbe_at_m(pos);
+            vecPos.push_back(&pos);
+        }
+    }
+    
+    // Pass 2: classify them all in one sweep
+    for (positionTy* pPos: vecPos)
+        ClassifyGrndStatus(*pPos);
+}
+
+// Classifies ground status based on the known terrain altitude
+void LTFlightData::ClassifyGrndStatus (positionTy& pos)
+{
+    // without terrain we can't say anything
+    if (std::isnan(pos.terrainAlt))
+        return;
+    
+    // Now 2 options:
+    // If position already says itself: I'm on the ground, then keep it like that
+    // Otherwise decide based on altitude _if_ it's on the ground
+    // (say it's on the ground if below terrain+FD_GND_AGL)
+    const bool bGnd = pos.IsOnGnd() || pos.alt_m() < pos.terrainAlt + FD_GND_AGL;
+    
+    // make sure it's either GND_ON or GND_OFF, nothing else
+    pos.onGrnd = bGnd ? positionTy::GND_ON : positionTy::GND_OFF;
+    
+    // if it was or now is on the ground correct the altitue to terrain altitude
+    // (very slightly below to be sure to actually touch down even after rounding effects)
+    if (bGnd)
+        pos.alt_m() = pos.terrainAlt - MDL_CLOSE_TO_GND;
+}
+
 // determine terrain alt at pos
 double LTFlightData::YProbe_at_m (const positionTy& pos)
 {
@@ -2122,8 +2200,11 @@ LTFlightData::FDStaticData LTFlightData::WaitForSafeCopyStat() const
 
 // checks if initial position to be calculated or aircraft to be created
 // returns if a/c is to be deleted
-bool LTFlightData::AircraftMaintenance ( double simTime )
+bool LTFlightData::AircraftMaintenance ( double simTime, double& nextMaint )
 {
+    // unless we find a reason to wait longer we want to be called again in the normal interval
+    nextMaint = simTime + AC_MAINT_INTVL;
+    
     try {
         // try to lock data access
         std::unique_lock<std::recursive_mutex> lock (dataAccessMutex, std::try_to_lock);
@@ -2157,6 +2238,12 @@ bool LTFlightData::AircraftMaintenance ( double simTime )
                     TriggerCalcNewPos(NAN);
         }
         
+        // Without aircraft and without enough positions to create one
+        // there is nothing to do until we become outdated.
+        // (AppendNewPos reschedules us when positions arrive.)
+        if (!hasAc() && posDeque.size() < 2)
+            nextMaint = std::max(nextMaint, youngestTS + dataRefs.GetAcOutdatedIntvl());
+        
         // don't delete me
         return false;
         
@@ -2175,6 +2262,43 @@ bool LTFlightData::AircraftMaintenance ( double simTime )
 
 
 
+// Makes room for a predicted threat to the user's plane by removing the
+// farthest aircraft, which is no threat itself. Its flight data stays,
+// so it comes back once there is room again.
+// Main thread only (destroys an aircraft), mapFdMutex must be locked.
+static bool DisplaceFarthestNonThreat (const LTFlightData::FDKeyTy& keyThreat)
+{
+    const vecCpaTy threats = LTCpaGetThreats();
+    LTFlightData* pFarthest = nullptr;
+    double farthestDist = -1.0;
+    for (mapLTFlightDataTy::value_type& fdPair: mapFd) {
+        const LTAircraft* pAc = fdPair.second.GetAircraft();
+        if (!pAc ||
+            std::any_of(threats.cbegin(), threats.cend(),
+                        [&](const CpaTy& cpa){ return cpa.key == fdPair.first; }))
+            continue;
+        if (pAc->GetVecView().dist > farthestDist) {
+            farthestDist = pAc->GetVecView().dist;
+            pFarthest = &fdPair.second;
+        }
+    }
+    if (!pFarthest)
+        return false;
+    
+    // don't wait for a busy flight data object, try again next time
+    try {
+        std::unique_lock<std::recursive_mutex> lock (pFarthest->dataAccessMutex, std::try_to_lock);
+        if (!lock)
+            return false;
+        LOG_MSG(logDEBUG, DBG_CPA_DISPLACED, pFarthest->key().c_str(), keyThreat.c_str());
+        pFarthest->DestroyAircraft();
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, pFarthest->key().c_str(), e.what());
+        return false;
+    }
+    return true;
+}
+
 // create (at most one) aircraft from this flight data
 bool LTFlightData::CreateAircraft ( double simTime )
 {
@@ -2184,7 +2308,9 @@ bool LTFlightData::CreateAircraft ( double simTime )
     if ( hasAc() ) return true;
     
     // short-cut if too many aircraft created already
-    if ( dataRefs.GetNumAc() >= dataRefs.GetMaxNumAc() ) {
+    // (predicted threats to the user's plane displace the farthest other aircraft)
+    if ( dataRefs.GetNumAc() >= dataRefs.GetMaxNumAc() &&
+         !(LTCpaIsThreat(key()) && DisplaceFarthestNonThreat(key())) ) {
         if ( !bTooManyAcMsgShown )              // show warning once only per session
             SHOW_MSG(logWARN,MSG_TOO_MANY_AC,dataRefs.GetMaxNumAc());
         bTooManyAcMsgShown = true;
@@ -74,36 +74,8 @@ void ForeFlightSender::Close ()
 }
 
 
-// Start/Stop the thread, which sends the data
+// Start/Stop the NetEventLoop timer, which sends the data
 bool ForeFlightSender::StartConnection ()
-{
-    bStopUdpSender = false;
-    if (!thrUdpSender.joinable())
-        thrUdpSender = std::thread (udpSendS, this);
-    return true;
-}
-
-bool ForeFlightSender::StopConnection ()
-{
-    // is there a main thread running? -> stop it and wait for it to return
-    if ( thrUdpSender.joinable() )
-    {
-        // stop the main thread
-        bStopUdpSender = true;              // the message is: Stop!
-        ffStopCV.notify_all();              // wake up the thread for stop
-        thrUdpSender.join();                // wait for thread to finish
-        
-        thrUdpSender = std::thread();
-    }
-    return true;
-}
-
-//
-// MARK: Send information
-//
-
-// thread main function
-void ForeFlightSender::udpSend()
 {
     //
     // *** open the UDP socket ***
@@ -128,122 +100,134 @@ void ForeFlightSender::udpSend()
     if (!udpSender.isOpen()) {
         // no: invalidate the channel
         SetValid(false, true);
-        return;
+        return false;
+    }
+    
+    // register the sending timer
+    if (!timerId) {
+        lastKey = LTFlightData::FDKeyTy();
+        timerId = NetEventLoop::Get().AddTimer(LTClock::now(),
+                                               [this]{ return udpSend(); });
+    }
+    return true;
+}
+
+bool ForeFlightSender::StopConnection ()
+{
+    // is there a timer running? -> remove it (waits for a running call)
+    if (timerId)
+    {
+        NetEventLoop::Get().RemoveTimer(timerId);
+        timerId = 0;
     }
     
     //
-    // *** Loop for sending data ***
-    //
-    // We place 20ms pause between any two broadcasts in order not to overtax
-    // the network. Increases reliability. The logic is then as follows:
-    // The loop keeps running till stop.
-    // We check if it is time for ATT or GPS data and send that if so.
-    // If not we continue with the traffic planes.
-    //   Once we reach the end of all traffic we won't start again
-    //   before reaching the proper time.
-    // Between any two broadcasts there is 20ms break.
+    // *** close the UDP socket ***
     //
-    LTFlightData::FDKeyTy lastKey;          // last traffic sent out
-    while ( !bStopUdpSender )
-    {
-        bool bDidSendSomething = false;
-        
-        // now
-        std::chrono::time_point<std::chrono::steady_clock> now =
-        std::chrono::steady_clock::now();
-        
-        // send user's plane at all?
-        if (bSendUsersPlane) {
-            double airSpeed_m   = 0.0;
-            double track        = 0.0;
-            positionTy pos;
+    if (udpSender.isOpen()) {
+        udpSender.Close();
+        LOG_MSG(logINFO, MSG_FF_STOPPED);
+    }
+    return true;
+}
 
-            // time for GPS?
-            if (now >= nextGPS)
-            {
+//
+// MARK: Send information
+//
+
+// NetEventLoop timer handler: sends what's due, returns next wakeup
+//
+// We place 20ms pause between any two broadcasts in order not to overtax
+// the network. Increases reliability. The logic is then as follows:
+// We check if it is time for ATT or GPS data and send that if so.
+// If not we continue with the traffic planes.
+//   Once we reach the end of all traffic we won't start again
+//   before reaching the proper time.
+// Between any two broadcasts there is 20ms break.
+NetEventLoop::timePointTy ForeFlightSender::udpSend()
+{
+    bool bDidSendSomething = false;
+    
+    // now
+    LTClock::time_point now = LTClock::now();
+    
+    // send user's plane at all?
+    if (bSendUsersPlane) {
+        double airSpeed_m   = 0.0;
+        double track        = 0.0;
+        positionTy pos;
+
+        // time for GPS?
+        if (now >= nextGPS)
+        {
+            pos = dataRefs.GetUsersPlanePos(airSpeed_m, track);
+            SendGPS(pos, airSpeed_m, track);
+            nextGPS = now + FF_INTVL_GPS;
+            bDidSendSomething = true;
+        }
+        
+        // time for ATT?
+        if (now >= nextAtt)
+        {
+            if (!pos.isNormal())
                 pos = dataRefs.GetUsersPlanePos(airSpeed_m, track);
-                SendGPS(pos, airSpeed_m, track);
-                nextGPS = now + FF_INTVL_GPS;
-                bDidSendSomething = true;
-            }
-            
-            // time for ATT?
-            if (now >= nextAtt)
-            {
-                if (!pos.isNormal())
-                    pos = dataRefs.GetUsersPlanePos(airSpeed_m, track);
-                SendAtt(pos, airSpeed_m, track);
-                nextAtt = now + FF_INTVL_ATT;
-                bDidSendSomething = true;
-            }
+            SendAtt(pos, airSpeed_m, track);
+            nextAtt = now + FF_INTVL_ATT;
+            bDidSendSomething = true;
         }
+    }
 
-        // send traffic at all?
-        // not yet send GPS/ATT?
-        // time to send some traffic?
-        if (bSendAITraffic && !bDidSendSomething &&
-            now >= nextTraffic)
-        {
-            // from here on access to fdMap guarded by a mutex
-            std::unique_lock<std::mutex> lock (mapFdMutex, std::try_to_lock);
-            if (lock) {
-                if (!fdMap.empty()) {
-                    // just starting with a new round?
-                    if (lastKey == LTFlightData::FDKeyTy())
-                        lastStartOfTraffic = now;
-                    
-                    // next key to send? (shall have an actual a/c)
-                    mapLTFlightDataTy::const_iterator mapIter;
-                    for (mapIter = fdMap.upper_bound(lastKey);
-                         mapIter != fdMap.cend() && !mapIter->second.hasAc();
-                         mapIter++);
-                    
-                    // something left?
-                    if (mapIter != fdMap.cend()) {
-                        // send that plane's info
-                        SendTraffic(mapIter->second);
-                        // wake up soon again for the rest
-                        lastKey = mapIter->first;
-                        nextTraffic = now + FF_INTVL;
-                    }
-                    else {
-                        // we're done with one round, start over
-                        lastKey = LTFlightData::FDKeyTy();
-                        nextTraffic = lastStartOfTraffic + std::chrono::seconds(DataRefs::GetCfgInt(DR_CFG_FF_SEND_TRAFFIC_INTVL));
-                    }
+    // send traffic at all?
+    // not yet send GPS/ATT?
+    // time to send some traffic?
+    if (bSendAITraffic && !bDidSendSomething &&
+        now >= nextTraffic)
+    {
+        // from here on access to fdMap guarded by a mutex
+        std::unique_lock<std::mutex> lock (mapFdMutex, std::try_to_lock);
+        if (lock) {
+            if (!fdMap.empty()) {
+                // just starting with a new round?
+                if (lastKey == LTFlightData::FDKeyTy())
+                    lastStartOfTraffic = now;
+                
+                // next key to send? (shall have an actual a/c)
+                mapLTFlightDataTy::const_iterator mapIter;
+                for (mapIter = fdMap.upper_bound(lastKey);
+                     mapIter != fdMap.cend() && !mapIter->second.hasAc();
+                     mapIter++);
+                
+                // something left?
+                if (mapIter != fdMap.cend()) {
+                    // send that plane's info
+                    SendTraffic(mapIter->second);
+                    // wake up soon again for the rest
+                    lastKey = mapIter->first;
+                    nextTraffic = now + FF_INTVL;
                 }
                 else {
-                    // map's empty, so we are done
+                    // we're done with one round, start over
                     lastKey = LTFlightData::FDKeyTy();
                     nextTraffic = lastStartOfTraffic + std::chrono::seconds(DataRefs::GetCfgInt(DR_CFG_FF_SEND_TRAFFIC_INTVL));
                 }
-            } else {
-                // wake up soon again for the rest
-                nextTraffic = now + FF_INTVL;
             }
-        }
-        
-        // sleep until time or if woken up for termination
-        // by condition variable trigger
-        if (!bStopUdpSender)
-        {
-            std::chrono::time_point<std::chrono::steady_clock> nextWakeup =
-            bSendUsersPlane && bSendAITraffic  ? std::min({nextGPS, nextAtt, nextTraffic}) :
-            bSendUsersPlane && !bSendAITraffic ? std::min(nextGPS, nextAtt) :
-            nextTraffic;
-            
-            std::unique_lock<std::mutex> lk(ffStopMutex);
-            ffStopCV.wait_until(lk, nextWakeup,
-                                [this]{return bStopUdpSender;});
-            lk.unlock();
+            else {
+                // map's empty, so we are done
+                lastKey = LTFlightData::FDKeyTy();
+                nextTraffic = lastStartOfTraffic + std::chrono::seconds(DataRefs::GetCfgInt(DR_CFG_FF_SEND_TRAFFIC_INTVL));
+            }
+        } else {
+            // wake up soon again for the rest
+            nextTraffic = now + FF_INTVL;
         }
     }
     
-    //
-    // *** close the UDP socket ***
-    //
-    udpSender.Close();
-    LOG_MSG(logINFO, MSG_FF_STOPPED);
+    // next wakeup
+    return
+    bSendUsersPlane && bSendAITraffic  ? std::min({nextGPS, nextAtt, nextTraffic}) :
+    bSendUsersPlane && !bSendAITraffic ? std::min(nextGPS, nextAtt) :
+    bSendAITraffic                     ? nextTraffic :
+    now + FF_INTVL_GPS;                 // nothing to send, just check config regularly
 }
 
 // Send all traffic aircraft's data
@@ -284,8 +284,16 @@ float LoopCBAircraftMaintenance (float inElapsedSinceLastCall, float, int, void*
         try {
             // Refresh airport data from apt.dat (in case camera moved far)
             LTAptRefresh();
+            // settings changes (remove what no longer applies)
+            LTFlightDataApplyCfgChanges(dataRefs.FetchCfgChanges());
             // maintenance (add/remove)
             LTFlightDataAcMaintenance();
+            // lightweight aircraft of the regional ring
+            LTRegionalMaintenance();
+            // memory accounting and budget
+            LTFlightDataMemCheck();
+            // predict closest approaches to the user's plane
+            LTCpaUpdate();
             // updates to menu item status
             MenuUpdateAllItemStatus();
         } catch (const std::exception& e) {
@@ -491,7 +499,7 @@ bool LTMainShowAircraft ()
     if ( dataRefs.AreAircraftDisplayed() ) return true;
     
     // select aircraft for display
-    dataRefs.ChTsOffsetReset();             // reset network time offset
+    dataRefs.ChTsOffsetReset();             // network time offset as predicted so far
     if ( !LTFlightDataShowAircraft() ) return false;
 
     // Now only enable multiplay lib - this acquires multiplayer planes
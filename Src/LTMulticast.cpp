@@ -0,0 +1,485 @@
+/// @file       LTMulticast.cpp
+/// @brief      Multicast: Shares cleansed positions between LiveTraffic instances on a LAN
+/// @details    Implements MulticastSender and MulticastReceiver:\n
+///             - The sender regularly publishes new positions of all aircraft,
+///               as found in the flight data after data cleansing,
+///               in a compact binary format to a UDP multicast group.\n
+///             - The receiver listens to the group and passes the positions
+///               on to its own LTFlightData.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+// All includes are collected in one header
+#include "LiveTraffic.h"
+
+#include <random>
+
+//
+// MARK: Binary encoding (little endian)
+//
+
+/// Writes `len` bytes of `v`, least significant first
+static void mcPut (uint8_t* p, uint64_t v, size_t len)
+{
+    for (size_t i = 0; i < len; i++, v >>= 8)
+        p[i] = uint8_t(v & 0xFF);
+}
+
+/// Reads `len` bytes, least significant first
+static uint64_t mcGet (const uint8_t* p, size_t len)
+{
+    uint64_t v = 0;
+    for (size_t i = len; i > 0; i--)
+        v = (v << 8) | p[i-1];
+    return v;
+}
+
+/// Writes a text into a fixed-length field, padded with zeros
+static void mcPutStr (uint8_t* p, const std::string& s, size_t len)
+{
+    memset(p, 0, len);
+    memcpy(p, s.data(), std::min(s.size(), len));
+}
+
+/// Reads a text from a fixed-length field
+static std::string mcGetStr (const uint8_t* p, size_t len)
+{
+    const uint8_t* pEnd = (const uint8_t*)memchr(p, 0, len);
+    return std::string((const char*)p, pEnd ? size_t(pEnd - p) : len);
+}
+
+/// Limits `d` to the given range and rounds it
+static long mcClamp (double d, long lo, long hi)
+{
+    if (std::isnan(d)) return 0;
+    return std::clamp(std::lround(d), lo, hi);
+}
+
+/// Random id of this LiveTraffic instance, so we recognize (and ignore) our own datagrams
+static uint32_t mcInstanceId ()
+{
+    static const uint32_t id = []{
+        std::random_device rd;
+        return uint32_t(rd());
+    }();
+    return id;
+}
+
+//
+// MARK: Multicast Sender
+//
+
+// Constructor doesn't do much
+MulticastSender::MulticastSender (mapLTFlightDataTy& _fdMap) :
+LTChannel(DR_CHANNEL_MC_SENDER),
+LTOnlineChannel(),
+LTFlightDataChannel(),
+fdMap(_fdMap)
+{}
+
+MulticastSender::~MulticastSender()
+{
+    // make sure everything's cleaned up
+    StopConnection();
+}
+
+// if called makes sure the socket and the timer are up and running
+bool MulticastSender::FetchAllData(const positionTy&)
+{
+    // if we are invalid or disabled we should shut down
+    if (!IsValid() || !IsEnabled()) {
+        return StopConnection();
+    }
+    return StartConnection();
+}
+
+void MulticastSender::DoDisabledProcessing()
+{
+    // make sure everything's cleaned up
+    StopConnection();
+}
+
+void MulticastSender::Close ()
+{
+    // make sure everything's cleaned up
+    StopConnection();
+}
+
+// Opens the socket and registers the sending timer
+bool MulticastSender::StartConnection ()
+{
+    if (!udpMC.isOpen())
+    {
+        const std::string group = dataRefs.GetMCGroup();
+        const int port = DataRefs::GetCfgInt(DR_CFG_MC_PORT);
+        try {
+            udpMC.Open(MC_ANY_ADDR, 0, MC_MAX_DGRAM_LEN);
+            udpMC.SetSendGroup(group, port, MC_TTL);
+            LOG_MSG(logINFO, MSG_MC_OPENED, ChName(), group.c_str(), port);
+        }
+        catch (NetRuntimeError& e) {
+            LOG_MSG(logERR, ERR_MC_OPEN, ChName(), group.c_str(), port,
+                    e.what(), e.errTxt.c_str());
+            udpMC.Close();
+            // invalidate the channel
+            SetValid(false, true);
+            return false;
+        }
+    }
+
+    // register the sending timer
+    if (!timerId) {
+        mapLastSentTs.clear();
+        timerId = NetEventLoop::Get().AddTimer(LTClock::now(),
+                                               [this]{ return mcSend(); });
+    }
+    return true;
+}
+
+// Removes the timer and closes the socket
+bool MulticastSender::StopConnection ()
+{
+    // is there a timer running? -> remove it (waits for a running call)
+    if (timerId)
+    {
+        NetEventLoop::Get().RemoveTimer(timerId);
+        timerId = 0;
+    }
+
+    if (udpMC.isOpen()) {
+        udpMC.Close();
+        LOG_MSG(logINFO, MSG_MC_STOPPED, ChName());
+    }
+    return true;
+}
+
+// NetEventLoop timer handler: publishes positions added since last call
+NetEventLoop::timePointTy MulticastSender::mcSend ()
+{
+    const NetEventLoop::timePointTy now = LTClock::now();
+
+    // from here on access to fdMap guarded by a mutex,
+    // but we don't want to wait for it in the event loop
+    std::unique_lock<std::mutex> lock (mapFdMutex, std::try_to_lock);
+    if (!lock)
+        return now + MC_RETRY_INTVL;
+
+    std::map<LTFlightData::FDKeyTy,double> mapSentTs;
+    cntRec = 0;
+    for (const mapLTFlightDataTy::value_type& fdPair: fdMap)
+    {
+        const LTFlightData& fd = fdPair.second;
+        // what we sent last time
+        auto iterLast = mapLastSentTs.find(fdPair.first);
+        double lastTs = iterLast == mapLastSentTs.end() ? 0.0 : iterLast->second;
+
+        // don't wait for the flight data, try again next time
+        std::unique_lock<std::recursive_mutex> fdLock (fd.dataAccessMutex, std::try_to_lock);
+        if (fdLock) {
+            const LTFlightData::FDDynamicData dyn = fd.GetUnsafeDyn();
+            // don't echo what we received via multicast ourselves
+            if (dyn.pChannel && dyn.pChannel->GetChannel() == DR_CHANNEL_MC_RECEIVER)
+                continue;
+
+            // all positions added since last time
+            for (const positionTy& pos: fd.GetPosDeque()) {
+                if (pos.ts() <= lastTs)
+                    continue;
+                EncodeRecord(dgram + MC_HEADER_LEN + cntRec * MC_RECORD_LEN,
+                             fdPair.first, fd.GetUnsafeStat(), dyn, pos);
+                lastTs = pos.ts();
+                if (++cntRec >= MC_MAX_REC_PER_DGRAM)
+                    SendDgram();
+            }
+        }
+
+        // remember for next time (also keeps entries of aircraft we didn't get a lock for)
+        if (lastTs > 0.0)
+            mapSentTs.emplace(fdPair.first, lastTs);
+    }
+    lock.unlock();
+
+    // send the rest
+    SendDgram();
+
+    // aircraft no longer in fdMap are hereby removed
+    mapLastSentTs.swap(mapSentTs);
+    return now + MC_SEND_INTVL;
+}
+
+// Sends and empties `dgram`
+void MulticastSender::SendDgram ()
+{
+    if (!cntRec)
+        return;
+
+    // header
+    memcpy(dgram, MC_MAGIC, sizeof(MC_MAGIC));
+    mcPut(dgram + 4, MC_VERSION, 1);
+    mcPut(dgram + 5, cntRec, 1);
+    mcPut(dgram + 6, MC_RECORD_LEN, 2);
+    mcPut(dgram + 8, mcInstanceId(), 4);
+
+    if (!udpMC.SendToGroup(dgram, MC_HEADER_LEN + cntRec * MC_RECORD_LEN))
+        IncErrCnt();
+    cntRec = 0;
+}
+
+// Encodes one position record
+void MulticastSender::EncodeRecord (uint8_t* p,
+                                    const LTFlightData::FDKeyTy& key,
+                                    const LTFlightData::FDStaticData& stat,
+                                    const LTFlightData::FDDynamicData& dyn,
+                                    const positionTy& pos)
+{
+    const bool bGnd = pos.IsOnGnd();
+    mcPut(p +  0, uint64_t(key.eKeyType), 1);
+    mcPut(p +  1, bGnd ? 1 : 0, 1);
+    mcPut(p +  2, uint64_t(mcClamp(double(dyn.radar.code), 0, 0xFFFF)), 2);
+    mcPut(p +  4, uint64_t(key.num), 4);
+    uint64_t u64 = 0;
+    const double ts = pos.ts();
+    memcpy(&u64, &ts, sizeof(u64));
+    mcPut(p +  8, u64, 8);
+    mcPut(p + 16, uint64_t(uint32_t(int32_t(mcClamp(pos.lat() * 1e7, -900000000L, 900000000L)))), 4);
+    mcPut(p + 20, uint64_t(uint32_t(int32_t(mcClamp(pos.lon() * 1e7, -1800000000L, 1800000000L)))), 4);
+    uint32_t u32 = 0;
+    const float alt = float(pos.alt_m());
+    memcpy(&u32, &alt, sizeof(u32));
+    mcPut(p + 24, u32, 4);
+    mcPut(p + 28, uint64_t(mcClamp(HeadingNormalize(pos.heading()) * 100.0, 0, 35999)), 2);
+    mcPut(p + 30, uint64_t(uint16_t(int16_t(mcClamp(dyn.vsi, -32767, 32767)))), 2);
+    mcPut(p + 32, uint64_t(mcClamp(dyn.spd * 10.0, 0, 0xFFFF)), 2);
+    mcPut(p + 34, uint64_t(stat.trt), 1);
+    mcPut(p + 35, 0, 1);
+    mcPutStr(p + 36, stat.call, 8);
+    mcPutStr(p + 44, stat.acTypeIcao, 4);
+    mcPutStr(p + 48, stat.opIcao, 4);
+    mcPutStr(p + 52, stat.reg, 12);
+}
+
+//
+// MARK: Multicast Receiver
+//
+
+// Constructor doesn't do much
+MulticastReceiver::MulticastReceiver (mapLTFlightDataTy& _fdMap) :
+LTChannel(DR_CHANNEL_MC_RECEIVER),
+LTOnlineChannel(),
+LTFlightDataChannel(),
+fdMap(_fdMap)
+{}
+
+MulticastReceiver::~MulticastReceiver()
+{
+    // make sure everything's cleaned up
+    StopConnection();
+}
+
+// Does not actually fetch data (NetEventLoop handlers do that) but
+// 1. Starts the connection
+// 2. stores the camera position for the handlers to filter data
+bool MulticastReceiver::FetchAllData(const positionTy& pos)
+{
+    // if we are invalid or disabled we should shut down
+    if (!IsValid() || !IsEnabled()) {
+        return StopConnection();
+    }
+
+    // store camera position for the handlers
+    {
+        std::lock_guard<std::mutex> lock(posMutex);
+        posCamera = pos;
+    }
+
+    return StartConnection();
+}
+
+void MulticastReceiver::DoDisabledProcessing()
+{
+    // make sure everything's cleaned up
+    StopConnection();
+}
+
+void MulticastReceiver::Close ()
+{
+    // make sure everything's cleaned up
+    StopConnection();
+}
+
+// Opens the socket, joins the group, and registers with NetEventLoop
+bool MulticastReceiver::StartConnection ()
+{
+    if (!udpMC.isOpen())
+    {
+        const std::string group = dataRefs.GetMCGroup();
+        const int port = DataRefs::GetCfgInt(DR_CFG_MC_PORT);
+        try {
+            // buffer needs one more byte as `recv` zero-terminates
+            udpMC.Open(MC_ANY_ADDR, port, MC_MAX_DGRAM_LEN + 1);
+            udpMC.JoinGroup(group);
+            RefreshFilter();
+            NetEventLoop& loop = NetEventLoop::Get();
+            loop.AddSocket(udpMC.getSocket(), [this]{ OnData(); });
+            timerId = loop.AddTimer(LTClock::now() + MC_COMMIT_INTVL,
+                                    [this]{ return OnTimer(); });
+            LOG_MSG(logINFO, MSG_MC_OPENED, ChName(), group.c_str(), port);
+        }
+        catch (NetRuntimeError& e) {
+            LOG_MSG(logERR, ERR_MC_OPEN, ChName(), group.c_str(), port,
+                    e.what(), e.errTxt.c_str());
+            udpMC.Close();
+            // invalidate the channel
+            SetValid(false, true);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Unregisters and closes the socket
+bool MulticastReceiver::StopConnection ()
+{
+    try {
+        // make sure no handler runs while we clean up
+        NetEventLoop& loop = NetEventLoop::Get();
+        std::lock_guard<std::recursive_mutex> lock (loop.GetMutex());
+        if (timerId) {
+            loop.RemoveTimer(timerId);
+            timerId = 0;
+        }
+        if (udpMC.isOpen()) {
+            loop.RemoveSocket(udpMC.getSocket());
+            udpMC.Close();
+            LOG_MSG(logINFO, MSG_MC_STOPPED, ChName());
+        }
+        vecUpd.clear();
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "loopMutex", e.what());
+    }
+    return true;
+}
+
+// Socket handler: receives and decodes one datagram
+void MulticastReceiver::OnData ()
+{
+    // doesn't wait if there is nothing after all
+    const long n = udpMC.timedRecv(0);
+    if (n < 0) {
+        // not just a normal timeout?
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            char sErr[SERR_LEN];
+            strerror_s(sErr, sizeof(sErr), errno);
+            LOG_MSG(logERR, ERR_UDP_RCVR_RCVR, ChName(), sErr);
+            IncErrCnt();
+        }
+        return;
+    }
+
+    // validate header, ignore our own datagrams
+    const uint8_t* p = (const uint8_t*)udpMC.getBuf();
+    if (size_t(n) < MC_HEADER_LEN ||
+        memcmp(p, MC_MAGIC, sizeof(MC_MAGIC)) != 0 ||
+        mcGet(p + 4, 1) != MC_VERSION ||
+        mcGet(p + 8, 4) == mcInstanceId())
+        return;
+    const size_t cnt = size_t(mcGet(p + 5, 1));
+    const size_t recLen = size_t(mcGet(p + 6, 2));
+    if (recLen < MC_RECORD_LEN || size_t(n) < MC_HEADER_LEN + cnt * recLen)
+        return;
+
+    // decode records
+    netRcvTs = NetNow();
+    for (size_t i = 0; i < cnt; i++) {
+        FDUpdateTy upd;
+        if (!DecodeRecord(p + MC_HEADER_LEN + i * recLen, upd))
+            continue;
+        // still interested in this aircraft?
+        if (!IsRecordOfInterest(upd.key, acFilter, viewPos,
+                                upd.pos.lat(), upd.pos.lon(), upd.pos.alt_m()))
+            continue;
+        upd.dyn.pChannel = this;
+        SetRcvTs(upd.pos);
+        vecUpd.push_back(std::move(upd));
+    }
+}
+
+// Timer handler: commits updates, refreshes filter data
+NetEventLoop::timePointTy MulticastReceiver::OnTimer ()
+{
+    CommitUpdates(fdMap, vecUpd, viewPos);
+    vecUpd.clear();
+    RefreshFilter();
+    return LTClock::now() + MC_COMMIT_INTVL;
+}
+
+// Refreshes viewPos and acFilter
+void MulticastReceiver::RefreshFilter ()
+{
+    {
+        std::lock_guard<std::mutex> lock(posMutex);
+        viewPos = posCamera;
+    }
+    acFilter = dataRefs.GetDebugAcFilter();
+}
+
+// Decodes one position record
+bool MulticastReceiver::DecodeRecord (const uint8_t* p, LTFlightDataChannel::FDUpdateTy& upd)
+{
+    // key
+    const uint64_t keyType = mcGet(p, 1);
+    if (keyType <= LTFlightData::KEY_UNKNOWN || keyType > LTFlightData::KEY_ICAO)
+        return false;
+    upd.key = LTFlightData::FDKeyTy(LTFlightData::FDKeyType(keyType),
+                                    (unsigned long)mcGet(p + 4, 4));
+
+    // static data
+    LTFlightData::FDStaticData& stat = upd.stat;
+    stat.trt        = transpTy(mcGet(p + 34, 1));
+    stat.call       = mcGetStr(p + 36, 8);
+    stat.acTypeIcao = mcGetStr(p + 44, 4);
+    stat.opIcao     = mcGetStr(p + 48, 4);
+    stat.reg        = mcGetStr(p + 52, 12);
+
+    // dynamic data
+    const bool bGnd = mcGet(p + 1, 1) & 0x01;
+    uint64_t u64 = mcGet(p + 8, 8);
+    double ts = 0.0;
+    memcpy(&ts, &u64, sizeof(ts));
+    uint32_t u32 = uint32_t(mcGet(p + 24, 4));
+    float alt = 0.0f;
+    memcpy(&alt, &u32, sizeof(alt));
+
+    LTFlightData::FDDynamicData& dyn = upd.dyn;
+    dyn.radar.code  = long(mcGet(p + 2, 2));
+    dyn.gnd         = bGnd;
+    dyn.heading     = double(mcGet(p + 28, 2)) / 100.0;
+    dyn.vsi         = double(int16_t(uint16_t(mcGet(p + 30, 2))));
+    dyn.spd         = double(mcGet(p + 32, 2)) / 10.0;
+    dyn.ts          = ts;
+
+    // position
+    upd.pos = positionTy(double(int32_t(uint32_t(mcGet(p + 16, 4)))) / 1e7,
+                         double(int32_t(uint32_t(mcGet(p + 20, 4)))) / 1e7,
+                         double(alt), ts, dyn.heading);
+    upd.pos.onGrnd = bGnd ? positionTy::GND_ON : positionTy::GND_OFF;
+
+    // position is rather important, we check for validity
+    upd.bPos = upd.pos.isNormal(true);
+    return true;
+}
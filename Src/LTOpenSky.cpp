@@ -32,7 +32,12 @@
 // put together the URL to fetch based on current view position
 std::string OpenSkyConnection::GetURL (const positionTy& pos)
 {
-    boundingBoxTy box (pos, dataRefs.GetFdStdDistance_m());
+    return GetTileURL(GetQueryArea(pos));
+}
+
+// put together the URL to fetch a given bounding box
+std::string OpenSkyConnection::GetTileURL (const boundingBoxTy& box)
+{
     char url[128] = "";
     snprintf(url, sizeof(url),
              OPSKY_URL_ALL,
@@ -57,6 +62,12 @@ bool OpenSkyConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
     JSON_Value* pRoot = json_parse_string(netData);
     if (!pRoot) { LOG_MSG(logERR,ERR_JSON_PARSE); IncErrCnt(); return false; }
     
+    // We need the camera position for early rejection of far away aircraft
+    const positionTy viewPos = dataRefs.GetViewPos();
+    
+    // decoded updates, committed to fdMap at the end
+    vecFDUpdateTy vecUpd;
+    
     // let's cycle the aircraft
     // first get the structre's main object
     JSON_Object* pObj = json_object(pRoot);
@@ -66,7 +77,7 @@ bool OpenSkyConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
     double opSkyTime = jog_n(pObj, OPSKY_TIME);
     if (opSkyTime > JAN_FIRST_2019)
         // if reasonable add this to our time offset calculation
-        dataRefs.ChTsOffsetAdd(opSkyTime);
+        dataRefs.ChTsOffsetAdd(GetChannel(), opSkyTime);
     
     // fetch the aircraft array
     JSON_Array* pJAcList = json_object_get_array(pObj, OPSKY_AIRCRAFT_ARR);
@@ -95,79 +106,62 @@ bool OpenSkyConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
         }
         
         // the key: transponder Icao code
+        // (normalized by FDKeyTy, OpenSky sends lower case)
         LTFlightData::FDKeyTy fdKey (LTFlightData::KEY_ICAO,
                                      jag_s(pJAc, OPSKY_TRANSP_ICAO));
         
-        // not matching a/c filter? -> skip it
-        if ((!acFilter.empty() && (fdKey != acFilter)) )
-        {
+        // early reject based on key and position only,
+        // before decoding anything else or taking any lock
+        if (!IsRecordOfInterest(fdKey, acFilter, viewPos,
+                                jag_n_nan(pJAc, OPSKY_LAT),
+                                jag_n_nan(pJAc, OPSKY_LON),
+                                jag_n_nan(pJAc, OPSKY_ELEVATION)))
             continue;
-        }
         
-        try {
-            // from here on access to fdMap guarded by a mutex
-            // until FD object is inserted and updated
-            std::lock_guard<std::mutex> mapFdLock (mapFdMutex);
-            
-            // get the fd object from the map, key is the transpIcao
-            // this fetches an existing or, if not existing, creates a new one
-            LTFlightData& fd = fdMap[fdKey];
-            
-            // also get the data access lock once and for all
-            // so following fetch/update calls only make quick recursive calls
-            std::lock_guard<std::recursive_mutex> fdLock (fd.dataAccessMutex);
-            
-            // completely new? fill key fields
-            if ( fd.empty() )
-                fd.SetKey(fdKey);
-            
-            // fill static data
-            {
-                LTFlightData::FDStaticData stat;
-                stat.country =    jag_s(pJAc, OPSKY_COUNTRY);
-                stat.trt     =    trt_ADS_B_unknown;
-                stat.call    =    jag_s(pJAc, OPSKY_CALL);
-                while (!stat.call.empty() && stat.call.back() == ' ')      // trim trailing spaces
-                    stat.call.pop_back();
-                fd.UpdateData(std::move(stat));
-            }
-            
-            // dynamic data
-            {   // unconditional...block is only for limiting local variables
-                LTFlightData::FDDynamicData dyn;
-                
-                // position time
-                double posTime = jag_n(pJAc, OPSKY_POS_TIME);
-                
-                // non-positional dynamic data
-                dyn.radar.code =  (long)jag_sn(pJAc, OPSKY_RADAR_CODE);
-                dyn.gnd =               jag_b(pJAc, OPSKY_GND);
-                dyn.heading =           jag_n_nan(pJAc, OPSKY_HEADING);
-                dyn.spd =               jag_n(pJAc, OPSKY_SPD);
-                dyn.vsi =               jag_n(pJAc, OPSKY_VSI);
-                dyn.ts =                posTime;
-                dyn.pChannel =          this;
-                
-                // position
-                positionTy pos (jag_n_nan(pJAc, OPSKY_LAT),
-                                jag_n_nan(pJAc, OPSKY_LON),
-                                jag_n_nan(pJAc, OPSKY_ELEVATION),
-                                posTime,
-                                dyn.heading);
-                pos.onGrnd = dyn.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
-                
-                // position is rather important, we check for validity
-                // (we do allow alt=NAN if on ground as this is what OpenSky returns)
-                if ( pos.isNormal(true) )
-                    fd.AddDynData(dyn, 0, 0, &pos);
-                else
-                    LOG_MSG(logDEBUG,ERR_POS_UNNORMAL,fdKey.c_str(),pos.dbgTxt().c_str());
-            }
-        } catch(const std::system_error& e) {
-            LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
-        }
+        // decode the record into an update, no lock needed
+        FDUpdateTy& upd = vecUpd.emplace_back();
+        upd.key = std::move(fdKey);
+        
+        // static data
+        upd.stat.country =    jag_s(pJAc, OPSKY_COUNTRY);
+        upd.stat.trt     =    trt_ADS_B_unknown;
+        upd.stat.call    =    jag_s(pJAc, OPSKY_CALL);
+        while (!upd.stat.call.empty() && upd.stat.call.back() == ' ')      // trim trailing spaces
+            upd.stat.call.pop_back();
+        
+        // dynamic data
+        LTFlightData::FDDynamicData& dyn = upd.dyn;
+        
+        // position time
+        double posTime = jag_n(pJAc, OPSKY_POS_TIME);
+        
+        // non-positional dynamic data
+        dyn.radar.code =  (long)jag_sn(pJAc, OPSKY_RADAR_CODE);
+        dyn.gnd =               jag_b(pJAc, OPSKY_GND);
+        dyn.heading =           jag_n_nan(pJAc, OPSKY_HEADING);
+        dyn.spd =               jag_n(pJAc, OPSKY_SPD);
+        dyn.vsi =               jag_n(pJAc, OPSKY_VSI);
+        dyn.ts =                posTime;
+        dyn.pChannel =          this;
+        
+        // position
+        upd.pos = positionTy(jag_n_nan(pJAc, OPSKY_LAT),
+                             jag_n_nan(pJAc, OPSKY_LON),
+                             jag_n_nan(pJAc, OPSKY_ELEVATION),
+                             posTime,
+                             dyn.heading);
+        upd.pos.onGrnd = dyn.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
+        
+        // position is rather important, we check for validity
+        // (we do allow alt=NAN if on ground as this is what OpenSky returns)
+        upd.bPos = upd.pos.isNormal(true);
+        if (!upd.bPos)
+            LOG_MSG(logDEBUG,ERR_POS_UNNORMAL,upd.key.c_str(),upd.pos.dbgTxt().c_str());
     }
     
+    // commit all decoded updates in one go
+    CommitUpdates(fdMap, vecUpd, viewPos);
+    
     // cleanup JSON
     json_value_free (pRoot);
     
@@ -219,7 +213,7 @@ bool OpenSkyAcMasterdata::FetchAllData (const positionTy& /*pos*/)
         // delay subsequent requests
         if (i > 0) {
             // delay between 2 requests to not overload OpenSky
-            std::this_thread::sleep_for(std::chrono::milliseconds(int(OPSKY_WAIT_BETWEEN * 1000.0)));
+            LTClock::SleepFor(std::chrono::milliseconds(int(OPSKY_WAIT_BETWEEN * 1000.0)));
         }
         
         // beginning of a JSON object
@@ -284,7 +278,7 @@ bool OpenSkyAcMasterdata::FetchAllData (const positionTy& /*pos*/)
             currKey = info.callSign;
             
             // delay between 2 requests to not overload OpenSky
-            std::this_thread::sleep_for(std::chrono::milliseconds(int(OPSKY_WAIT_BETWEEN * 1000.0)));
+            LTClock::SleepFor(std::chrono::milliseconds(int(OPSKY_WAIT_BETWEEN * 1000.0)));
             
             // make use of LTOnlineChannel's capability of reading online data
             --maxNumRequ;                               // count down the number of requests in this period
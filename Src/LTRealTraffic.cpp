@@ -25,11 +25,6 @@
 
 #include "LiveTraffic.h"
 
-#if APL == 1 || LIN == 1
-#include <unistd.h>
-#include <fcntl.h>
-#endif
-
 //
 // MARK: RealTraffic Connection
 //
@@ -52,7 +47,7 @@ RealTrafficConnection::~RealTrafficConnection ()
     dataRefs.pRTConn = nullptr;
 }
         
-// Does not actually fetch data (the UDP thread does that) but
+// Does not actually fetch data (NetEventLoop receives UDP data) but
 // 1. Starts the connections
 // 2. updates the RealTraffic local server with out current position
 // 3. cleans up map of datagrams for duplicate check
@@ -123,6 +118,11 @@ void RealTrafficConnection::SetStatusTcp(bool bEnable, bool _bStopTcp)
         return;
     bInCall = true;
     
+    // Disable - also disconnect, otherwise restart wouldn't work
+    // (before locking: unregistering waits for a running NetEventLoop handler)
+    if (!bEnable && _bStopTcp)
+        StopTcpConnection();
+    
     // consistent status decision
     std::lock_guard<std::recursive_mutex> lock(rtMutex);
 
@@ -140,10 +140,6 @@ void RealTrafficConnection::SetStatusTcp(bool bEnable, bool _bStopTcp)
             // no change
             break;
     } else {
-        // Disable - also disconnect, otherwise restart wouldn't work
-        if (_bStopTcp)
-            StopTcpConnection();
-        
         // set status
         switch (status) {
         case RT_STATUS_NONE:
@@ -176,6 +172,11 @@ void RealTrafficConnection::SetStatusUdp(bool bEnable, bool _bStopUdp)
         return;
     bInCall = true;
     
+    // Disable - also disconnect, otherwise restart wouldn't work
+    // (before locking: unregistering waits for a running NetEventLoop handler)
+    if (!bEnable && _bStopUdp)
+        StopUdpConnection();
+    
     // consistent status decision
     std::lock_guard<std::recursive_mutex> lock(rtMutex);
     
@@ -193,10 +194,6 @@ void RealTrafficConnection::SetStatusUdp(bool bEnable, bool _bStopUdp)
             // no change
             break;
     } else {
-        // Disable - also disconnect, otherwise restart wouldn't work
-        if (_bStopUdp)
-            StopUdpConnection();
-        
         // reset weather
         InitWeather();
         
@@ -254,7 +251,7 @@ void RealTrafficConnection::SetValid (bool _valid, bool bMsg)
     LTOnlineChannel::SetValid(_valid, bMsg);
 }
 
-// starts all networking threads
+// opens all sockets and registers them with NetEventLoop
 bool RealTrafficConnection::StartConnections()
 {
     // don't start if we shall stop
@@ -266,33 +263,25 @@ bool RealTrafficConnection::StartConnections()
         SetStatus(RT_STATUS_STARTING);
     
     // *** TCP server for RealTraffic to connect to ***
-    if (!thrTcpRunning && !tcpPosSender.IsConnected()) {
-        if (thrTcpServer.joinable())
-            thrTcpServer.join();
-        thrTcpRunning = true;
-        thrTcpServer = std::thread (tcpConnectionS, this);
-    }
+    if (!tcpPosSender.isOpen() && !tcpPosSender.IsConnected())
+        StartTcpConnection();
     
     // *** UDP data listener ***
-    if (!thrUdpRunning) {
-        if (thrUdpListener.joinable())
-            thrUdpListener.join();
-        thrUdpRunning = true;
-        thrUdpListener = std::thread (udpListenS, this);
-    }
+    if (!udpTrafficData.isOpen())
+        StartUdpConnection();
     
     // looks ok
     return true;
 }
 
-// stop the UDP listening thread
+// closes all sockets
 bool RealTrafficConnection::StopConnections()
 {
     // not running?
     if (status == RT_STATUS_NONE)
         return true;
     
-    // tell the threads to stop now
+    // tell the handlers to stop now
     SetStatus(RT_STATUS_STOPPING);
 
     // stop both TCP and UDP
@@ -310,35 +299,21 @@ bool RealTrafficConnection::StopConnections()
 // MARK: TCP Connection
 //
 
-void RealTrafficConnection::tcpConnection ()
+// opens the listener, NetEventLoop calls OnTcpAccept when RealTraffic connects
+void RealTrafficConnection::StartTcpConnection ()
 {
     // sanity check: return in case of wrong status
-    if (!IsConnecting()) {
-        thrTcpRunning = false;
+    if (!IsConnecting())
         return;
-    }
     
     // port to use is configurable
     int tcpPort = DataRefs::GetCfgInt(DR_CFG_RT_LISTEN_PORT);
     
     try {
-        bStopTcp = false;
         tcpPosSender.Open (RT_LOCALHOST, tcpPort, RT_NET_BUF_SIZE);
-        if (tcpPosSender.listenAccept()) {
-            // so we did accept a connection!
-            SetStatusTcp(true, false);
-            // send our first position
-            SendUsersPlanePos();
-        }
-        else
-        {
-            // short-cut if we are to shut down (return from 'select' due to closed socket)
-            if (!bStopTcp) {
-                // not forced to shut down...report other problem
-                SHOW_MSG(logERR,ERR_RT_CANTLISTEN);
-                SetStatusTcp(false, true);
-            }
-        }
+        tcpPosSender.listen();
+        NetEventLoop::Get().AddSocket(tcpPosSender.getSocket(),
+                                      [this]{ OnTcpAccept(); });
     }
     catch (std::runtime_error& e) {
         LOG_MSG(logERR, ERR_TCP_LISTENACCEPT, ChName(),
@@ -348,30 +323,34 @@ void RealTrafficConnection::tcpConnection ()
         SetStatusTcp(false, true);
         SetValid(false, true);
     }
-    
-    // We make sure that, once leaving this thread, there is no
-    // open listener (there might be a connected socket, though)
-#if IBM
-    if (!bStopTcp)                  // already closed if stop flag set, avoid rare crashes if called in parallel
-#endif
-        tcpPosSender.CloseListenerOnly();
-    thrTcpRunning = false;
+}
+
+// called by NetEventLoop when a connection is waiting on the listener
+void RealTrafficConnection::OnTcpAccept ()
+{
+    // We only accept exactly one connection, so we are no longer
+    // interested in the listener, which `accept` closes
+    NetEventLoop::Get().RemoveSocket(tcpPosSender.getSocket());
+    if (tcpPosSender.accept(true)) {
+        // so we did accept a connection!
+        SetStatusTcp(true, false);
+        // send our first position
+        SendUsersPlanePos();
+    }
+    else
+    {
+        // report problem
+        SHOW_MSG(logERR,ERR_RT_CANTLISTEN);
+        SetStatusTcp(false, true);
+    }
 }
 
 bool RealTrafficConnection::StopTcpConnection ()
 {
-    // close all connections, this will also break out of all
-    // blocking calls for receiving message and hence terminate the threads
-    bStopTcp = true;
+    // unregister first (waits for a running handler), then close all connections
+    if (tcpPosSender.isOpen())
+        NetEventLoop::Get().RemoveSocket(tcpPosSender.getSocket());
     tcpPosSender.Close();
-    
-    // wait for threads to finish (if I'm not myself this thread...)
-    if (std::this_thread::get_id() != thrTcpServer.get_id()) {
-        if (thrTcpServer.joinable())
-            thrTcpServer.join();
-        thrTcpServer = std::thread();
-    }
-    
     return true;
 }
 
@@ -421,114 +400,30 @@ void RealTrafficConnection::SendUsersPlanePos()
 
 
 //
-// MARK: UDP Listen Thread - Traffic
+// MARK: UDP Listener - Traffic
 //
 
-// runs in a separate thread, listens for UDP traffic and
-// forwards that to the flight data
-void RealTrafficConnection::udpListen ()
+// opens the UDP sockets, NetEventLoop calls OnUdpData when datagrams arrive
+void RealTrafficConnection::StartUdpConnection ()
 {
     // sanity check: return in case of wrong status
-    if (!IsConnecting()) {
-        thrUdpRunning = false;
+    if (!IsConnecting())
         return;
-    }
     
     int port = 0;
     try {
-        // Open the UDP port
-        bStopUdp = false;
+        // Open the UDP ports
         udpTrafficData.Open (RT_LOCALHOST,
                              port = DataRefs::GetCfgInt(DR_CFG_RT_TRAFFIC_PORT),
                              RT_NET_BUF_SIZE);
         udpWeatherData.Open (RT_LOCALHOST,
                              port = DataRefs::GetCfgInt(DR_CFG_RT_WEATHER_PORT),
                              RT_NET_BUF_SIZE);
-        int maxSock = std::max((int)udpTrafficData.getSocket(),
-                               (int)udpWeatherData.getSocket()) + 1;
-#if APL == 1 || LIN == 1
-        // the self-pipe to shut down the UDP socket gracefully
-        if (pipe(udpPipe) < 0)
-            throw NetRuntimeError("Couldn't create pipe");
-        fcntl(udpPipe[0], F_SETFL, O_NONBLOCK);
-        maxSock = std::max(maxSock, udpPipe[0]+1);
-#endif
-
-        // return from the thread when requested
-        // (not checking for weather socker...not essential)
-        while (udpTrafficData.isOpen() && IsConnecting() && !bStopUdp)
-        {
-            // wait for a UDP datagram on either socket (traffic, weather)
-            fd_set sRead;
-            FD_ZERO(&sRead);
-            FD_SET(udpTrafficData.getSocket(), &sRead);     // check our sockets
-            FD_SET(udpWeatherData.getSocket(), &sRead);
-#if APL == 1 || LIN == 1
-            FD_SET(udpPipe[0], &sRead);
-#endif
-            int retval = select(maxSock, &sRead, NULL, NULL, NULL);
-            
-            // short-cut if we are to shut down (return from 'select' due to closed socket)
-            if (bStopUdp)
-                break;
-
-            // select call failed???
-            if(retval == -1)
-                throw NetRuntimeError("'select' failed");
-
-            // select successful - traffic data
-            if (retval > 0 && FD_ISSET(udpTrafficData.getSocket(), &sRead))
-            {
-                // read UDP datagram
-                long rcvdBytes = udpTrafficData.recv();
-                
-                // received something?
-                if (rcvdBytes > 0)
-                {
-                    // yea, we received something!
-                    SetStatusUdp(true, false);
-
-                    // have it processed
-                    ProcessRecvedTrafficData(udpTrafficData.getBuf());
-                }
-                else
-                    retval = -1;
-            }
-            
-            // select successful - weather data
-            if (retval > 0 && FD_ISSET(udpWeatherData.getSocket(), &sRead))
-            {
-                // read UDP datagram
-                long rcvdBytes = udpWeatherData.recv();
-                
-                // received something?
-                if (rcvdBytes > 0)
-                {
-                    // have it processed
-                    ProcessRecvedWeatherData(udpWeatherData.getBuf());
-                }
-                else
-                    retval = -1;
-            }
-            
-            // short-cut if we are to shut down
-            if (bStopUdp)
-                break;
-            
-            // handling of errors, both from select and from recv
-            if (retval < 0 && (errno != EAGAIN && errno != EWOULDBLOCK)) {
-                // not just a normal timeout?
-                char sErr[SERR_LEN];
-                strerror_s(sErr, sizeof(sErr), errno);
-                LOG_MSG(logERR, ERR_UDP_RCVR_RCVR, ChName(),
-                        sErr);
-                // increase error count...bail out if too bad
-                if (!IncErrCnt()) {
-                    SetStatusUdp(false, true);
-                    break;
-                }
-            }
-        }
+        NetEventLoop& loop = NetEventLoop::Get();
+        loop.AddSocket(udpTrafficData.getSocket(),
+                       [this]{ OnUdpData(udpTrafficData, true); });
+        loop.AddSocket(udpWeatherData.getSocket(),
+                       [this]{ OnUdpData(udpWeatherData, false); });
     }
     catch (std::runtime_error& e) {
         // exception...can only really happen in UDPReceiver::Open
@@ -539,51 +434,55 @@ void RealTrafficConnection::udpListen ()
         SetStatusUdp(false, true);
         SetValid(false, true);
     }
+}
+
+// called by NetEventLoop when a datagram is available,
+// forwards traffic to the flight data
+void RealTrafficConnection::OnUdpData (UDPReceiver& udp, bool bTraffic)
+{
+    // ignore anything while stopping
+    if (!IsConnecting())
+        return;
     
-    // Let's make absolutely sure that any connection is really closed
-    // once we return from this thread
-#if APL == 1 || LIN == 1
-    udpTrafficData.Close();
-    udpWeatherData.Close();
-    // close the self-pipe sockets
-    for (SOCKET &s: udpPipe) {
-        if (s != INVALID_SOCKET) close(s);
-        s = INVALID_SOCKET;
+    // read UDP datagram, doesn't wait if there is nothing after all
+    long rcvdBytes = udp.timedRecv(0);
+    
+    // received something?
+    if (rcvdBytes > 0)
+    {
+        if (bTraffic) {
+            // yea, we received something!
+            netRcvTs = NetNow();
+            SetStatusUdp(true, false);
+            // have it processed
+            ProcessRecvedTrafficData(udp.getBuf());
+        }
+        else
+            ProcessRecvedWeatherData(udp.getBuf());
     }
-#else
-    if (!bStopUdp) {                // already closed if stop flag set, avoid rare crashes if called in parallel
-        udpTrafficData.Close();
-        udpWeatherData.Close();
+    // handling of errors
+    else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        // not just a normal timeout?
+        char sErr[SERR_LEN];
+        strerror_s(sErr, sizeof(sErr), errno);
+        LOG_MSG(logERR, ERR_UDP_RCVR_RCVR, ChName(),
+                sErr);
+        // increase error count...bail out if too bad
+        if (!IncErrCnt())
+            SetStatusUdp(false, true);
     }
-#endif
-    thrUdpRunning = false;
 }
 
 bool RealTrafficConnection::StopUdpConnection ()
 {
-    bStopUdp = true;
-#if APL == 1 || LIN == 1
-    // Mac/Lin: Try writing something to the self-pipe to stop gracefully
-    if (udpPipe[1] == INVALID_SOCKET ||
-        write(udpPipe[1], "STOP", 4) < 0)
-    {
-        // if the self-pipe didn't work:
-#endif
-        // close all connections, this will also break out of all
-        // blocking calls for receiving message and hence terminate the threads
-        udpTrafficData.Close();
-        udpWeatherData.Close();
-#if APL == 1 || LIN == 1
-    }
-#endif
-
-    // wait for thread to finish if I'm not this thread myself
-    if (std::this_thread::get_id() != thrUdpListener.get_id()) {
-        if (thrUdpListener.joinable())
-            thrUdpListener.join();
-        thrUdpListener = std::thread();
-    }
-    
+    // unregister first (waits for a running handler), then close
+    NetEventLoop& loop = NetEventLoop::Get();
+    if (udpTrafficData.isOpen())
+        loop.RemoveSocket(udpTrafficData.getSocket());
+    if (udpWeatherData.isOpen())
+        loop.RemoveSocket(udpWeatherData.getSocket());
+    udpTrafficData.Close();
+    udpWeatherData.Close();
     return true;
 }
 
@@ -652,12 +551,8 @@ bool RealTrafficConnection::ProcessRecvedTrafficData (const char* traffic)
      tfc.size() >= RT_TFC_TIMESTAMP+1) ?
     // use that delivered timestamp
     std::stod(tfc[RT_TFC_TIMESTAMP]) :
-    // system time in microseconds
-    double(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count())
-    // divided by 1000000 to create seconds with fractionals
-    / 1000000.0
-    // corrected by network time diff (which only works if also OpenSky or ADSBEx are active)
-    + dataRefs.GetChTsOffset();
+    // system time, corrected by network time diff
+    NetNow();
     
     // check for duplicate data
     // RealTraffic sends bursts of data every 10s, but that doesn't necessarily
@@ -684,6 +579,7 @@ bool RealTrafficConnection::ProcessRecvedTrafficData (const char* traffic)
                     std::stod(tfc[RT_TFC_LON]),
                     0,              // we take care of altitude later
                     posTime);
+    SetRcvTs(pos);
     
     // position is rather important, we check for validity
     // (we do allow alt=NAN if on ground)
@@ -693,9 +589,35 @@ bool RealTrafficConnection::ProcessRecvedTrafficData (const char* traffic)
     }
     
     // is position close enough to current pos?
-    if (posCamera.dist(pos) > dataRefs.GetFdStdDistance_m())
+    if (posCamera.dist(pos) > dataRefs.GetFdQueryDistance_m())
         return true;                // ignore silently, no error
     
+    // outside the standard distance only track latest position and velocity
+    if (LTRegionalIsOuter(posCamera, pos.lat(), pos.lon())) {
+        LTFlightData::FDStaticData stat;
+        stat.acTypeIcao     = tfc[RT_TFC_TYPE];
+        stat.call           = tfc[RT_TFC_CS];
+        
+        LTFlightData::FDDynamicData dyn;
+        dyn.gnd =               tfc[RT_TFC_AIRBORNE] == "0" || tfc[RT_TFC_ALT] == "0";
+        dyn.heading =           std::stoi(tfc[RT_TFC_HDG]);
+        dyn.spd =               std::stoi(tfc[RT_TFC_SPD]);
+        dyn.vsi =               std::stoi(tfc[RT_TFC_VS]);
+        dyn.ts =                posTime;
+        dyn.pChannel =          this;
+        if (dyn.gnd)
+            pos.alt_m() = NAN;
+        else
+            pos.SetAltFt(std::stod(tfc[RT_TFC_ALT]) + (hPa - HPA_STANDARD) * FT_per_HPA);
+        
+        LTRegionalUpdate(fdKey, stat, &dyn, pos);
+        return true;
+    }
+    
+    // inside: promote from the regional ring
+    if (LTRegionalIsActive())
+        LTRegionalPromote(fdKey);
+    
     try {
         // from here on access to fdMap guarded by a mutex
         // until FD object is inserted and updated
@@ -791,6 +713,7 @@ bool RealTrafficConnection::IsDatagramDuplicate (unsigned long numId,
     if (it == mapDatagrams.end()) {
         // add the datagram the first time for this plane
         mapDatagrams.emplace(numId, RTUDPDatagramTy(posTime,datagram));
+        wheelDatagrams.Schedule(numId, posTime + dataRefs.GetAcOutdatedIntvl());
         // no duplicate
         return false;
     }
@@ -817,13 +740,22 @@ void RealTrafficConnection::CleanupMapDatagrams()
     // cut-off time is current sim time minus outdated interval,
     // or in other words: Remove all data that had no updates for
     // the outdated period, planes will vanish soon anyway
-    const double cutOff = dataRefs.GetSimTime() - dataRefs.GetAcOutdatedIntvl();
-    
-    for (auto it = mapDatagrams.begin(); it != mapDatagrams.end(); ) {
+    // Only entries due according to the timing wheel are looked at.
+    // Entries, which got updated meanwhile, are rescheduled.
+    const double simTime = dataRefs.GetSimTime();
+    const double cutOff = simTime - dataRefs.GetAcOutdatedIntvl();
+    
+    static std::vector<unsigned long> vecDue;
+    vecDue.clear();
+    wheelDatagrams.PopDue(simTime, vecDue);
+    for (unsigned long numId: vecDue) {
+        auto it = mapDatagrams.find(numId);
+        if (it == mapDatagrams.end())
+            continue;
         if (it->second.posTime < cutOff)
-            it = mapDatagrams.erase(it);
+            mapDatagrams.erase(it);
         else
-            ++it;            
+            wheelDatagrams.Schedule(numId, it->second.posTime + dataRefs.GetAcOutdatedIntvl());
     }
 }
 
@@ -0,0 +1,249 @@
+/// @file       LTRegional.cpp
+/// @brief      Lightweight tracking of aircraft in the outer regional ring
+/// @details    Keeps just the latest position and velocity per aircraft
+///             between standard search distance and regional distance.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+//
+// MARK: Globals
+//
+
+// all aircraft tracked in the outer regional ring
+mapLTRegionalAcTy mapRegional;
+// guards access to mapRegional, lower-level lock than mapFdMutex
+std::mutex mapRegionalMutex;
+
+//
+// MARK: Routing
+//
+
+// Is regional distance beyond standard distance?
+bool LTRegionalIsActive ()
+{
+    return dataRefs.GetFdRegionalDistance_nm() > dataRefs.GetFdStdDistance_nm();
+}
+
+// Distance beyond which a fully tracked aircraft is demoted
+double LTRegionalDemoteDist_m ()
+{
+    const double stdDist = double(dataRefs.GetFdStdDistance_m());
+    return LTRegionalIsActive() ? stdDist * (1.0 + FD_REGIONAL_DEMOTE_MARGIN) : stdDist;
+}
+
+// Is the position outside the standard distance, so only to be tracked regionally?
+bool LTRegionalIsOuter (const positionTy& viewPos, double lat, double lon, bool bFull)
+{
+    if (!LTRegionalIsActive() ||
+        std::isnan(lat) || std::isnan(lon))
+        return false;
+    const double dist = bFull ? LTRegionalDemoteDist_m() : double(dataRefs.GetFdStdDistance_m());
+    return DistLatLonSqr(lat, lon, viewPos.lat(), viewPos.lon()) > dist * dist;
+}
+
+//
+// MARK: Updates
+//
+
+// Stores the latest data of a regional aircraft
+bool LTRegionalUpdate (const LTFlightData::FDKeyTy& key,
+                       const LTFlightData::FDStaticData& stat,
+                       const LTFlightData::FDDynamicData* dyn,
+                       const positionTy& pos)
+{
+    try {
+        std::lock_guard<std::mutex> lock (mapRegionalMutex);
+
+        mapLTRegionalAcTy::iterator iter = mapRegional.find(key);
+        if (iter == mapRegional.end()) {
+            // static data alone doesn't justify tracking an aircraft
+            if (!dyn)
+                return false;
+            iter = mapRegional.emplace(key, LTRegionalAcTy()).first;
+        }
+        LTRegionalAcTy& ac = iter->second;
+
+        // keep what we need of static data
+        if (!stat.call.empty())
+            ac.call = stat.call;
+        if (!stat.acTypeIcao.empty())
+            ac.acTypeIcao = stat.acTypeIcao;
+
+        // latest position and velocity, but don't go back in time
+        if (dyn && !(dyn->ts < ac.ts)) {
+            ac.lat      = pos.lat();
+            ac.lon      = pos.lon();
+            ac.alt_m    = pos.alt_m();
+            ac.heading  = dyn->heading;
+            ac.spd      = dyn->spd;
+            ac.vsi      = dyn->vsi;
+            ac.ts       = dyn->ts;
+            ac.gnd      = dyn->gnd;
+            ac.pChannel = dyn->pChannel;
+        }
+        return true;
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapRegional", e.what());
+    }
+    return false;
+}
+
+// Removes an aircraft as it is promoted to full tracking
+void LTRegionalPromote (const LTFlightData::FDKeyTy& key)
+{
+    try {
+        std::lock_guard<std::mutex> lock (mapRegionalMutex);
+        if (mapRegional.erase(key) > 0)
+            LOG_MSG(logDEBUG, DBG_REGIONAL_PROMOTE, key.c_str());
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapRegional", e.what());
+    }
+}
+
+//
+// MARK: Maintenance
+//
+
+// Removes outdated regional aircraft and those outside the regional distance
+void LTRegionalMaintenance ()
+{
+    // regional mode switched off? Then nothing is kept
+    if (!LTRegionalIsActive()) {
+        LTRegionalClear();
+        return;
+    }
+
+    const positionTy viewPos = dataRefs.GetViewPos();
+    const double maxDist = double(dataRefs.GetFdRegionalDistance_m());
+    const double tsMin = dataRefs.GetSimTime() - dataRefs.GetAcOutdatedIntvl();
+    try {
+        std::lock_guard<std::mutex> lock (mapRegionalMutex);
+        for (mapLTRegionalAcTy::iterator iter = mapRegional.begin();
+             iter != mapRegional.end();)
+        {
+            const LTRegionalAcTy& ac = iter->second;
+            if (ac.ts < tsMin ||
+                DistLatLonSqr(ac.lat, ac.lon, viewPos.lat(), viewPos.lon()) > maxDist * maxDist)
+                iter = mapRegional.erase(iter);
+            else
+                ++iter;
+        }
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapRegional", e.what());
+    }
+}
+
+// Removes all regional aircraft
+void LTRegionalClear ()
+{
+    try {
+        std::lock_guard<std::mutex> lock (mapRegionalMutex);
+        mapRegional.clear();
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapRegional", e.what());
+    }
+}
+
+// Number of regional aircraft
+int LTRegionalCount ()
+{
+    try {
+        std::lock_guard<std::mutex> lock (mapRegionalMutex);
+        return int(mapRegional.size());
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapRegional", e.what());
+    }
+    return 0;
+}
+
+//
+// MARK: LTAPI
+//
+
+// Copies regional aircraft into LTAPI's bulk structure
+int LTRegionalCopyBulkData (char* pOut, int startIdx, int num, size_t size)
+{
+    // If size isn't enough for original structure we bail:
+    if (size < LTAPIBulkData_v120 || startIdx < 0)
+        return 0;
+
+    const positionTy viewPos = dataRefs.GetViewPos();
+    int cnt = 0;
+    try {
+        std::lock_guard<std::mutex> lock (mapRegionalMutex);
+
+        // skip to the first requested aircraft
+        if (size_t(startIdx) >= mapRegional.size())
+            return 0;
+        mapLTRegionalAcTy::const_iterator iter = std::next(mapRegional.cbegin(), startIdx);
+
+        for (; iter != mapRegional.cend() && cnt < num;
+             ++iter, ++cnt, pOut += size)
+        {
+            const LTRegionalAcTy& ac = iter->second;
+            const positionTy pos (ac.lat, ac.lon, ac.alt_m);
+            const vectorTy vecView = viewPos.between(pos);
+
+            LTAPIAircraft::LTAPIBulkData* pBulk = (LTAPIAircraft::LTAPIBulkData*)pOut;
+            // identification
+            pBulk->keyNum = iter->first.num;
+            // position, only what we know
+            pBulk->lat_f = (float)ac.lat;
+            pBulk->lon_f = (float)ac.lon;
+            pBulk->alt_ft_f = (float)pos.alt_ft();
+            pBulk->heading = (float)ac.heading;
+            pBulk->track = (float)ac.heading;
+            pBulk->roll = 0.0f;
+            pBulk->pitch = 0.0f;
+            pBulk->speed_kt = (float)ac.spd;
+            pBulk->vsi_ft = (float)ac.vsi;
+            pBulk->terrainAlt_ft = 0.0f;
+            pBulk->height_ft = 0.0f;
+            // configuration: unknown
+            pBulk->flaps = 0.0f;
+            pBulk->gear = 0.0f;
+            pBulk->reversers = 0.0f;
+            // simulation
+            pBulk->bearing = (float)vecView.angle;
+            pBulk->dist_nm = (float)vecView.dist / M_per_NM;
+            pBulk->bits.phase = LTAPIAircraft::FPH_UNKNOWN;
+            pBulk->bits.onGnd = ac.gnd;
+            pBulk->bits.taxi = false;
+            pBulk->bits.land = false;
+            pBulk->bits.bcn  = false;
+            pBulk->bits.strb = false;
+            pBulk->bits.nav  = false;
+            pBulk->bits.filler1 = 0;
+            pBulk->bits.multiIdx = 0;
+            pBulk->bits.filler2 = 0;
+            pBulk->bits.filler3 = 0;
+
+            // v1.22 additions
+            if (size >= LTAPIBulkData_v122) {
+                pBulk->lat = ac.lat;
+                pBulk->lon = ac.lon;
+                pBulk->alt_ft = pos.alt_ft();
+            }
+        }
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapRegional", e.what());
+    }
+    return cnt;
+}
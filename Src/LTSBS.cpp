@@ -0,0 +1,460 @@
+/// @file       LTSBS.cpp
+/// @brief      SBS: Receives live tracking data from a local ADS-B receiver in SBS-1/BaseStation format
+/// @see        http://woodair.net/sbs/article/barebones42_socket_data.htm
+/// @details    Implements RcvrConnection, the base for channels connected to a local receiver, and SBSConnection:\n
+///             - Keeps a TCP connection to a receiver like dump1090 (default port 30003)\n
+///             - Scans the received SBS lines in place, without copying them\n
+///             - Aggregates identity, velocity, and position messages per aircraft\n
+///             - Passes complete updates on to LTFlightData.\n
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+//
+// MARK: Field conversion
+//
+
+/// Converts a field to double without allocating memory, returns NAN if empty or not a number
+static double sbsToDouble (std::string_view f)
+{
+    char s[32];
+    if (f.empty() || f.size() >= sizeof(s))
+        return NAN;
+    memcpy(s, f.data(), f.size());
+    s[f.size()] = 0;
+    char* pEnd = nullptr;
+    const double d = strtod(s, &pEnd);
+    return pEnd == s ? NAN : d;
+}
+
+/// Converts a field to unsigned long in the given base, returns 0 if empty or not a number
+static unsigned long sbsToULong (std::string_view f, int base)
+{
+    char s[32];
+    if (f.empty() || f.size() >= sizeof(s))
+        return 0;
+    memcpy(s, f.data(), f.size());
+    s[f.size()] = 0;
+    return strtoul(s, nullptr, base);
+}
+
+//
+// MARK: Receiver Connection
+//
+
+// Constructor doesn't do much
+RcvrConnection::RcvrConnection (mapLTFlightDataTy& _fdMap) :
+LTOnlineChannel(),
+LTFlightDataChannel(),
+fdMap(_fdMap)
+{}
+
+// Destructor makes sure we are cleaned up
+RcvrConnection::~RcvrConnection ()
+{
+    StopConnection();
+}
+
+// Does not actually fetch data (NetEventLoop handlers do that) but
+// 1. Starts the connection
+// 2. stores the camera position for the handlers to filter data
+bool RcvrConnection::FetchAllData (const positionTy& pos)
+{
+    // if we are invalid or disabled we should shut down
+    if (!IsValid() || !IsEnabled()) {
+        return StopConnection();
+    }
+
+    // store camera position for the handlers
+    {
+        std::lock_guard<std::mutex> lock(posMutex);
+        posCamera = pos;
+    }
+
+    // make sure we have a timer
+    return StartConnection();
+}
+
+// if channel is disabled make sure all connections are closed
+void RcvrConnection::DoDisabledProcessing ()
+{
+    StopConnection();
+}
+
+// closes all connections
+void RcvrConnection::Close ()
+{
+    StopConnection();
+}
+
+// Registers the timer, which connects to the receiver
+bool RcvrConnection::StartConnection ()
+{
+    if (!timerId) {
+        nextConnect = NetEventLoop::timePointTy();
+        timerId = NetEventLoop::Get().AddTimer(LTClock::now(),
+                                               [this]{ return OnTimer(); });
+    }
+    return true;
+}
+
+// Unregisters everything and closes the connection
+bool RcvrConnection::StopConnection ()
+{
+    try {
+        // make sure no handler runs while we clean up
+        std::lock_guard<std::recursive_mutex> lock (NetEventLoop::Get().GetMutex());
+        if (timerId) {
+            NetEventLoop::Get().RemoveTimer(timerId);
+            timerId = 0;
+        }
+        CloseRcvr();
+        mapAcState.clear();
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "loopMutex", e.what());
+    }
+    return true;
+}
+
+//
+// MARK: NetEventLoop Handlers
+//
+
+// Timer handler: (re)connects if needed, commits updates regularly
+NetEventLoop::timePointTy RcvrConnection::OnTimer ()
+{
+    const NetEventLoop::timePointTy tpNow = LTClock::now();
+    
+    // too many errors: stop the timer, FetchAllData will stop the rest
+    if (!IsValid()) {
+        CloseRcvr();
+        return NetEventLoop::timePointTy();
+    }
+    
+    if (!tcpRcvr.isOpen()) {
+        // *** (re)connect ***
+        if (tpNow >= nextConnect)
+            Connect();
+    }
+    else if (bConnecting) {
+        // *** still connecting? ***
+        if (tpNow >= connectDeadline) {
+            LOG_MSG(logERR, ERR_RCVR_CONNECT_TIMEOUT, ChName(), host.c_str(), port);
+            CloseRcvr();
+            IncErrCnt();
+            nextConnect = tpNow + RCVR_RECONNECT_WAIT;
+        }
+    }
+    else {
+        // *** commit ***
+        CommitAndCleanup(NetNow());
+    }
+    
+    return tpNow + RCVR_COMMIT_INTVL;
+}
+
+// Starts connecting to the receiver
+void RcvrConnection::Connect ()
+{
+    host = GetHost();
+    port = GetPort();
+    
+    // initial filter data used while processing
+    RefreshFilter();
+    
+    try {
+        if (tcpRcvr.ConnectStart(host, port))
+            OnConnected();
+        else {
+            // wait for the socket to become writable
+            bConnecting = true;
+            connectDeadline = LTClock::now() + RCVR_CONNECT_TIMEOUT;
+            NetEventLoop::Get().AddSocket(tcpRcvr.getSocket(),
+                                          [this]{ OnConnectDone(); }, true);
+        }
+    }
+    catch (NetRuntimeError& e) {
+        OnConnectFailed(e);
+    }
+}
+
+// Socket handler while connecting: finishes the connection
+void RcvrConnection::OnConnectDone ()
+{
+    bConnecting = false;
+    NetEventLoop::Get().RemoveSocket(tcpRcvr.getSocket());
+    try {
+        tcpRcvr.ConnectComplete();
+        OnConnected();
+    }
+    catch (NetRuntimeError& e) {
+        OnConnectFailed(e);
+    }
+}
+
+// Connection established: log and register for receiving
+void RcvrConnection::OnConnected ()
+{
+    LOG_MSG(logINFO, MSG_RCVR_CONNECTED, ChName(), host.c_str(), port);
+    rcvLen = 0;
+    NetEventLoop::Get().AddSocket(tcpRcvr.getSocket(),
+                                  [this]{ OnReceive(); });
+}
+
+// Connection failed: log, count error, and wait before reconnecting
+void RcvrConnection::OnConnectFailed (const NetRuntimeError& e)
+{
+    LOG_MSG(logERR, ERR_RCVR_CONNECT, ChName(), host.c_str(), port,
+            e.what(), e.errTxt.c_str());
+    // too many errors invalidate the channel
+    IncErrCnt();
+    nextConnect = LTClock::now() + RCVR_RECONNECT_WAIT;
+}
+
+// Socket handler while connected: receives and processes data
+void RcvrConnection::OnReceive ()
+{
+    // doesn't wait if there is nothing after all
+    const long n = tcpRcvr.timedRecvInto(rcvBuf + rcvLen,
+                                         sizeof(rcvBuf) - rcvLen,
+                                         0);
+    if (n < 0) {
+        // error or connection closed by receiver
+        LOG_MSG(logWARN, MSG_RCVR_DISCONNECTED, ChName(), host.c_str(), port);
+        CloseRcvr();
+        nextConnect = LTClock::now() + RCVR_RECONNECT_WAIT;
+    }
+    else if (n > 0) {
+        // process all complete lines/frames
+        rcvLen += size_t(n);
+        netRcvTs = NetNow();
+        ProcessRcvBuf(netRcvTs);
+    }
+}
+
+// Unregisters and closes the socket, commits what we collected
+void RcvrConnection::CloseRcvr ()
+{
+    if (tcpRcvr.isOpen()) {
+        NetEventLoop::Get().RemoveSocket(tcpRcvr.getSocket());
+        tcpRcvr.Close();
+    }
+    bConnecting = false;
+    
+    // don't lose what we collected before the connection broke
+    CommitUpdates(fdMap, vecUpd, viewPos);
+    vecUpd.clear();
+}
+
+// Adds an update for the given aircraft to vecUpd
+void RcvrConnection::AddUpdate (unsigned long numId, AcStateTy& ac,
+                               double lat, double lon, double now)
+{
+    // not too often, positions are merged later anyway
+    if (now < ac.lastPosTs + RCVR_MIN_POS_INTVL)
+        return;
+
+    // airborne positions need an altitude
+    const double alt_m = ac.gnd ? NAN : ac.alt_ft * M_per_FT;
+    if (!ac.gnd && std::isnan(alt_m))
+        return;
+
+    // still interested in this aircraft?
+    const LTFlightData::FDKeyTy fdKey (LTFlightData::KEY_ICAO, numId);
+    if (!IsRecordOfInterest(fdKey, acFilter, viewPos, lat, lon, alt_m))
+        return;
+
+    FDUpdateTy& upd = vecUpd.emplace_back();
+    upd.key = fdKey;
+
+    // static data
+    upd.stat.trt  = trt_ADS_B_unknown;
+    upd.stat.call = ac.call;
+
+    // dynamic data
+    LTFlightData::FDDynamicData& dyn = upd.dyn;
+    dyn.radar.code =    ac.squawk;
+    dyn.gnd =           ac.gnd;
+    dyn.heading =       ac.trk;
+    dyn.spd =           std::isnan(ac.spd) ? 0.0 : ac.spd;
+    dyn.vsi =           std::isnan(ac.vsi) ? 0.0 : ac.vsi;
+    dyn.ts =            now;
+    dyn.pChannel =      this;
+
+    // position
+    upd.pos = positionTy(lat, lon, alt_m, now, dyn.heading);
+    upd.pos.onGrnd = ac.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
+    SetRcvTs(upd.pos);
+
+    // position is rather important, we check for validity
+    upd.bPos = upd.pos.isNormal(true);
+    if (upd.bPos)
+        ac.lastPosTs = now;
+    else
+        LOG_MSG(logDEBUG,ERR_POS_UNNORMAL,upd.key.c_str(),upd.pos.dbgTxt().c_str());
+}
+
+// Commits collected updates, refreshes filter data, and removes outdated aggregation states
+void RcvrConnection::CommitAndCleanup (double now)
+{
+    // hand on complete updates
+    CommitUpdates(fdMap, vecUpd, viewPos);
+    vecUpd.clear();
+
+    // refresh the filter data used while processing
+    RefreshFilter();
+
+    // remove aircraft we haven't heard of for a while
+    for (mapAcStateTy::iterator it = mapAcState.begin(); it != mapAcState.end(); )
+    {
+        if (it->second.lastRcvd + RCVR_AC_OUTDATED < now)
+            it = mapAcState.erase(it);
+        else
+            ++it;
+    }
+}
+
+// Refreshes viewPos and acFilter
+void RcvrConnection::RefreshFilter ()
+{
+    {
+        std::lock_guard<std::mutex> lock(posMutex);
+        viewPos = posCamera;
+    }
+    acFilter = dataRefs.GetDebugAcFilter();
+}
+
+//
+// MARK: SBS Connection
+//
+
+SBSConnection::SBSConnection (mapLTFlightDataTy& _fdMap) :
+LTChannel(DR_CHANNEL_SBS_ONLINE),
+RcvrConnection(_fdMap)
+{}
+
+// Unregister before we are gone, handlers call our virtual functions
+SBSConnection::~SBSConnection ()
+{
+    StopConnection();
+}
+
+std::string SBSConnection::GetHost () const
+{
+    return dataRefs.GetSBSHost();
+}
+
+int SBSConnection::GetPort () const
+{
+    return DataRefs::GetCfgInt(DR_CFG_SBS_PORT);
+}
+
+// Processes all complete lines in the receive buffer, keeps an incomplete rest
+void SBSConnection::ProcessRcvBuf (double now)
+{
+    char* pLn = rcvBuf;
+    char* const pEnd = rcvBuf + rcvLen;
+    for (char* pNl = nullptr;
+         (pNl = (char*)memchr(pLn, '\n', size_t(pEnd - pLn))) != nullptr;
+         pLn = pNl + 1)
+    {
+        // remove trailing CR, zero-terminate in place for raw logging
+        char* pLnEnd = pNl;
+        if (pLnEnd > pLn && pLnEnd[-1] == '\r')
+            --pLnEnd;
+        *pLnEnd = '\0';
+        DebugLogRaw(pLn);
+        ProcessLine(std::string_view(pLn, size_t(pLnEnd - pLn)), now);
+    }
+
+    // move an incomplete rest to the front of the buffer
+    rcvLen = size_t(pEnd - pLn);
+    if (rcvLen >= sizeof(rcvBuf))       // buffer full without line end: discard the garbage
+        rcvLen = 0;
+    else if (rcvLen > 0 && pLn != rcvBuf)
+        memmove(rcvBuf, pLn, rcvLen);
+}
+
+// Processes one SBS line, adds an update to vecUpd when a position is complete
+// Example:
+//      MSG,3,1,1,4CA2D6,1,2020/05/01,12:34:56.789,2020/05/01,12:34:56.789,,36000,,,51.12345,-0.98765,,,0,0,0,0
+void SBSConnection::ProcessLine (std::string_view ln, double now)
+{
+    // split the line into fields, just referencing the buffer
+    std::string_view f[SBS_NUM_FIELDS];
+    size_t nFields = 0;
+    for (size_t start = 0; nFields < SBS_NUM_FIELDS; ++nFields) {
+        const size_t comma = ln.find(',', start);
+        f[nFields] = ln.substr(start, comma == std::string_view::npos ? std::string_view::npos : comma - start);
+        if (comma == std::string_view::npos) {
+            ++nFields;
+            break;
+        }
+        start = comma + 1;
+    }
+
+    // we are only interested in MSG lines
+    if (nFields <= SBS_HEX_IDENT || f[SBS_MSG_TYPE] != SBS_MSG ||
+        f[SBS_TRANSM_TYPE].size() != 1)
+        return;
+    const int transmType = f[SBS_TRANSM_TYPE][0] - '0';
+
+    // the aircraft's transponder code
+    const unsigned long numId = sbsToULong(f[SBS_HEX_IDENT], 16);
+    if (numId == 0 || numId > MAX_TRANSP_ICAO)
+        return;
+
+    // aggregation state of this aircraft
+    AcStateTy& ac = mapAcState[numId];
+    ac.lastRcvd = now;
+
+    // remember what is reported
+    double d = NAN;
+    if (nFields > SBS_CALLSIGN && !f[SBS_CALLSIGN].empty()) {
+        std::string_view call = f[SBS_CALLSIGN];
+        while (!call.empty() && call.back() == ' ')     // trim trailing spaces
+            call.remove_suffix(1);
+        if (call != ac.call)
+            ac.call = call;
+    }
+    if (nFields > SBS_ALT && !std::isnan(d = sbsToDouble(f[SBS_ALT])))
+        ac.alt_ft = d;
+    if (nFields > SBS_GND_SPEED && !std::isnan(d = sbsToDouble(f[SBS_GND_SPEED])))
+        ac.spd = d;
+    if (nFields > SBS_TRACK && !std::isnan(d = sbsToDouble(f[SBS_TRACK])))
+        ac.trk = d;
+    if (nFields > SBS_VERT_RATE && !std::isnan(d = sbsToDouble(f[SBS_VERT_RATE])))
+        ac.vsi = d;
+    if (nFields > SBS_SQUAWK && !f[SBS_SQUAWK].empty())
+        ac.squawk = long(sbsToULong(f[SBS_SQUAWK], 10));
+    if (nFields > SBS_ON_GROUND && !f[SBS_ON_GROUND].empty())
+        ac.gnd = f[SBS_ON_GROUND] != "0";
+
+    // only position messages lead to an update
+    if ((transmType == SBS_TT_SURFACE_POS || transmType == SBS_TT_AIRB_POS) &&
+        nFields > SBS_LON)
+    {
+        if (transmType == SBS_TT_SURFACE_POS)
+            ac.gnd = true;
+        const double lat = sbsToDouble(f[SBS_LAT]);
+        const double lon = sbsToDouble(f[SBS_LON]);
+        if (!std::isnan(lat) && !std::isnan(lon))
+            AddUpdate(numId, ac, lat, lon, now);
+    }
+}
@@ -0,0 +1,236 @@
+/// @file       LTTrajectory.cpp
+/// @brief      Debug: Records rendered trajectories and compares them with a golden recording
+/// @details    Output format, one line per aircraft and frame:\n
+///             `key;simTime;lat;lon;alt_m;heading;pitch;roll;onGnd;phase`\n
+///             A golden file is just a previous output file, renamed to
+///             LTTrajectory.golden.log.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+#include <fstream>
+#include <iomanip>
+
+//
+// MARK: Golden Trajectories
+//
+
+/// Recording state, only accessed from X-Plane's main thread
+struct TrjStateTy {
+    bool            bActive = false;    ///< recording?
+    std::ofstream   out;                ///< output file
+    mapTrjTy        mapGolden;          ///< golden trajectories, empty if there is no golden file
+    std::set<std::string> setKeys;      ///< all recorded aircraft
+    // statistics
+    unsigned long   nPos        = 0;    ///< recorded positions
+    TrjCmpTy        cmp;                ///< comparison with golden trajectories
+    double          simStart    = NAN;  ///< first recorded timestamp
+    double          simEnd      = NAN;  ///< last recorded timestamp
+    std::chrono::steady_clock::time_point wallStart;        ///< real time when recording started
+    std::chrono::steady_clock::duration   calcTime {0};     ///< real time spent calculating positions
+};
+
+static TrjStateTy trj;
+
+// Reads a trajectory file, returns number of positions read
+unsigned long LTTrajectoryRead (const std::string& sFileName, mapTrjTy& map)
+{
+    std::ifstream in (sFileName);
+    if (!in)
+        return 0;
+
+    unsigned long n = 0;
+    std::string ln;
+    while (std::getline(in, ln)) {
+        std::vector<std::string> tok = str_tokenize(ln, ";", false);
+        if (tok.size() < 8)
+            continue;
+        TrjPosTy p;
+        p.ts        = std::atof(tok[1].c_str());
+        p.lat       = std::atof(tok[2].c_str());
+        p.lon       = std::atof(tok[3].c_str());
+        p.alt       = std::atof(tok[4].c_str());
+        p.heading   = std::atof(tok[5].c_str());
+        p.pitch     = std::atof(tok[6].c_str());
+        p.roll      = std::atof(tok[7].c_str());
+        map[tok[0]].push_back(p);
+        n++;
+    }
+
+    // sort each trajectory by timestamp for binary search
+    for (mapTrjTy::value_type& t: map)
+        std::sort(t.second.begin(), t.second.end(),
+                  [](const TrjPosTy& a, const TrjPosTy& b){ return a.ts < b.ts; });
+    return n;
+}
+
+// Compares a position with the golden trajectory of the same aircraft
+void LTTrajectoryCompare (const mapTrjTy& golden, const std::string& key,
+                          const TrjPosTy& p, TrjCmpTy& cmp)
+{
+    // find the golden positions around p.ts
+    mapTrjTy::const_iterator iter = golden.find(key);
+    if (iter == golden.cend() || iter->second.empty() ||
+        p.ts < iter->second.front().ts - TRJ_TOL_TS ||
+        p.ts > iter->second.back().ts  + TRJ_TOL_TS)
+    {
+        cmp.nUncovered++;
+        return;
+    }
+    const std::vector<TrjPosTy>& vec = iter->second;
+    std::vector<TrjPosTy>::const_iterator i1 =
+    std::lower_bound(vec.cbegin(), vec.cend(), p.ts,
+                     [](const TrjPosTy& a, double ts){ return a.ts < ts; });
+    if (i1 == vec.cend())
+        --i1;
+    std::vector<TrjPosTy>::const_iterator i0 = (i1 == vec.cbegin()) ? i1 : std::prev(i1);
+
+    // interpolate the golden position at p.ts
+    TrjPosTy g = *i1;
+    const double d = i1->ts - i0->ts;
+    if (d > 0.0 && p.ts < i1->ts) {
+        const double f = std::max(0.0, (p.ts - i0->ts) / d);
+        g.lat       = i0->lat + f * (i1->lat - i0->lat);
+        g.lon       = i0->lon + f * (i1->lon - i0->lon);
+        g.alt       = i0->alt + f * (i1->alt - i0->alt);
+        g.heading   = HeadingAvg(i0->heading, i1->heading, 1.0-f, f);
+        g.pitch     = i0->pitch + f * (i1->pitch - i0->pitch);
+        g.roll      = i0->roll  + f * (i1->roll  - i0->roll);
+    }
+
+    // deviations
+    const double distH = DistLatLon(p.lat, p.lon, g.lat, g.lon);
+    const double distV = std::abs(p.alt - g.alt);
+    const double angle = std::max({std::abs(HeadingDiff(g.heading, p.heading)),
+                                   std::abs(p.pitch - g.pitch),
+                                   std::abs(p.roll  - g.roll)});
+    cmp.nCompared++;
+    if (distH > TRJ_TOL_DIST_H || distV > TRJ_TOL_DIST_V || angle > TRJ_TOL_ANGLE)
+        cmp.nDeviating++;
+    cmp.maxDistH = std::max(cmp.maxDistH, distH);
+    cmp.maxDistV = std::max(cmp.maxDistV, distV);
+    cmp.maxAngle = std::max(cmp.maxAngle, angle);
+}
+
+//
+// MARK: Recording
+//
+
+// Is recording active?
+bool LTTrajectoryIsActive ()
+{
+    return trj.bActive;
+}
+
+// Starts recording, loads golden trajectories if available
+void LTTrajectoryStart ()
+{
+    if (trj.bActive)
+        return;
+
+    // open the output file, start from scratch each time
+    const std::string sFileName (LTCalcFullPath(PATH_DEBUG_TRAJECTORY));
+    trj.out.open(sFileName, std::ios_base::out | std::ios_base::trunc);
+    if (!trj.out) {
+        char sErr[SERR_LEN];
+        strerror_s(sErr, sizeof(sErr), errno);
+        SHOW_MSG(logERR, DBG_RAW_FD_ERR_OPEN_OUT, sFileName.c_str(), sErr);
+        dataRefs.SetDebugLogTrajectory(false);
+        return;
+    }
+    trj.out << std::fixed;
+
+    // reset statistics and load golden trajectories
+    trj.mapGolden.clear();
+    trj.setKeys.clear();
+    trj.nPos = 0;
+    trj.cmp = TrjCmpTy();
+    trj.simStart = trj.simEnd = NAN;
+    trj.calcTime = std::chrono::steady_clock::duration(0);
+    const unsigned long nGolden =
+    LTTrajectoryRead(LTCalcFullPath(PATH_DEBUG_TRJ_GOLDEN), trj.mapGolden);
+
+    trj.wallStart = std::chrono::steady_clock::now();
+    trj.bActive = true;
+    SHOW_MSG(logWARN, DBG_TRJ_START, PATH_DEBUG_TRAJECTORY,
+             nGolden, trj.mapGolden.size(), PATH_DEBUG_TRJ_GOLDEN);
+}
+
+// Stops recording and logs a summary
+void LTTrajectoryStop ()
+{
+    if (!trj.bActive)
+        return;
+    trj.bActive = false;
+    trj.out.close();
+
+    // wall-clock time is measured in real time, even if the clock is virtual
+    using namespace std::chrono;
+    const double wallTime = duration_cast<duration<double>>(steady_clock::now() - trj.wallStart).count();
+    const double calcTime = duration_cast<duration<double>>(trj.calcTime).count();
+    SHOW_MSG(logWARN, DBG_TRJ_STOP,
+             trj.nPos, trj.setKeys.size(),
+             trj.nPos ? trj.simEnd - trj.simStart : 0.0,
+             wallTime, calcTime);
+    if (!trj.mapGolden.empty()) {
+        const logLevelTy lvl = trj.cmp.nDeviating ? logERR : logWARN;
+        SHOW_MSG(lvl, DBG_TRJ_GOLDEN,
+                 trj.cmp.nCompared, trj.cmp.nDeviating, trj.cmp.nUncovered,
+                 trj.cmp.maxDistH, trj.cmp.maxDistV, trj.cmp.maxAngle);
+    }
+    trj.mapGolden.clear();
+    trj.setKeys.clear();
+}
+
+// Records (and compares) an aircraft's current rendered position
+void LTTrajectoryRecord (const LTAircraft& ac, std::chrono::steady_clock::duration calcTime)
+{
+    if (!trj.bActive)
+        return;
+
+    const positionTy& ppos = ac.GetPPos();
+    TrjPosTy p;
+    p.ts        = ppos.ts();
+    p.lat       = ppos.lat();
+    p.lon       = ppos.lon();
+    p.alt       = ppos.alt_m();
+    p.heading   = ppos.heading();
+    p.pitch     = ppos.pitch();
+    p.roll      = ppos.roll();
+
+    trj.out
+    << ac.key()                 << ';'
+    << std::setprecision(3) << p.ts << ';'
+    << std::setprecision(7) << p.lat << ';' << p.lon << ';'
+    << std::setprecision(2) << p.alt << ';'
+    << p.heading << ';' << p.pitch << ';' << p.roll << ';'
+    << ac.IsOnGrnd()            << ';'
+    << ac.GetFlightPhaseString()
+    << '\n';
+
+    // statistics
+    trj.nPos++;
+    trj.setKeys.insert(ac.key());
+    trj.calcTime += calcTime;
+    if (std::isnan(trj.simStart) || p.ts < trj.simStart) trj.simStart = p.ts;
+    if (std::isnan(trj.simEnd)   || p.ts > trj.simEnd)   trj.simEnd   = p.ts;
+
+    if (!trj.mapGolden.empty())
+        LTTrajectoryCompare(trj.mapGolden, ac.key(), p, trj.cmp);
+}
@@ -5,6 +5,9 @@
 /// @details    SocketNetworking: Any network socket connection\n
 ///             UDPReceiver: listens to and receives UDP datagram\n
 ///             TCPConnection: receives incoming TCP connection\n
+///             TCPClient: connects to a TCP server and receives its data stream\n
+///             UDPMulticast: sends to and receives from a UDP multicast group\n
+///             NetEventLoop: one thread waiting on all sockets and timers, dispatching to handlers\n
 /// @author     Birger Hoppe
 /// @copyright  (c) 2019-2020 Birger Hoppe
 /// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
@@ -37,6 +40,9 @@ typedef USHORT in_port_t;
 #include <arpa/inet.h>
 #include <fcntl.h>
 #endif
+#if LIN == 1
+#include <sys/epoll.h>
+#endif
 
 //
 // MARK: SocketNetworking
@@ -362,6 +368,62 @@ void UDPReceiver::GetAddrHints (struct addrinfo& hints)
     hints.ai_protocol = IPPROTO_UDP;
 }
 
+//
+// MARK: UDPMulticast
+//
+
+// Joins a multicast group to receive its datagrams
+void UDPMulticast::JoinGroup (const std::string& _group)
+{
+    struct ip_mreq mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    if (inet_pton(AF_INET, _group.c_str(), &mreq.imr_multiaddr) != 1)
+        throw NetRuntimeError(("invalid multicast group: \"" + _group + "\"").c_str());
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (setsockopt(f_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, (char*)&mreq, sizeof(mreq)) < 0)
+        throw NetRuntimeError(("could not join multicast group: \"" + _group + "\"").c_str());
+}
+
+// Defines the multicast group to send to
+void UDPMulticast::SetSendGroup (const std::string& _group, int _port, int _ttl)
+{
+    f_groupAddr = _group + ':' + std::to_string(_port);
+    memset(&f_group, 0, sizeof(f_group));
+    f_group.sin_family = AF_INET;
+    f_group.sin_port = htons((in_port_t)_port);
+    if (inet_pton(AF_INET, _group.c_str(), &f_group.sin_addr) != 1)
+        throw NetRuntimeError(("invalid multicast group: \"" + _group + "\"").c_str());
+    
+    // Mac only accepts u_char for these options, Linux and Windows accept int
+#if APL == 1
+    u_char ttl = (u_char)_ttl, loop = 1;
+#else
+    int ttl = _ttl, loop = 1;
+#endif
+    if (setsockopt(f_socket, IPPROTO_IP, IP_MULTICAST_TTL, (char*)&ttl, sizeof(ttl)) < 0)
+        throw NetRuntimeError(("could not setsockopt IP_MULTICAST_TTL for: \"" + _group + "\"").c_str());
+    // also deliver to instances on this very computer
+    if (setsockopt(f_socket, IPPROTO_IP, IP_MULTICAST_LOOP, (char*)&loop, sizeof(loop)) < 0)
+        throw NetRuntimeError(("could not setsockopt IP_MULTICAST_LOOP for: \"" + _group + "\"").c_str());
+}
+
+// Sends one datagram to the group
+bool UDPMulticast::SendToGroup (const void* data, size_t len)
+{
+    for (;;) {
+        const long count = (long)::sendto(f_socket, (const char*)data, (int)len, 0,
+                                          (struct sockaddr *)&f_group, sizeof(f_group));
+        if (count >= 0)
+            return true;
+        if (errno != EINTR) {
+            LOG_MSG(logERR, "%s (%s)",
+                    ("sendto failed: \"" + f_groupAddr + "\"").c_str(),
+                    GetLastErr().c_str());
+            return false;
+        }
+    }
+}
+
 //
 // MARK: TCPConnection
 //
@@ -502,3 +564,480 @@ void TCPConnection::GetAddrHints (struct addrinfo& hints)
     hints.ai_protocol = IPPROTO_TCP;
 }
 
+//
+// MARK: TCPClient
+//
+
+// Connects to a TCP server, waiting at most _timeOut_ms
+void TCPClient::Connect (const std::string& _addr, int _port, unsigned _timeOut_ms)
+{
+    // connection still in progress? Then wait for it
+    if (!ConnectStart(_addr, _port)) {
+        fd_set sWrite;
+        FD_ZERO(&sWrite);
+        FD_SET(f_socket, &sWrite);
+        struct timeval timeout;
+        timeout.tv_sec = _timeOut_ms / 1000;
+        timeout.tv_usec = (_timeOut_ms % 1000) * 1000;
+        const int r = select((int)f_socket + 1, NULL, &sWrite, NULL, _timeOut_ms ? &timeout : NULL);
+        if (r == 0) {
+#if IBM
+            WSASetLastError(WSAETIMEDOUT);
+#else
+            errno = ETIMEDOUT;
+#endif
+        }
+        if (r <= 0) {
+            NetRuntimeError e(("could not connect to: \"" + f_addr + ":" + std::to_string(f_port) + "\"").c_str());
+            Close();
+            throw e;
+        }
+        
+        // check the outcome
+        ConnectComplete();
+    }
+}
+
+// Starts connecting in non-blocking mode
+bool TCPClient::ConnectStart (const std::string& _addr, int _port)
+{
+    struct addrinfo *   addrinfo      = NULL;
+    try {
+        // store member values
+        f_port = _port;
+        f_addr = _addr;
+        const std::string decimal_port(std::to_string(f_port));
+        
+        // get a valid address based on inAddr/port
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        GetAddrHints(hints);
+        
+        int r = getaddrinfo(f_addr.c_str(), decimal_port.c_str(), &hints, &addrinfo);
+        if(r != 0 || addrinfo == NULL)
+            throw NetRuntimeError(("invalid address or port for socket: \"" + f_addr + ":" + decimal_port + "\"").c_str());
+        
+        // get a socket
+        f_socket = socket(addrinfo->ai_family, addrinfo->ai_socktype, addrinfo->ai_protocol);
+        if(f_socket == INVALID_SOCKET)
+            throw NetRuntimeError(("could not create socket for: \"" + f_addr + ":" + decimal_port + "\"").c_str());
+        
+        // connect in non-blocking mode so the caller decides how long to wait
+#if IBM
+        u_long nonBlocking = 1;
+        ioctlsocket(f_socket, FIONBIO, &nonBlocking);
+#else
+        fcntl(f_socket, F_SETFL, fcntl(f_socket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+        r = connect(f_socket, addrinfo->ai_addr, (int)addrinfo->ai_addrlen);
+#if IBM
+        if (r != 0 && errno != WSAEWOULDBLOCK)
+#else
+        if (r != 0 && errno != EINPROGRESS)
+#endif
+            throw NetRuntimeError(("could not connect to: \"" + f_addr + ":" + decimal_port + "\"").c_str());
+        
+        // free adress info
+        freeaddrinfo(addrinfo);
+        addrinfo = NULL;
+        
+        // connected immediately? Then we are done already
+        if (r == 0) {
+            ConnectComplete();
+            return true;
+        }
+        return false;
+    }
+    catch (...) {
+        // free adress info
+        if (addrinfo) {
+            freeaddrinfo(addrinfo);
+            addrinfo = NULL;
+        }
+        // make sure everything is closed
+        Close();
+        // re-throw
+        throw;
+    }
+}
+
+// Checks the outcome of a non-blocking connect
+void TCPClient::ConnectComplete ()
+{
+    // 'writable' is also signaled in case of failure, so check the outcome
+    int sockErr = 0;
+    socklen_t errLen = sizeof(sockErr);
+    getsockopt(f_socket, SOL_SOCKET, SO_ERROR, (char*)&sockErr, &errLen);
+    if (sockErr) {
+#if IBM
+        WSASetLastError(sockErr);
+#else
+        errno = sockErr;
+#endif
+        NetRuntimeError e(("could not connect to: \"" + f_addr + ":" + std::to_string(f_port) + "\"").c_str());
+        Close();
+        throw e;
+    }
+    
+    // back to blocking mode
+#if IBM
+    u_long nonBlocking = 0;
+    ioctlsocket(f_socket, FIONBIO, &nonBlocking);
+#else
+    fcntl(f_socket, F_SETFL, fcntl(f_socket, F_GETFL, 0) & ~O_NONBLOCK);
+#endif
+}
+
+// Receives data into the caller's buffer, waits at most max_wait_ms
+long TCPClient::timedRecvInto (char* pBuf, size_t len, int max_wait_ms)
+{
+    fd_set sRead, sErr;
+    struct timeval timeout;
+    
+    FD_ZERO(&sRead);
+    FD_SET(f_socket, &sRead);           // check our socket
+    FD_ZERO(&sErr);                     // also for errors
+    FD_SET(f_socket, &sErr);
+    
+    timeout.tv_sec = max_wait_ms / 1000;
+    timeout.tv_usec = (max_wait_ms % 1000) * 1000;
+    int retval = select((int)f_socket + 1, &sRead, NULL, &sErr, &timeout);
+    if (retval < 0 || FD_ISSET(f_socket, &sErr))
+        return -1;
+    if (retval == 0 || !FD_ISSET(f_socket, &sRead))
+        return 0;                       // timeout
+    
+    // our socket has data, or the connection got closed (recv returns 0 then)
+    const long ret = ::recv(f_socket, pBuf, (int)len, 0);
+    return ret > 0 ? ret : -1;
+}
+
+// TCP only allows TCP, we connect actively
+void TCPClient::GetAddrHints (struct addrinfo& hints)
+{
+    hints.ai_flags = 0;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+}
+
+
+//
+// MARK: NetEventLoop
+//
+
+// Stops the thread and frees OS resources
+NetEventLoop::~NetEventLoop ()
+{
+    Stop();
+}
+
+// The one global event loop
+NetEventLoop& NetEventLoop::Get ()
+{
+    static NetEventLoop theLoop;
+    return theLoop;
+}
+
+// Registers a socket
+void NetEventLoop::AddSocket (SOCKET s, sockHandlerTy handler, bool bWrite)
+{
+    try {
+        std::lock_guard<std::recursive_mutex> lock (loopMutex);
+        Start();
+        const bool bExists = mapSock.count(s) > 0;
+        SockTy& sock = mapSock[s];
+        sock.handler = std::move(handler);
+        sock.bWrite = bWrite;
+#if LIN == 1
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = bWrite ? EPOLLOUT : EPOLLIN;
+        ev.data.fd = s;
+        epoll_ctl(epollFd, bExists ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, s, &ev);
+#else
+        (void)bExists;
+#endif
+        Wakeup();
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "loopMutex", e.what());
+    }
+}
+
+// Unregisters a socket
+void NetEventLoop::RemoveSocket (SOCKET s)
+{
+    try {
+        std::lock_guard<std::recursive_mutex> lock (loopMutex);
+        if (mapSock.erase(s) > 0) {
+#if LIN == 1
+            struct epoll_event ev;          // pre-2.6.9 kernels require non-NULL
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, s, &ev);
+#endif
+            Wakeup();
+        }
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "loopMutex", e.what());
+    }
+}
+
+// Registers a timer
+unsigned NetEventLoop::AddTimer (timePointTy due, timerHandlerTy handler)
+{
+    try {
+        std::lock_guard<std::recursive_mutex> lock (loopMutex);
+        Start();
+        const unsigned id = nextTimerId++;
+        mapTimer.emplace(id, TimerTy{due, std::move(handler)});
+        Wakeup();
+        return id;
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "loopMutex", e.what());
+    }
+    return 0;
+}
+
+// Unregisters a timer
+void NetEventLoop::RemoveTimer (unsigned id)
+{
+    try {
+        std::lock_guard<std::recursive_mutex> lock (loopMutex);
+        mapTimer.erase(id);
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "loopMutex", e.what());
+    }
+}
+
+// Stops the loop's thread
+void NetEventLoop::Stop ()
+{
+    // can't wait for myself
+    if (IsLoopThread())
+        return;
+    
+    if (thrLoop.joinable()) {
+        bStopLoop = true;
+        Wakeup();
+        thrLoop.join();
+        thrLoop = std::thread();
+    }
+    
+    // close OS resources, recreated with next start
+#if APL == 1 || LIN == 1
+    for (SOCKET &s: wakePipe) {
+        if (s != INVALID_SOCKET) close(s);
+        s = INVALID_SOCKET;
+    }
+#endif
+#if LIN == 1
+    if (epollFd >= 0) {
+        close(epollFd);
+        epollFd = -1;
+    }
+#endif
+}
+
+// Starts the thread if not yet running, `loopMutex` must be locked
+void NetEventLoop::Start ()
+{
+    if (thrLoop.joinable())
+        return;
+    
+    try {
+#if APL == 1 || LIN == 1
+        // the self-pipe to wake up the loop
+        if (pipe(wakePipe) < 0)
+            throw NetRuntimeError("Couldn't create pipe");
+        fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+        fcntl(wakePipe[1], F_SETFL, O_NONBLOCK);
+#endif
+#if LIN == 1
+        epollFd = epoll_create1(0);
+        if (epollFd < 0)
+            throw NetRuntimeError("Couldn't create epoll instance");
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = wakePipe[0];
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakePipe[0], &ev);
+        // sockets registered while the thread was stopped
+        for (const auto& p: mapSock) {
+            ev.events = p.second.bWrite ? EPOLLOUT : EPOLLIN;
+            ev.data.fd = p.first;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, p.first, &ev);
+        }
+#endif
+    }
+    catch (NetRuntimeError& e) {
+        LOG_MSG(logERR, "%s (%s)", e.what(), e.errTxt.c_str());
+        Stop();                         // closes what has been opened already
+        return;
+    }
+    
+    bStopLoop = false;
+    thrLoop = std::thread(LoopS, this);
+}
+
+// Wakes up the waiting loop
+void NetEventLoop::Wakeup ()
+{
+    // no need to wake myself up
+    if (IsLoopThread())
+        return;
+#if APL == 1 || LIN == 1
+    if (wakePipe[1] != INVALID_SOCKET &&
+        write(wakePipe[1], "W", 1) < 0)
+    {
+        // pipe full: loop will wake up anyway
+    }
+#endif
+}
+
+// Waits for registered sockets, fills `vecReady`
+void NetEventLoop::Wait (int timeout_ms)
+{
+    vecReady.clear();
+#if LIN == 1
+    struct epoll_event events[32];
+    const int n = epoll_wait(epollFd, events, (int)(sizeof(events)/sizeof(events[0])), timeout_ms);
+    if (n < 0) {
+        if (errno != EINTR) {
+            char sErr[SERR_LEN];
+            strerror_s(sErr, sizeof(sErr), errno);
+            LOG_MSG(logERR, ERR_NET_LOOP_WAIT, sErr);
+            std::this_thread::sleep_for(std::chrono::milliseconds(NET_LOOP_MAX_WAIT_MS));
+        }
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.fd == wakePipe[0]) {
+            // just drain the self-pipe
+            char buf[64];
+            while (read(wakePipe[0], buf, sizeof(buf)) > 0);
+        }
+        else
+            vecReady.push_back(events[i].data.fd);
+    }
+#else
+    // collect registered sockets
+    fd_set sRead, sWrite;
+    FD_ZERO(&sRead);
+    FD_ZERO(&sWrite);
+    SOCKET maxSock = 0;
+    bool bAnySock = false;
+    {
+        std::lock_guard<std::recursive_mutex> lock (loopMutex);
+        for (const auto& p: mapSock) {
+            FD_SET(p.first, p.second.bWrite ? &sWrite : &sRead);
+            maxSock = std::max(maxSock, p.first);
+            bAnySock = true;
+        }
+    }
+#if APL == 1
+    FD_SET(wakePipe[0], &sRead);
+    maxSock = std::max(maxSock, wakePipe[0]);
+    bAnySock = true;
+#else
+    // Windows: there is no self-pipe, so we need to re-check regularly
+    if (timeout_ms < 0 || timeout_ms > NET_LOOP_MAX_WAIT_MS)
+        timeout_ms = NET_LOOP_MAX_WAIT_MS;
+    // Windows' select fails if there are no sockets at all
+    if (!bAnySock) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+        return;
+    }
+#endif
+    struct timeval timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = (timeout_ms % 1000) * 1000;
+    const int n = select((int)maxSock + 1, &sRead, &sWrite, NULL,
+                         timeout_ms < 0 ? NULL : &timeout);
+    if (n < 0) {
+        char sErr[SERR_LEN];
+        strerror_s(sErr, sizeof(sErr), errno);
+        LOG_MSG(logERR, ERR_NET_LOOP_WAIT, sErr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(NET_LOOP_MAX_WAIT_MS));
+        return;
+    }
+#if APL == 1
+    if (FD_ISSET(wakePipe[0], &sRead)) {
+        // just drain the self-pipe
+        char buf[64];
+        while (read(wakePipe[0], buf, sizeof(buf)) > 0);
+    }
+#endif
+    if (n > 0) {
+        std::lock_guard<std::recursive_mutex> lock (loopMutex);
+        for (const auto& p: mapSock)
+            if (FD_ISSET(p.first, p.second.bWrite ? &sWrite : &sRead))
+                vecReady.push_back(p.first);
+    }
+#endif
+}
+
+// the thread's main function
+void NetEventLoop::Loop ()
+{
+    while (!bStopLoop)
+    {
+        try {
+            // how long can we wait? Until the next timer is due
+            int timeout_ms = -1;
+            {
+                std::lock_guard<std::recursive_mutex> lock (loopMutex);
+                if (!mapTimer.empty()) {
+                    timePointTy nextDue = timePointTy::max();
+                    for (const auto& p: mapTimer)
+                        nextDue = std::min(nextDue, p.second.due);
+                    const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>
+                    (nextDue - LTClock::now()).count();
+                    // round up so we don't wake up too early, just to wait again
+                    timeout_ms = wait < 0 ? 0 : int(wait + 1);
+                }
+            }
+            
+            // wait for sockets or timeout
+            Wait(LTClock::CapWaitMs(timeout_ms));
+            if (bStopLoop)
+                break;
+            
+            // call handlers, the lock makes Remove... wait for running handlers
+            std::lock_guard<std::recursive_mutex> lock (loopMutex);
+            for (SOCKET s: vecReady) {
+                // socket might have been removed in the meantime, even by a previous handler
+                auto iter = mapSock.find(s);
+                if (iter != mapSock.end()) {
+                    // copy, as the handler might change its own registration
+                    sockHandlerTy handler = iter->second.handler;
+                    handler();
+                }
+            }
+            
+            // call due timers
+            const timePointTy now = LTClock::now();
+            std::vector<unsigned> vecDue;
+            for (const auto& p: mapTimer)
+                if (p.second.due <= now)
+                    vecDue.push_back(p.first);
+            for (unsigned id: vecDue) {
+                auto iter = mapTimer.find(id);
+                if (iter == mapTimer.end())
+                    continue;
+                timerHandlerTy handler = iter->second.handler;
+                const timePointTy nextDue = handler();
+                // the timer might have removed itself
+                iter = mapTimer.find(id);
+                if (iter != mapTimer.end()) {
+                    if (nextDue == timePointTy())
+                        mapTimer.erase(iter);
+                    else
+                        iter->second.due = nextDue;
+                }
+            }
+        } catch (const std::exception& e) {
+            LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
+        } catch (...) {
+            LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, "?");
+        }
+    }
+}
@@ -29,6 +29,7 @@
 #include <forward_list>
 #include <algorithm>
 #include <cstring>
+#include <cstdarg>
 #include <iostream>
 
 #include "XPLMProcessing.h"
@@ -606,6 +607,58 @@ bool TFWidget::MsgDestroy (bool /*bRecursive*/)
     return true;
 }
 
+//
+// MARK: TFCachedWidget
+//
+
+// Sets the text, calls X-Plane only if the text changed
+void TFCachedWidget::SetText (const char* s)
+{
+    bNumValid = false;
+    if (!strncmp(szText, s, sizeof(szText)))
+        return;
+    strncpy(szText, s, sizeof(szText)-1);
+    szText[sizeof(szText)-1] = 0;
+    XPSetWidgetDescriptor(*this, s);
+}
+
+// Shows a number, formats and calls X-Plane only if the value changed at display precision
+void TFCachedWidget::SetNumber (double d, int decimals)
+{
+    char buf[50];
+    
+    // not a normal number? Can't compare numerically
+    if (!std::isfinite(d) || std::abs(d) > 1e12 || decimals < 0 || decimals > 6) {
+        snprintf(buf, sizeof(buf), "%.*f", decimals, d);
+        SetText(buf);
+        return;
+    }
+    
+    // compare at display precision
+    static const double POW10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    const long long num = std::llround(d * POW10[decimals]);
+    if (bNumValid && num == lastNum && decimals == lastDecimals)
+        return;
+    
+    // changed: format and display
+    snprintf(buf, sizeof(buf), "%.*f", decimals, d);
+    SetText(buf);
+    bNumValid = true;
+    lastNum = num;
+    lastDecimals = decimals;
+}
+
+// Formats like printf into a fixed buffer, calls X-Plane only if the text changed
+void TFCachedWidget::SetFormat (const char* fmt, ...)
+{
+    char buf[sizeof(szText)];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    SetText(buf);
+}
+
 //
 // MARK: TFButtonWidget
 //
@@ -0,0 +1,191 @@
+/// @file       LTBeastTest.cpp
+/// @brief      Replays a Mode-S test corpus through BeastConnection's static decoding functions
+/// @details    Each line of the corpus (see BeastCorpus.txt) names a function
+///             to test (CRC-24, CPR number of longitude zones, CPR global
+///             and local decoding), its input, and the expected result.\n
+///             Usage: `LTBeastTest <corpus file>`, returns 0 if all tests pass.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+#include <fstream>
+#include <sstream>
+
+/// [°] tolerated deviation of decoded from expected positions
+constexpr double BEAST_TEST_TOL_DEG = 0.00001;
+
+//
+// MARK: Helpers
+//
+
+/// Splits a corpus line at ';'
+static std::vector<std::string> SplitLine (const std::string& ln)
+{
+    std::vector<std::string> tok;
+    std::istringstream in (ln);
+    std::string s;
+    while (std::getline(in, s, ';'))
+        tok.push_back(s);
+    return tok;
+}
+
+/// Converts a Mode-S long frame from hex to binary, `false` if malformed
+static bool HexToFrame (const std::string& hex, uint8_t (&frame)[MODES_LONG_LEN])
+{
+    if (hex.size() != 2 * MODES_LONG_LEN)
+        return false;
+    for (size_t i = 0; i < MODES_LONG_LEN; ++i) {
+        char* pEnd = nullptr;
+        const std::string byte = hex.substr(2*i, 2);
+        frame[i] = uint8_t(std::strtoul(byte.c_str(), &pEnd, 16));
+        if (*pEnd)
+            return false;
+    }
+    return true;
+}
+
+/// Extracts the CPR encoded position of a frame
+static bool FrameToCpr (const std::string& hex, BeastConnection::CprTy& cpr, int& odd)
+{
+    uint8_t frame[MODES_LONG_LEN];
+    if (!HexToFrame(hex, frame))
+        return false;
+    odd = BeastConnection::CprFromME(frame + 4, cpr);
+    return true;
+}
+
+/// Is the decoded position as expected?
+static bool CheckPos (double lat, double lon, double expLat, double expLon)
+{
+    return std::abs(lat - expLat) <= BEAST_TEST_TOL_DEG &&
+           std::abs(HeadingDiff(expLon, lon)) <= BEAST_TEST_TOL_DEG;
+}
+
+//
+// MARK: Tests
+//
+
+/// Executes one test, returns `true` if passed, `sRes` receives the actual result
+static bool RunTest (const std::vector<std::string>& tok, std::string& sRes)
+{
+    char buf[100];
+    const std::string& type = tok[0];
+
+    // CRC;<frame>;<expected: 1 = ok, 0 = wrong>
+    if (type == "CRC" && tok.size() >= 3) {
+        uint8_t frame[MODES_LONG_LEN];
+        if (!HexToFrame(tok[1], frame))
+            return false;
+        const uint32_t parity = (uint32_t(frame[11]) << 16) | (uint32_t(frame[12]) << 8) | frame[13];
+        const uint32_t crc = BeastConnection::ModeSCrc(frame, MODES_LONG_LEN - 3);
+        snprintf(buf, sizeof(buf), "crc %06X, parity %06X", crc, parity);
+        sRes = buf;
+        return (crc == parity) == (std::stoi(tok[2]) != 0);
+    }
+
+    // NL;<latitude>;<expected>
+    if (type == "NL" && tok.size() >= 3) {
+        const int nl = BeastConnection::CprNL(std::stod(tok[1]));
+        sRes = std::to_string(nl);
+        return nl == std::stoi(tok[2]);
+    }
+
+    // GLOBAL;<even>;<odd>;<newer>;<ref lat>;<ref lon>;<exp lat>;<exp lon>
+    if (type == "GLOBAL" && tok.size() >= 8) {
+        BeastConnection::CprTy even, odd;
+        int fmtEven = -1, fmtOdd = -1;
+        if (!FrameToCpr(tok[1], even, fmtEven) || fmtEven != 0 ||
+            !FrameToCpr(tok[2], odd,  fmtOdd)  || fmtOdd  != 1)
+        {
+            sRes = "frames are not an even/odd pair";
+            return false;
+        }
+        double lat = NAN, lon = NAN;
+        if (!BeastConnection::CprGlobal(even, odd, std::stoi(tok[3]),
+                                        std::stod(tok[4]), std::stod(tok[5]),
+                                        lat, lon))
+        {
+            sRes = "not decodable";
+            return false;
+        }
+        snprintf(buf, sizeof(buf), "%.7f / %.7f", lat, lon);
+        sRes = buf;
+        return CheckPos(lat, lon, std::stod(tok[6]), std::stod(tok[7]));
+    }
+
+    // LOCAL;<frame>;<ref lat>;<ref lon>;<exp lat>;<exp lon>
+    if (type == "LOCAL" && tok.size() >= 6) {
+        BeastConnection::CprTy cpr;
+        int fmt = -1;
+        if (!FrameToCpr(tok[1], cpr, fmt))
+            return false;
+        double lat = NAN, lon = NAN;
+        BeastConnection::CprLocal(cpr, fmt, std::stod(tok[2]), std::stod(tok[3]), lat, lon);
+        snprintf(buf, sizeof(buf), "%.7f / %.7f", lat, lon);
+        sRes = buf;
+        return CheckPos(lat, lon, std::stod(tok[4]), std::stod(tok[5]));
+    }
+
+    sRes = "unknown test or missing fields";
+    return false;
+}
+
+//
+// MARK: Main
+//
+
+int main (int argc, char* argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <corpus file>\n", argv[0]);
+        return 2;
+    }
+    std::ifstream in (argv[1]);
+    if (!in) {
+        fprintf(stderr, "Could not open %s\n", argv[1]);
+        return 2;
+    }
+
+    int nTests = 0, nFailed = 0, lnNr = 0;
+    std::string ln;
+    while (std::getline(in, ln)) {
+        ++lnNr;
+        if (!ln.empty() && ln.back() == '\r')
+            ln.pop_back();
+        if (ln.empty() || ln[0] == '#')
+            continue;
+
+        const std::vector<std::string> tok = SplitLine(ln);
+        std::string sRes;
+        bool bOK = false;
+        try {
+            bOK = RunTest(tok, sRes);
+        } catch (const std::exception& e) {
+            sRes = e.what();
+        }
+        ++nTests;
+        if (!bOK) {
+            ++nFailed;
+            printf("FAILED line %d: %s\n    result: %s\n", lnNr, ln.c_str(), sRes.c_str());
+        }
+    }
+
+    printf("%d tests, %d failed\n", nTests, nFailed);
+    return (nTests > 0 && nFailed == 0) ? 0 : 1;
+}
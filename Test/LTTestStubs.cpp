@@ -0,0 +1,150 @@
+/// @file       LTTestStubs.cpp
+/// @brief      Minimal stand-ins for X-Plane and plugin functions, so that
+///             selected LiveTraffic modules link into stand-alone test programs
+/// @details    The local coordinate system is a plain equirectangular projection
+///             around 0°/0°, terrain is flat at sea level. Log messages go
+///             to `stderr`. Good enough for testing and benchmarking
+///             calculations, not for anything visual.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+#include <cstdarg>
+
+//
+// MARK: XPLM
+//
+
+/// [m] per degree in the stubbed local coordinate system
+constexpr double STUB_M_per_DEG = 111319.49;
+
+XPLMProbeRef XPLMCreateProbe (XPLMProbeType)
+{
+    static int probe = 0;
+    return &probe;
+}
+
+XPLMProbeResult XPLMProbeTerrainXYZ (XPLMProbeRef, float inX, float, float inZ,
+                                     XPLMProbeInfo_t* outInfo)
+{
+    outInfo->locationX = inX;
+    outInfo->locationY = 0.0f;              // flat terrain at sea level
+    outInfo->locationZ = inZ;
+    outInfo->normalX = 0.0f;
+    outInfo->normalY = 1.0f;
+    outInfo->normalZ = 0.0f;
+    outInfo->velocityX = outInfo->velocityY = outInfo->velocityZ = 0.0f;
+    outInfo->is_wet = 0;
+    return xplm_ProbeHitTerrain;
+}
+
+void XPLMWorldToLocal (double inLatitude, double inLongitude, double inAltitude,
+                       double* outX, double* outY, double* outZ)
+{
+    *outX = inLongitude * STUB_M_per_DEG;
+    *outY = inAltitude;
+    *outZ = -inLatitude * STUB_M_per_DEG;
+}
+
+void XPLMLocalToWorld (double inX, double inY, double inZ,
+                       double* outLatitude, double* outLongitude, double* outAltitude)
+{
+    *outLatitude = -inZ / STUB_M_per_DEG;
+    *outLongitude = inX / STUB_M_per_DEG;
+    *outAltitude = inY;
+}
+
+//
+// MARK: LiveTraffic
+//
+
+// the global dataRefs object, only its log level is used
+DataRefs dataRefs(logWARN);
+
+DataRefs::DataRefs (logLevelTy initLogLevel) :
+iLogLevel (initLogLevel)
+{}
+
+void LogMsg (const char* szPath, int ln, const char* szFunc, logLevelTy lvl, const char* szMsg, ...)
+{
+    va_list args;
+    va_start (args, szMsg);
+    fprintf(stderr, "%s:%d/%s %d: ", szPath, ln, szFunc, int(lvl));
+    vfprintf(stderr, szMsg, args);
+    fputc('\n', stderr);
+    va_end (args);
+}
+
+LTError::LTError (const char* _szFile, int _ln, const char* _szFunc,
+                  logLevelTy _lvl, const char* _szMsg, ...) :
+std::logic_error(_szMsg),
+fileName(_szFile), ln(_ln), funcName(_szFunc), lvl(_lvl), msg(_szMsg)
+{}
+
+XPLMWindowID CreateMsgWindow (float, logLevelTy lvl, const char* szMsg, ...)
+{
+    va_list args;
+    va_start (args, szMsg);
+    fprintf(stderr, "MSG %d: ", int(lvl));
+    vfprintf(stderr, szMsg, args);
+    fputc('\n', stderr);
+    va_end (args);
+    return nullptr;
+}
+
+const char* LTError::what() const noexcept
+{
+    return msg.c_str();
+}
+
+// paths are taken as given, relative to the working directory
+std::string LTCalcFullPath (const std::string path)
+{
+    return path;
+}
+
+// same as in LTMain.cpp, which doesn't link stand-alone
+std::vector<std::string> str_tokenize (const std::string s,
+                                       const std::string tokens,
+                                       bool bSkipEmpty)
+{
+    std::vector<std::string> v;
+    size_t b = 0;
+    for (size_t e = s.find_first_of(tokens);
+         e != std::string::npos;
+         b = e+1, e = s.find_first_of(tokens, b))
+    {
+        if (!bSkipEmpty || e != b)
+            v.emplace_back(s.substr(b, e-b));
+    }
+    v.emplace_back(s.substr(b));
+    return v;
+}
+
+bool dequal (const double d1, const double d2)
+{
+    const double epsilon = 0.00001;
+    return ((d1 - epsilon) < d2) &&
+    ((d1 + epsilon) > d2);
+}
+
+std::string LTAircraft::FlightPhase2String (FlightPhase phase)
+{
+    return std::to_string(int(phase));
+}
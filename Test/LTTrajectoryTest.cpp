@@ -0,0 +1,73 @@
+/// @file       LTTrajectoryTest.cpp
+/// @brief      Replays a recorded trajectory against a golden one
+/// @details    Both files are in the format of LTTrajectory.log. Each recorded
+///             position is compared with the golden trajectory of the same
+///             aircraft, interpolated at the same timestamp, by the same
+///             function the plugin uses while recording (LTTrajectoryCompare),
+///             so a recording taken in X-Plane can be checked here, too.\n
+///             Usage: `LTTrajectoryTest <golden file> <recorded file>`,
+///             returns 0 if all recorded positions are covered by the golden
+///             trajectories and within tolerance.
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+//
+// MARK: Main
+//
+
+int main (int argc, char* argv[])
+{
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <golden file> <recorded file>\n", argv[0]);
+        return 2;
+    }
+    
+    mapTrjTy golden, recorded;
+    const unsigned long nGolden = LTTrajectoryRead(argv[1], golden);
+    if (!nGolden) {
+        fprintf(stderr, "No positions read from %s\n", argv[1]);
+        return 2;
+    }
+    const unsigned long nRecorded = LTTrajectoryRead(argv[2], recorded);
+    if (!nRecorded) {
+        fprintf(stderr, "No positions read from %s\n", argv[2]);
+        return 2;
+    }
+    
+    // replay all recorded positions, aircraft by aircraft
+    TrjCmpTy cmp;
+    for (const mapTrjTy::value_type& t: recorded) {
+        const unsigned long nDevBefore = cmp.nDeviating;
+        const unsigned long nUncBefore = cmp.nUncovered;
+        for (const TrjPosTy& p: t.second)
+            LTTrajectoryCompare(golden, t.first, p, cmp);
+        if (cmp.nDeviating > nDevBefore || cmp.nUncovered > nUncBefore)
+            printf("%s: %lu positions deviating, %lu not covered by golden trajectory\n",
+                   t.first.c_str(),
+                   cmp.nDeviating - nDevBefore, cmp.nUncovered - nUncBefore);
+    }
+    
+    printf("%lu golden and %lu recorded positions: %lu compared, %lu deviating, %lu not covered\n"
+           "max deviation %.2fm horizontally, %.2fm vertically, %.2f° in heading/pitch/roll\n",
+           nGolden, nRecorded,
+           cmp.nCompared, cmp.nDeviating, cmp.nUncovered,
+           cmp.maxDistH, cmp.maxDistV, cmp.maxAngle);
+    return (cmp.nCompared > 0 && cmp.nDeviating == 0 && cmp.nUncovered == 0) ? 0 : 1;
+}
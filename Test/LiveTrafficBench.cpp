@@ -0,0 +1,235 @@
+/// @file       LiveTrafficBench.cpp
+/// @brief      Benchmark of the CoordCalc kernels used in the position pipeline
+/// @details    Each kernel runs in a `<chrono>`-timed loop over pre-generated,
+///             reproducible (fixed seed) random input. Results are printed
+///             and written as JSON, so that runs before and after a change
+///             can be compared.\n
+///             Usage: `LiveTrafficBench [output.json [scale]]`, `scale` multiplies the
+///             number of iterations (default 1.0, small values for a quick check).
+/// @author     Birger Hoppe
+/// @copyright  (c) 2020 Birger Hoppe
+/// @copyright  Permission is hereby granted, free of charge, to any person obtaining a
+///             copy of this software and associated documentation files (the "Software"),
+///             to deal in the Software without restriction, including without limitation
+///             the rights to use, copy, modify, merge, publish, distribute, sublicense,
+///             and/or sell copies of the Software, and to permit persons to whom the
+///             Software is furnished to do so, subject to the following conditions:\n
+///             The above copyright notice and this permission notice shall be included in
+///             all copies or substantial portions of the Software.\n
+///             THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///             IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///             FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///             AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///             LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///             OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+///             THE SOFTWARE.
+
+#include "LiveTraffic.h"
+
+#include <fstream>
+#include <iomanip>
+#include <random>
+
+//
+// MARK: Benchmark harness
+//
+
+/// Number of different inputs per kernel, cycled through by the loops
+constexpr size_t BENCH_NUM_INPUT = 1024;
+
+/// Result of one kernel's benchmark
+struct BenchResTy {
+    std::string name;               ///< kernel's name
+    unsigned long n = 0;            ///< number of calls
+    double total_ms = 0.0;          ///< [ms] total time
+    double ns_per_op = 0.0;         ///< [ns] per call
+};
+
+/// All results, in order of execution
+static std::vector<BenchResTy> vecRes;
+
+/// Accumulates results, so that the compiler cannot drop the calls
+static volatile double benchSink = 0.0;
+
+/// Runs `f(i)` `n` times after a short warm-up and records the time taken
+template <class FuncT>
+void Bench (const char* name, unsigned long n, FuncT f)
+{
+    double sink = 0.0;
+    for (size_t i = 0; i < BENCH_NUM_INPUT; ++i)
+        sink += f(i);
+
+    const std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < n; ++i)
+        sink += f(i % BENCH_NUM_INPUT);
+    const std::chrono::steady_clock::time_point tEnd = std::chrono::steady_clock::now();
+    benchSink = benchSink + sink;
+
+    BenchResTy& res = vecRes.emplace_back();
+    res.name = name;
+    res.n = n;
+    res.total_ms = std::chrono::duration<double, std::milli>(tEnd - tStart).count();
+    res.ns_per_op = n ? res.total_ms * 1000000.0 / double(n) : 0.0;
+    printf("%-36s %10lu calls %10.2f ms %10.2f ns/call\n",
+           name, n, res.total_ms, res.ns_per_op);
+}
+
+/// Writes all results as JSON
+static bool WriteJSON (const std::string& sFileName)
+{
+    std::ofstream out (sFileName, std::ios_base::out | std::ios_base::trunc);
+    if (!out)
+        return false;
+    out << std::fixed << std::setprecision(3)
+        << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < vecRes.size(); ++i) {
+        const BenchResTy& res = vecRes[i];
+        out << "    { \"name\": \"" << res.name
+            << "\", \"calls\": " << res.n
+            << ", \"total_ms\": " << res.total_ms
+            << ", \"ns_per_call\": " << res.ns_per_op
+            << " }" << (i+1 < vecRes.size() ? "," : "") << '\n';
+    }
+    out << "  ]\n}\n";
+    return bool(out);
+}
+
+//
+// MARK: Input data
+//
+
+/// Random positions around a center, the way aircraft are distributed around the camera
+static std::vector<positionTy> GenPositions (std::mt19937& rnd, double lat, double lon, double radius_deg)
+{
+    std::uniform_real_distribution<double> dDeg (-radius_deg, radius_deg);
+    std::uniform_real_distribution<double> dAlt (0.0, 12000.0);
+    std::uniform_real_distribution<double> dHead (0.0, 360.0);
+    std::vector<positionTy> vec;
+    vec.reserve(BENCH_NUM_INPUT);
+    for (size_t i = 0; i < BENCH_NUM_INPUT; ++i)
+        vec.emplace_back(lat + dDeg(rnd), lon + dDeg(rnd), dAlt(rnd),
+                         double(i), dHead(rnd), 0.0, 0.0);
+    return vec;
+}
+
+/// A position deque like an aircraft's: positions every `intvl` seconds
+static dequePositionTy GenPosDeque (size_t num, double intvl)
+{
+    dequePositionTy deq;
+    for (size_t i = 0; i < num; ++i)
+        deq.emplace_back(51.0 + double(i) * 0.001, 7.0, 1000.0,
+                         double(i) * intvl, 0.0, 0.0, 0.0);
+    return deq;
+}
+
+//
+// MARK: Kernels
+//
+
+/// Kernels of CoordCalc
+static void BenchCoordCalc (double scale)
+{
+    const unsigned long n = (unsigned long)(1000000.0 * scale) + 1;
+    std::mt19937 rnd (4711);
+    const std::vector<positionTy> vecA = GenPositions(rnd, 51.0, 7.0, 1.5);
+    const std::vector<positionTy> vecB = GenPositions(rnd, 51.0, 7.0, 1.5);
+    std::uniform_real_distribution<double> dHead (0.0, 360.0);
+    std::uniform_real_distribution<double> dDist (10.0, 50000.0);
+    std::vector<double> vecH1, vecH2, vecDist;
+    for (size_t i = 0; i < BENCH_NUM_INPUT; ++i) {
+        vecH1.push_back(dHead(rnd));
+        vecH2.push_back(dHead(rnd));
+        vecDist.push_back(dDist(rnd));
+    }
+
+    Bench("CoordDistance", n, [&](size_t i)
+          { return CoordDistance(vecA[i].lat(), vecA[i].lon(), vecB[i].lat(), vecB[i].lon()); });
+    Bench("CoordAngle", n, [&](size_t i)
+          { return CoordAngle(vecA[i].lat(), vecA[i].lon(), vecB[i].lat(), vecB[i].lon()); });
+    Bench("CoordPlusVector", n, [&](size_t i)
+          { return CoordPlusVector(vecA[i], vectorTy(vecH1[i], vecDist[i])).lat(); });
+    Bench("DistPointToLineSqr", n, [&](size_t i)
+    {
+        const size_t j = (i + 1) % BENCH_NUM_INPUT;
+        distToLineTy res;
+        DistPointToLineSqr(vecA[i].lon(), vecA[i].lat(),
+                           vecB[i].lon(), vecB[i].lat(),
+                           vecB[j].lon(), vecB[j].lat(), res);
+        return res.dist2;
+    });
+    Bench("HeadingAvg", n, [&](size_t i)
+          { return HeadingAvg(vecH1[i], vecH2[i], 1.0, 2.0); });
+    Bench("HeadingDiff", n, [&](size_t i)
+          { return HeadingDiff(vecH1[i], vecH2[i]); });
+}
+
+/// Bounding box operations, as used for filtering by distance
+static void BenchBoundingBox (double scale)
+{
+    const unsigned long n = (unsigned long)(1000000.0 * scale) + 1;
+    std::mt19937 rnd (815);
+    const std::vector<positionTy> vecPos = GenPositions(rnd, 51.0, 7.0, 2.0);
+    std::vector<boundingBoxTy> vecBox;
+    for (const positionTy& pos: vecPos)
+        vecBox.emplace_back(pos, 50000.0);
+    const boundingBoxTy box (positionTy(51.0, 7.0), 100000.0);
+
+    Bench("boundingBoxTy::contains", n, [&](size_t i)
+          { return box.contains(vecPos[i]) ? 1.0 : 0.0; });
+    Bench("boundingBoxTy::overlap", n, [&](size_t i)
+          { return box.overlap(vecBox[i]) ? 1.0 : 0.0; });
+}
+
+/// Position merging and searching in position deques
+static void BenchPositions (double scale)
+{
+    const unsigned long n = (unsigned long)(1000000.0 * scale) + 1;
+    std::mt19937 rnd (42);
+    const std::vector<positionTy> vecA = GenPositions(rnd, 51.0, 7.0, 0.01);
+    const std::vector<positionTy> vecB = GenPositions(rnd, 51.0, 7.0, 0.01);
+
+    Bench("positionTy::operator|=", n, [&](size_t i)
+    {
+        positionTy pos = vecA[i];
+        pos |= vecB[i];
+        return pos.lat();
+    });
+
+    // a typical deque of an aircraft (positions every 10s)
+    dequePositionTy deq = GenPosDeque(20, 10.0);
+    std::uniform_real_distribution<double> dTs (0.0, deq.back().ts());
+    std::vector<double> vecTs;
+    for (size_t i = 0; i < BENCH_NUM_INPUT; ++i)
+        vecTs.push_back(dTs(rnd));
+    Bench("positionDequeFindAdjacentTS", n, [&](size_t i)
+    {
+        positionTy *pBefore = nullptr, *pAfter = nullptr;
+        positionDequeFindAdjacentTS(vecTs[i], deq, pBefore, pAfter);
+        return pBefore ? pBefore->ts() : 0.0;
+    });
+}
+
+//
+// MARK: Main
+//
+
+int main (int argc, char* argv[])
+{
+    const std::string sFileName = argc > 1 ? argv[1] : "LiveTrafficBench.json";
+    const double scale = argc > 2 ? std::atof(argv[2]) : 1.0;
+    if (!(scale > 0.0)) {
+        fprintf(stderr, "Usage: %s [output.json [scale > 0]]\n", argv[0]);
+        return 2;
+    }
+
+    BenchCoordCalc(scale);
+    BenchBoundingBox(scale);
+    BenchPositions(scale);
+
+    if (!WriteJSON(sFileName)) {
+        fprintf(stderr, "Could not write %s\n", sFileName.c_str());
+        return 1;
+    }
+    printf("Results written to %s\n", sFileName.c_str());
+    return 0;
+}